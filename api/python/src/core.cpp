@@ -49,8 +49,26 @@ void init_core(py::module_ &m_core) {
         .def("get_num_objects", &RoleDenotation::get_num_objects)
     ;
 
+    py::class_<ElementStatistics>(m_core, "ElementStatistics")
+        .def_readonly("num_hits", &ElementStatistics::num_hits)
+        .def_readonly("num_misses", &ElementStatistics::num_misses)
+        .def_property_readonly("evaluate_time", [](const ElementStatistics& self){ return std::chrono::duration<double>(self.evaluate_time).count(); })
+        .def_readonly("num_bytes", &ElementStatistics::num_bytes)
+    ;
+
     py::class_<DenotationsCaches, std::shared_ptr<DenotationsCaches>>(m_core, "DenotationsCaches")
         .def(py::init<>())
+        .def(py::init<bool>())
+        .def("set_memory_budget", &DenotationsCaches::set_memory_budget, py::arg("num_bytes"), py::arg("evict_collections") = false)
+        .def("get_memory_budget", &DenotationsCaches::get_memory_budget)
+        .def("set_num_threads", &DenotationsCaches::set_num_threads)
+        .def("get_num_threads", &DenotationsCaches::get_num_threads)
+        .def("get_num_bytes", &DenotationsCaches::get_num_bytes)
+        .def("get_num_evictions", &DenotationsCaches::get_num_evictions)
+        .def("get_num_evicted_entries", &DenotationsCaches::get_num_evicted_entries)
+        .def_static("is_instrumentation_enabled", &DenotationsCaches::is_instrumentation_enabled)
+        .def("get_element_statistics", &DenotationsCaches::get_element_statistics)
+        .def("clear_element_statistics", &DenotationsCaches::clear_element_statistics)
     ;
 
     py::class_<Constant>(m_core, "Constant")
@@ -142,9 +160,16 @@ void init_core(py::module_ &m_core) {
         .def("get_vocabulary_info", &Concept::get_vocabulary_info)
         .def("evaluate", py::overload_cast<const State&>(&Concept::evaluate, py::const_))
         .def("evaluate", py::overload_cast<const State&, DenotationsCaches&>(&Concept::evaluate, py::const_))
+        .def("evaluate_delta", &Concept::evaluate_delta)
         .def("evaluate", [](const Concept& self, const States& states, DenotationsCaches& caches) {
-            // std::shared_ptr<const std::vector<std::shared_ptr<const ConcepDenotation>>> is not registered so we must dereference to obtain a registered type
-            return *self.evaluate(states, caches);
+            // ConceptDenotations is not registered so we convert it row by row to a registered type
+            auto denotations = self.evaluate(states, caches);
+            std::vector<ConceptDenotation> result;
+            result.reserve(denotations->size());
+            for (std::size_t i = 0; i < denotations->size(); ++i) {
+                result.push_back(denotations->get_denotation(i));
+            }
+            return result;
         })
     ;
 
@@ -155,9 +180,16 @@ void init_core(py::module_ &m_core) {
         .def("get_vocabulary_info", &Role::get_vocabulary_info)
         .def("evaluate", py::overload_cast<const State&>(&Role::evaluate, py::const_))
         .def("evaluate", py::overload_cast<const State&, DenotationsCaches&>(&Role::evaluate, py::const_))
+        .def("evaluate_delta", &Role::evaluate_delta)
         .def("evaluate", [](const Role& self, const States& states, DenotationsCaches& caches) {
-            // std::shared_ptr<const std::vector<std::shared_ptr<const RoleDenotation>>> is not registered so we must dereference to obtain a registered type
-            return *self.evaluate(states, caches);
+            // RoleDenotations is not registered so we convert it row by row to a registered type
+            auto denotations = self.evaluate(states, caches);
+            std::vector<RoleDenotation> result;
+            result.reserve(denotations->size());
+            for (std::size_t i = 0; i < denotations->size(); ++i) {
+                result.push_back(denotations->get_denotation(i));
+            }
+            return result;
         })
     ;
 
@@ -168,6 +200,7 @@ void init_core(py::module_ &m_core) {
         .def("get_vocabulary_info", &Numerical::get_vocabulary_info)
         .def("evaluate", py::overload_cast<const State&>(&Numerical::evaluate, py::const_))
         .def("evaluate", py::overload_cast<const State&, DenotationsCaches&>(&Numerical::evaluate, py::const_))
+        .def("evaluate_delta", &Numerical::evaluate_delta)
         .def("evaluate", [](const Numerical& self, const States& states, DenotationsCaches& caches) {
             // std::shared_ptr<const std::vector<std::shared_ptr<const NumericalDenotation>>> is not registered so we must dereference to obtain a registered type
             return *self.evaluate(states, caches);
@@ -181,12 +214,30 @@ void init_core(py::module_ &m_core) {
         .def("get_vocabulary_info", &Boolean::get_vocabulary_info)
         .def("evaluate", py::overload_cast<const State&>(&Boolean::evaluate, py::const_))
         .def("evaluate", py::overload_cast<const State&, DenotationsCaches&>(&Boolean::evaluate, py::const_))
+        .def("evaluate_delta", &Boolean::evaluate_delta)
         .def("evaluate", [](const Boolean& self, const States& states, DenotationsCaches& caches) {
             // std::shared_ptr<const std::vector<std::shared_ptr<const BooleanDenotation>>> is not registered so we must dereference to obtain a registered type
             return *self.evaluate(states, caches);
         })
     ;
 
+    py::class_<EvaluationPlan, std::shared_ptr<EvaluationPlan>>(m_core, "EvaluationPlan")
+        .def(py::init<const std::vector<std::shared_ptr<const Boolean>>&, const std::vector<std::shared_ptr<const Numerical>>&, const std::vector<std::shared_ptr<const Concept>>&, const std::vector<std::shared_ptr<const Role>>&>(),
+            py::arg("booleans"), py::arg("numericals"), py::arg("concepts"), py::arg("roles") = std::vector<std::shared_ptr<const Role>>())
+        .def("get_num_instructions", &EvaluationPlan::get_num_instructions)
+        .def("get_num_static_instructions", &EvaluationPlan::get_num_static_instructions)
+    ;
+
+    py::class_<EvaluationFrame, std::shared_ptr<EvaluationFrame>>(m_core, "EvaluationFrame")
+        .def(py::init<std::shared_ptr<const EvaluationPlan>>())
+        .def("evaluate", &EvaluationFrame::evaluate)
+        .def("get_denotation", py::overload_cast<const Boolean&>(&EvaluationFrame::get_denotation, py::const_))
+        .def("get_denotation", py::overload_cast<const Numerical&>(&EvaluationFrame::get_denotation, py::const_))
+        .def("get_denotation", py::overload_cast<const Concept&>(&EvaluationFrame::get_denotation, py::const_))
+        .def("get_denotation", py::overload_cast<const Role&>(&EvaluationFrame::get_denotation, py::const_))
+        .def("get_plan", &EvaluationFrame::get_plan)
+    ;
+
     py::class_<SyntacticElementFactory, std::shared_ptr<SyntacticElementFactory>>(m_core, "SyntacticElementFactory")
         .def(py::init<std::shared_ptr<VocabularyInfo>>())
 
@@ -1,4 +1,4 @@
-from typing import Overload, List, Tuple
+from typing import Overload, Dict, List, Tuple
 
 
 class ConceptDenotation:
@@ -37,8 +37,33 @@ class RoleDenotation:
     def get_num_objects(self) -> int: ...
 
 
+class ElementStatistics:
+    @property
+    def num_hits(self) -> int: ...
+    @property
+    def num_misses(self) -> int: ...
+    @property
+    def evaluate_time(self) -> float: ...
+    @property
+    def num_bytes(self) -> int: ...
+
+
 class DenotationsCaches:
+    @overload
     def __init__(self) -> None: ...
+    @overload
+    def __init__(self, thread_safe: bool) -> None: ...
+    def set_memory_budget(self, num_bytes: int, evict_collections: bool = False) -> None: ...
+    def get_memory_budget(self) -> int: ...
+    def set_num_threads(self, num_threads: int) -> None: ...
+    def get_num_threads(self) -> int: ...
+    def get_num_bytes(self) -> int: ...
+    def get_num_evictions(self) -> int: ...
+    def get_num_evicted_entries(self) -> int: ...
+    @staticmethod
+    def is_instrumentation_enabled() -> bool: ...
+    def get_element_statistics(self) -> Dict[int, ElementStatistics]: ...
+    def clear_element_statistics(self) -> None: ...
 
 
 class Constant:
@@ -141,6 +166,7 @@ class Concept():
     def evaluate(self, state: State, denotations_caches: DenotationsCaches) -> ConceptDenotation: ...
     @overload
     def evaluate(self, states: List[State], denotations_caches: DenotationsCaches) -> List[ConceptDenotation]: ...
+    def evaluate_delta(self, state: State, parent_state: State, added_atoms: List[int], deleted_atoms: List[int], denotations_caches: DenotationsCaches) -> ConceptDenotation: ...
 
 
 class Role():
@@ -154,6 +180,7 @@ class Role():
     def evaluate(self, state: State, denotations_caches: DenotationsCaches) -> RoleDenotation: ...
     @overload
     def evaluate(self, states: List[State], denotations_caches: DenotationsCaches) -> List[RoleDenotation]: ...
+    def evaluate_delta(self, state: State, parent_state: State, added_atoms: List[int], deleted_atoms: List[int], denotations_caches: DenotationsCaches) -> RoleDenotation: ...
 
 
 class Boolean():
@@ -167,6 +194,7 @@ class Boolean():
     def evaluate(self, state: State, denotations_caches: DenotationsCaches) -> bool: ...
     @overload
     def evaluate(self, states: List[State], denotations_caches: DenotationsCaches) -> List[bool]: ...
+    def evaluate_delta(self, state: State, parent_state: State, added_atoms: List[int], deleted_atoms: List[int], denotations_caches: DenotationsCaches) -> bool: ...
 
 
 class Numerical():
@@ -180,6 +208,27 @@ class Numerical():
     def evaluate(self, state: State, denotations_caches: DenotationsCaches) -> int: ...
     @overload
     def evaluate(self, states: List[State], denotations_caches: DenotationsCaches) -> List[int]: ...
+    def evaluate_delta(self, state: State, parent_state: State, added_atoms: List[int], deleted_atoms: List[int], denotations_caches: DenotationsCaches) -> int: ...
+
+
+class EvaluationPlan:
+    def __init__(self, booleans: List[Boolean], numericals: List[Numerical], concepts: List[Concept], roles: List[Role] = []) -> None: ...
+    def get_num_instructions(self) -> int: ...
+    def get_num_static_instructions(self) -> int: ...
+
+
+class EvaluationFrame:
+    def __init__(self, plan: EvaluationPlan) -> None: ...
+    def evaluate(self, state: State) -> None: ...
+    @overload
+    def get_denotation(self, boolean: Boolean) -> bool: ...
+    @overload
+    def get_denotation(self, numerical: Numerical) -> int: ...
+    @overload
+    def get_denotation(self, concept: Concept) -> ConceptDenotation: ...
+    @overload
+    def get_denotation(self, role: Role) -> RoleDenotation: ...
+    def get_plan(self) -> EvaluationPlan: ...
 
 
 class SyntacticElementFactory:
@@ -1 +1 @@
-from _dlplan import FeatureGenerator, generate_features
\ No newline at end of file
+from _dlplan import CancellationToken, FeatureGenerator, generate_features
\ No newline at end of file
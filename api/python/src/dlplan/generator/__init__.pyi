@@ -1,6 +1,13 @@
-from typing import List
+from typing import Callable, List
 
-from ..core import SyntacticElementFactory, State
+from ..core import Boolean, Concept, ConceptDenotation, Numerical, Role, RoleDenotation, SyntacticElementFactory, State
+
+
+class CancellationToken:
+    def __init__(self) -> None: ...
+    def cancel(self) -> None: ...
+    def is_cancelled(self) -> bool: ...
+    def reset(self) -> None: ...
 
 
 class FeatureGenerator:
@@ -14,6 +21,29 @@ class FeatureGenerator:
         distance_numerical_complexity_limit: int = 9,
         time_limit: int = 3600,
         feature_limit: int = 10000) -> List[str]: ...
+    def resume(self, 
+        factory: SyntacticElementFactory, 
+        states: List[State],
+        concept_complexity_limit: int = 9,
+        role_complexity_limit: int = 9,
+        boolean_complexity_limit: int = 9,
+        count_numerical_complexity_limit: int = 9,
+        distance_numerical_complexity_limit: int = 9,
+        time_limit: int = 3600,
+        feature_limit: int = 10000) -> List[str]: ...
+    def extend(self, states: List[State]) -> List[str]: ...
+    def set_num_threads(self, num_threads: int) -> None: ...
+    def set_use_fingerprints(self, enable: bool) -> None: ...
+    def set_num_probe_states(self, num_probe_states: int) -> None: ...
+    def set_incremental(self, enable: bool) -> None: ...
+    def set_cancellation_token(self, token: CancellationToken) -> None: ...
+    def set_memory_limit(self, num_bytes: int) -> None: ...
+    def get_peak_num_bytes(self) -> int: ...
+    def set_checkpoint_file(self, filename: str) -> None: ...
+    def set_boolean_callback(self, callback: Callable[[Boolean, List[bool], int], bool]) -> None: ...
+    def set_numerical_callback(self, callback: Callable[[Numerical, List[int], int], bool]) -> None: ...
+    def set_concept_callback(self, callback: Callable[[Concept, List[ConceptDenotation], int], bool]) -> None: ...
+    def set_role_callback(self, callback: Callable[[Role, List[RoleDenotation], int], bool]) -> None: ...
     def set_generate_empty_boolean(self, enable: bool) -> None: ...
     def set_generate_inclusion_boolean(self, enable: bool) -> None: ...
     def set_generate_nullary_boolean(self, enable: bool) -> None: ...
@@ -76,7 +106,7 @@ def generate_features(self,
     generate_concept_distance_numerical: bool = True,
     generate_count_numerical: bool = True,
     generate_and_role: bool = True,
-    generate_compose_role: bool = False,
+    generate_compose_role: bool = True,
     generate_diff_role: bool = False,
     generate_identity_role: bool = True,
     generate_inverse_role: bool = True,
@@ -1,6 +1,6 @@
 from typing import List, Overload, Union, MutableSet, Tuple
 
-from ..core import State, DenotationsCaches, Boolean, Numerical, Concept, Role, SyntacticElementFactory
+from ..core import State, DenotationsCaches, EvaluationPlan, Boolean, Numerical, Concept, Role, SyntacticElementFactory
 
 
 
@@ -109,6 +109,15 @@ class Rule:
     def get_effects(self) -> MutableSet[BaseEffect]: ...
 
 
+class PolicyEvaluationPlan:
+    def get_plan(self) -> EvaluationPlan: ...
+
+
+class PolicyEvaluationFrames:
+    def __init__(self, plan: PolicyEvaluationPlan) -> None: ...
+    def get_plan(self) -> PolicyEvaluationPlan: ...
+
+
 class Policy:
     def __str__(self) -> str: ...
     @overload
@@ -116,13 +125,20 @@ class Policy:
     @overload
     def evaluate(self, source_state: State, target_state: State, caches: DenotationsCaches) -> Union[None, Rule]: ...
     @overload
+    def evaluate(self, source_state: State, target_state: State, frames: PolicyEvaluationFrames) -> Union[None, Rule]: ...
+    @overload
     def evaluate_conditions(self, state: State) -> List[Rule]: ...
     @overload
     def evaluate_conditions(self, state: State, caches: DenotationsCaches) -> List[Rule]: ...
     @overload
+    def evaluate_conditions(self, state: State, frames: PolicyEvaluationFrames) -> List[Rule]: ...
+    @overload
     def evaluate_effects(self, source_state: State, target_state: State, rules: List[Rule]) -> bool: ...
     @overload
     def evaluate_effects(self, source_state: State, target_state: State, rules: List[Rule], caches: DenotationsCaches) -> bool: ...
+    @overload
+    def evaluate_effects(self, source_state: State, target_state: State, rules: List[Rule], frames: PolicyEvaluationFrames) -> bool: ...
+    def compile_evaluation_plan(self) -> PolicyEvaluationPlan: ...
     def get_rules(self) -> MutableSet[Rule]: ...
     def get_booleans(self) -> MutableSet[NamedBoolean]: ...
     def get_numericals(self) -> MutableSet[NamedNumerical]: ...
@@ -1,5 +1,6 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>  // Necessary for automatic conversion of e.g. std::vectors
+#include <pybind11/functional.h>  // Necessary for automatic conversion of callbacks
 
 #define STRINGIFY(x) #x
 #define MACRO_STRINGIFY(x) STRINGIFY(x)
@@ -8,13 +9,63 @@
 
 namespace py = pybind11;
 
+using namespace dlplan::core;
 using namespace dlplan::generator;
 
 
 void init_generator(py::module_ &m_generator) {
+    py::class_<CancellationToken>(m_generator, "CancellationToken")
+        .def(py::init<>())
+        .def("cancel", &CancellationToken::cancel)
+        .def("is_cancelled", &CancellationToken::is_cancelled)
+        .def("reset", &CancellationToken::reset)
+    ;
+
     py::class_<FeatureGenerator>(m_generator, "FeatureGenerator")
         .def(py::init<>())
-        .def("generate", &FeatureGenerator::generate, py::arg("factory"), py::arg("states"), py::arg("concept_complexity_limit") = 9, py::arg("role_complexity_limit") = 9, py::arg("boolean_complexity_limit") = 9, py::arg("count_numerical_complexity_limit") = 9, py::arg("distance_numerical_complexity_limit") = 9, py::arg("time_limit") = 3600, py::arg("feature_limit") = 10000)
+        .def("generate", &FeatureGenerator::generate, py::arg("factory"), py::arg("states"), py::arg("concept_complexity_limit") = 9, py::arg("role_complexity_limit") = 9, py::arg("boolean_complexity_limit") = 9, py::arg("count_numerical_complexity_limit") = 9, py::arg("distance_numerical_complexity_limit") = 9, py::arg("time_limit") = 3600, py::arg("feature_limit") = 10000, py::call_guard<py::gil_scoped_release>())
+        .def("resume", &FeatureGenerator::resume, py::arg("factory"), py::arg("states"), py::arg("concept_complexity_limit") = 9, py::arg("role_complexity_limit") = 9, py::arg("boolean_complexity_limit") = 9, py::arg("count_numerical_complexity_limit") = 9, py::arg("distance_numerical_complexity_limit") = 9, py::arg("time_limit") = 3600, py::arg("feature_limit") = 10000, py::call_guard<py::gil_scoped_release>())
+        .def("extend", &FeatureGenerator::extend, py::arg("states"), py::call_guard<py::gil_scoped_release>())
+        .def("set_num_threads", &FeatureGenerator::set_num_threads)
+        .def("set_use_fingerprints", &FeatureGenerator::set_use_fingerprints)
+        .def("set_num_probe_states", &FeatureGenerator::set_num_probe_states)
+        .def("set_incremental", &FeatureGenerator::set_incremental)
+        .def("set_cancellation_token", &FeatureGenerator::set_cancellation_token)
+        .def("set_memory_limit", &FeatureGenerator::set_memory_limit)
+        .def("get_peak_num_bytes", &FeatureGenerator::get_peak_num_bytes)
+        .def("set_checkpoint_file", &FeatureGenerator::set_checkpoint_file)
+        .def("set_boolean_callback", [](FeatureGenerator& self, std::function<bool(std::shared_ptr<const Boolean>, BooleanDenotations, int)> callback) {
+            self.set_boolean_callback([callback](const auto& element, const auto& denotations, int complexity) {
+                return callback(element, *denotations, complexity);
+            });
+        })
+        .def("set_numerical_callback", [](FeatureGenerator& self, std::function<bool(std::shared_ptr<const Numerical>, NumericalDenotations, int)> callback) {
+            self.set_numerical_callback([callback](const auto& element, const auto& denotations, int complexity) {
+                return callback(element, *denotations, complexity);
+            });
+        })
+        .def("set_concept_callback", [](FeatureGenerator& self, std::function<bool(std::shared_ptr<const Concept>, std::vector<ConceptDenotation>, int)> callback) {
+            // ConceptDenotations is not registered so we convert it row by row to a registered type
+            self.set_concept_callback([callback](const auto& element, const auto& denotations, int complexity) {
+                std::vector<ConceptDenotation> rows;
+                rows.reserve(denotations->size());
+                for (std::size_t i = 0; i < denotations->size(); ++i) {
+                    rows.push_back(denotations->get_denotation(i));
+                }
+                return callback(element, rows, complexity);
+            });
+        })
+        .def("set_role_callback", [](FeatureGenerator& self, std::function<bool(std::shared_ptr<const Role>, std::vector<RoleDenotation>, int)> callback) {
+            // RoleDenotations is not registered so we convert it row by row to a registered type
+            self.set_role_callback([callback](const auto& element, const auto& denotations, int complexity) {
+                std::vector<RoleDenotation> rows;
+                rows.reserve(denotations->size());
+                for (std::size_t i = 0; i < denotations->size(); ++i) {
+                    rows.push_back(denotations->get_denotation(i));
+                }
+                return callback(element, rows, complexity);
+            });
+        })
         .def("set_generate_empty_boolean", &FeatureGenerator::set_generate_empty_boolean)
         .def("set_generate_inclusion_boolean", &FeatureGenerator::set_generate_inclusion_boolean)
         .def("set_generate_nullary_boolean", &FeatureGenerator::set_generate_nullary_boolean)
@@ -77,7 +128,7 @@ void init_generator(py::module_ &m_generator) {
         py::arg("generate_concept_distance_numerical") = true,
         py::arg("generate_count_numerical") = true,
         py::arg("generate_and_role") = true,
-        py::arg("generate_compose_role") = false,
+        py::arg("generate_compose_role") = true,
         py::arg("generate_diff_role") = false,
         py::arg("generate_identity_role") = true,
         py::arg("generate_inverse_role") = true,
@@ -113,6 +113,15 @@ void init_policy(py::module_ &m_policy) {
         .def("get_effects", &policy::Rule::get_effects)
     ;
 
+    py::class_<policy::PolicyEvaluationPlan, std::shared_ptr<policy::PolicyEvaluationPlan>>(m_policy, "PolicyEvaluationPlan")
+        .def("get_plan", &policy::PolicyEvaluationPlan::get_plan)
+    ;
+
+    py::class_<policy::PolicyEvaluationFrames, std::shared_ptr<policy::PolicyEvaluationFrames>>(m_policy, "PolicyEvaluationFrames")
+        .def(py::init<std::shared_ptr<const policy::PolicyEvaluationPlan>>())
+        .def("get_plan", &policy::PolicyEvaluationFrames::get_plan)
+    ;
+
     py::class_<policy::Policy, std::shared_ptr<policy::Policy>>(m_policy, "Policy")
         .def("__str__", py::overload_cast<>(&policy::Policy::str, py::const_))
         .def("evaluate", py::overload_cast<const core::State&, const core::State&>(&policy::Policy::evaluate, py::const_))
@@ -121,6 +130,10 @@ void init_policy(py::module_ &m_policy) {
         .def("evaluate_conditions", py::overload_cast<const core::State&, core::DenotationsCaches&>(&policy::Policy::evaluate_conditions, py::const_))
         .def("evaluate_effects", py::overload_cast<const core::State&, const core::State&, const std::vector<std::shared_ptr<const policy::Rule>>&>(&policy::Policy::evaluate_effects, py::const_))
         .def("evaluate_effects", py::overload_cast<const core::State&, const core::State&, const std::vector<std::shared_ptr<const policy::Rule>>&, core::DenotationsCaches&>(&policy::Policy::evaluate_effects, py::const_))
+        .def("compile_evaluation_plan", &policy::Policy::compile_evaluation_plan)
+        .def("evaluate", py::overload_cast<const core::State&, const core::State&, policy::PolicyEvaluationFrames&>(&policy::Policy::evaluate, py::const_))
+        .def("evaluate_conditions", py::overload_cast<const core::State&, policy::PolicyEvaluationFrames&>(&policy::Policy::evaluate_conditions, py::const_))
+        .def("evaluate_effects", py::overload_cast<const core::State&, const core::State&, const std::vector<std::shared_ptr<const policy::Rule>>&, policy::PolicyEvaluationFrames&>(&policy::Policy::evaluate_effects, py::const_))
         .def("get_rules", &policy::Policy::get_rules)
         .def("get_booleans", &policy::Policy::get_booleans)
         .def("get_numericals", &policy::Policy::get_numericals)
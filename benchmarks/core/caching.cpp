@@ -0,0 +1,219 @@
+#include <benchmark/benchmark.h>
+
+#include "utils.h"
+
+#include "../../include/dlplan/core.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dlplan::core;
+
+
+namespace dlplan::benchmarks::core {
+
+static const int num_states = 1000;
+static const int num_threads = std::max(2u, std::thread::hardware_concurrency());
+
+static std::vector<std::shared_ptr<const Numerical>> parse_numericals(SyntacticElementFactory& factory) {
+    return {
+        factory.parse_numerical("n_count(r_primitive(start,0,1))"),
+        factory.parse_numerical("n_count(c_some(r_primitive(conn,0,1),c_primitive(end,1)))"),
+        factory.parse_numerical("n_count(c_and(c_primitive(start,1),c_primitive(end,1)))"),
+        factory.parse_numerical("n_concept_distance(c_primitive(start,1),r_primitive(conn,0,1),c_primitive(end,1))"),
+    };
+}
+
+/// Evaluates the numericals on every state with an initially empty cache,
+/// which mostly measures insertions.
+static void BM_Caching_Insert(benchmark::State& state, int num_objects) {
+    RoadFixture fixture(num_objects, num_states);
+    auto numericals = parse_numericals(*fixture.factory);
+    std::size_t num_bytes = 0;
+    for (auto _ : state) {
+        DenotationsCaches caches;
+        for (const auto& dlplan_state : fixture.states) {
+            for (const auto& numerical : numericals) {
+                benchmark::DoNotOptimize(numerical->evaluate(dlplan_state, caches));
+            }
+        }
+        num_bytes = caches.get_num_bytes();
+    }
+    state.counters["max_bytes"] = num_bytes;
+}
+
+/// Same as BM_Caching_Insert but with a memory budget of 64 KiB.
+static void BM_Caching_Insert_Budget(benchmark::State& state, int num_objects) {
+    RoadFixture fixture(num_objects, num_states);
+    auto numericals = parse_numericals(*fixture.factory);
+    std::size_t max_num_bytes = 0;
+    std::size_t num_evictions = 0;
+    for (auto _ : state) {
+        DenotationsCaches caches;
+        caches.set_memory_budget(64 * 1024);
+        for (const auto& dlplan_state : fixture.states) {
+            for (const auto& numerical : numericals) {
+                benchmark::DoNotOptimize(numerical->evaluate(dlplan_state, caches));
+            }
+            max_num_bytes = std::max(max_num_bytes, caches.get_num_bytes());
+        }
+        num_evictions = caches.get_num_evictions();
+    }
+    state.counters["max_bytes"] = max_num_bytes;
+    state.counters["evictions"] = num_evictions;
+}
+
+/// Evaluates the numericals on every state with a filled cache,
+/// which only measures lookups.
+static void BM_Caching_Lookup(benchmark::State& state, int num_objects) {
+    RoadFixture fixture(num_objects, num_states);
+    auto numericals = parse_numericals(*fixture.factory);
+    DenotationsCaches caches;
+    for (const auto& dlplan_state : fixture.states) {
+        for (const auto& numerical : numericals) {
+            numerical->evaluate(dlplan_state, caches);
+        }
+    }
+    for (auto _ : state) {
+        for (const auto& dlplan_state : fixture.states) {
+            for (const auto& numerical : numericals) {
+                benchmark::DoNotOptimize(numerical->evaluate(dlplan_state, caches));
+            }
+        }
+    }
+}
+
+/// Evaluates the numericals and their concept and role children on all
+/// states at once with an initially empty cache, as the generator does.
+/// With more than one thread, the states are split among the threads.
+static void BM_Caching_Batch(benchmark::State& state, int num_objects, int num_threads) {
+    RoadFixture fixture(num_objects, num_states);
+    auto numericals = parse_numericals(*fixture.factory);
+    std::vector<std::shared_ptr<const Concept>> concepts = {
+        fixture.factory->parse_concept("c_some(r_primitive(conn,0,1),c_primitive(end,1))"),
+        fixture.factory->parse_concept("c_and(c_primitive(start,1),c_primitive(end,1))"),
+        fixture.factory->parse_concept("c_not(c_primitive(end,1))"),
+    };
+    std::vector<std::shared_ptr<const Role>> roles = {
+        fixture.factory->parse_role("r_restrict(r_primitive(conn,0,1),c_primitive(end,1))"),
+        fixture.factory->parse_role("r_or(r_primitive(start,0,1),r_primitive(conn,0,1))"),
+    };
+    for (auto _ : state) {
+        DenotationsCaches caches(num_threads > 1);
+        caches.set_num_threads(num_threads);
+        for (const auto& concept_ : concepts) {
+            benchmark::DoNotOptimize(concept_->evaluate(fixture.states, caches));
+        }
+        for (const auto& role : roles) {
+            benchmark::DoNotOptimize(role->evaluate(fixture.states, caches));
+        }
+        for (const auto& numerical : numericals) {
+            benchmark::DoNotOptimize(numerical->evaluate(fixture.states, caches));
+        }
+    }
+}
+
+/// @brief Successors of the first state in which the first agent moved its
+///        start location to the one in the i-th state, as during search.
+struct SuccessorsFixture {
+    dlplan::core::States successors;
+    std::vector<dlplan::core::AtomIndices> added_atoms;
+    std::vector<dlplan::core::AtomIndices> deleted_atoms;
+
+    explicit SuccessorsFixture(const RoadFixture& fixture) {
+        const auto& atoms = fixture.instance->get_atoms();
+        auto find_start_atom = [&](const dlplan::core::State& state) {
+            return *std::find_if(state.get_atom_indices().begin(), state.get_atom_indices().end(),
+                [&](int atom_idx) { return atoms[atom_idx].get_name().rfind("start(0,", 0) == 0; });
+        };
+        const auto& parent_state = fixture.states.front();
+        int parent_start_atom = find_start_atom(parent_state);
+        for (const auto& dlplan_state : fixture.states) {
+            int start_atom = find_start_atom(dlplan_state);
+            dlplan::core::AtomIndices atom_indices = parent_state.get_atom_indices();
+            *std::find(atom_indices.begin(), atom_indices.end(), parent_start_atom) = start_atom;
+            successors.emplace_back(successors.size() + 1, fixture.instance, std::move(atom_indices));
+            added_atoms.push_back({start_atom});
+            deleted_atoms.push_back({parent_start_atom});
+        }
+    }
+};
+
+/// Evaluates the numericals on the successors of a state
+/// from scratch, with the parent state already cached.
+static void BM_Caching_Successors(benchmark::State& state, int num_objects) {
+    RoadFixture fixture(num_objects, num_states);
+    SuccessorsFixture successors(fixture);
+    auto numericals = parse_numericals(*fixture.factory);
+    for (auto _ : state) {
+        DenotationsCaches caches;
+        for (const auto& numerical : numericals) {
+            numerical->evaluate(fixture.states.front(), caches);
+        }
+        for (const auto& successor : successors.successors) {
+            for (const auto& numerical : numericals) {
+                benchmark::DoNotOptimize(numerical->evaluate(successor, caches));
+            }
+        }
+    }
+}
+
+/// Same as BM_Caching_Successors but derives the denotations
+/// from the parent state with evaluate_delta.
+static void BM_Caching_Successors_Delta(benchmark::State& state, int num_objects) {
+    RoadFixture fixture(num_objects, num_states);
+    SuccessorsFixture successors(fixture);
+    auto numericals = parse_numericals(*fixture.factory);
+    for (auto _ : state) {
+        DenotationsCaches caches;
+        for (const auto& numerical : numericals) {
+            numerical->evaluate(fixture.states.front(), caches);
+        }
+        for (size_t i = 0; i < successors.successors.size(); ++i) {
+            for (const auto& numerical : numericals) {
+                benchmark::DoNotOptimize(numerical->evaluate_delta(successors.successors[i], fixture.states.front(), successors.added_atoms[i], successors.deleted_atoms[i], caches));
+            }
+        }
+    }
+}
+
+/// Evaluates the numericals on every state with a compiled evaluation plan,
+/// which uses neither caches nor virtual evaluation.
+static void BM_Caching_Plan(benchmark::State& state, int num_objects) {
+    RoadFixture fixture(num_objects, num_states);
+    auto numericals = parse_numericals(*fixture.factory);
+    auto plan = std::make_shared<const EvaluationPlan>(
+        std::vector<std::shared_ptr<const Boolean>>(), numericals, std::vector<std::shared_ptr<const Concept>>());
+    EvaluationFrame frame(plan);
+    for (auto _ : state) {
+        for (const auto& dlplan_state : fixture.states) {
+            frame.evaluate(dlplan_state);
+            for (const auto& numerical : numericals) {
+                benchmark::DoNotOptimize(frame.get_denotation(*numerical));
+            }
+        }
+    }
+}
+
+static int register_benchmarks() {
+    for (int num_objects : num_objects_per_domain) {
+        std::string suffix = "/";
+        suffix += std::to_string(num_objects);
+        benchmark::RegisterBenchmark((std::string("Caching1000States/insert") + suffix).c_str(), BM_Caching_Insert, num_objects);
+        benchmark::RegisterBenchmark((std::string("Caching1000States/insert_budget") + suffix).c_str(), BM_Caching_Insert_Budget, num_objects);
+        benchmark::RegisterBenchmark((std::string("Caching1000States/lookup") + suffix).c_str(), BM_Caching_Lookup, num_objects);
+        benchmark::RegisterBenchmark((std::string("Caching1000States/batch") + suffix).c_str(), BM_Caching_Batch, num_objects, 1);
+        benchmark::RegisterBenchmark((std::string("Caching1000States/batch_parallel") + suffix).c_str(), BM_Caching_Batch, num_objects, num_threads);
+        benchmark::RegisterBenchmark((std::string("Caching1000States/successors") + suffix).c_str(), BM_Caching_Successors, num_objects);
+        benchmark::RegisterBenchmark((std::string("Caching1000States/successors_delta") + suffix).c_str(), BM_Caching_Successors_Delta, num_objects);
+        benchmark::RegisterBenchmark((std::string("Caching1000States/plan") + suffix).c_str(), BM_Caching_Plan, num_objects);
+    }
+    return 0;
+}
+
+[[maybe_unused]] static int registered = register_benchmarks();
+
+}
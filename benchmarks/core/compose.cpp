@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+
+#include "utils.h"
+
+#include "../../include/dlplan/core.h"
+#include "../../include/dlplan/core/elements/utils.h"
+
+#include <random>
+#include <string>
+
+using namespace dlplan::core;
+
+
+namespace dlplan::benchmarks::core {
+
+static RoleDenotation make_random_role_denotation(int num_objects, double density, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution dist(density);
+    RoleDenotation result(num_objects);
+    for (int i = 0; i < num_objects; ++i) {
+        for (int j = 0; j < num_objects; ++j) {
+            if (dist(rng)) result.insert({i, j});
+        }
+    }
+    return result;
+}
+
+/// Baseline: the previous join of every left pair with every right pair.
+static void compute_composition_by_join(const RoleDenotation& left, const RoleDenotation& right, RoleDenotation& result) {
+    for (const auto& left_pair : left) {
+        for (const auto& right_pair : right) {
+            if (left_pair.second == right_pair.first) {
+                result.insert(std::make_pair(left_pair.first, right_pair.second));
+            }
+        }
+    }
+}
+
+template<typename Function>
+static void BM_Compose(benchmark::State& state, Function function, int num_objects, double density) {
+    auto left = make_random_role_denotation(num_objects, density, 1);
+    auto right = make_random_role_denotation(num_objects, density, 2);
+    for (auto _ : state) {
+        RoleDenotation result(num_objects);
+        function(left, right, result);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+static int register_benchmarks() {
+    std::vector<int> sizes = num_objects_per_domain;
+    sizes.push_back(512);
+    for (int num_objects : sizes) {
+        // sparse roles resemble the primitive roles in the domains, dense roles their closures
+        for (double density : { 2.0 / num_objects, 0.5 }) {
+            std::string suffix = "/";
+            suffix += std::to_string(num_objects);
+            suffix += (density == 0.5) ? "/dense" : "/sparse";
+            if (num_objects <= 128) {
+                benchmark::RegisterBenchmark((std::string("Compose/join") + suffix).c_str(), BM_Compose<decltype(&compute_composition_by_join)>, &compute_composition_by_join, num_objects, density);
+            }
+            benchmark::RegisterBenchmark((std::string("Compose/rows") + suffix).c_str(), BM_Compose<decltype(&utils::compute_composition_by_rows)>, &utils::compute_composition_by_rows, num_objects, density);
+            benchmark::RegisterBenchmark((std::string("Compose/four_russians") + suffix).c_str(), BM_Compose<decltype(&utils::compute_composition_four_russians)>, &utils::compute_composition_four_russians, num_objects, density);
+        }
+    }
+    return 0;
+}
+
+[[maybe_unused]] static int registered = register_benchmarks();
+
+}
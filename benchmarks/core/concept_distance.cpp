@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+
+#include "utils.h"
+
+#include "../../include/dlplan/core.h"
+#include "../../include/dlplan/core/elements/utils.h"
+
+#include <deque>
+#include <random>
+#include <string>
+
+using namespace dlplan::core;
+
+
+namespace dlplan::benchmarks::core {
+
+/// @brief A chain plus num_objects random shortcuts, as in transitive_closure.cpp.
+static RoleDenotation make_graph_role_denotation(int num_objects) {
+    RoleDenotation result(num_objects);
+    for (int i = 0; i + 1 < num_objects; ++i) {
+        result.insert({i, i + 1});
+    }
+    std::mt19937 rng(num_objects);
+    std::uniform_int_distribution<int> dist(0, num_objects - 1);
+    for (int i = 0; i < num_objects; ++i) {
+        result.insert({dist(rng), dist(rng)});
+    }
+    return result;
+}
+
+/// Baseline: the previous BFS that probes every potential successor of a dequeued object.
+static int compute_shortest_distance_by_probing(const ConceptDenotation& sources, const RoleDenotation& edges, const ConceptDenotation& targets) {
+    int num_objects = targets.get_num_objects();
+    utils::Distances distances(num_objects, INF);
+    std::deque<int> queue;
+    for (int source : sources) {
+        distances[source] = 0;
+        queue.push_back(source);
+        if (targets.contains(source)) {
+            return 0;
+        }
+    }
+    while (!queue.empty()) {
+        int source = queue.front();
+        queue.pop_front();
+        for (int target = 0; target < num_objects; ++target) {
+            if (edges.contains(std::make_pair(source, target))) {
+                int alt = distances[source] + 1;
+                if (distances[target] > alt) {
+                    if (targets.contains(target)) {
+                        return alt;
+                    }
+                    queue.push_back(target);
+                    distances[target] = alt;
+                }
+            }
+        }
+    }
+    return INF;
+}
+
+template<typename Function>
+static void BM_ConceptDistance(benchmark::State& state, Function function, int num_objects) {
+    auto edges = make_graph_role_denotation(num_objects);
+    // the last object of the chain is the farthest from the first in expectation
+    ConceptDenotation sources(num_objects);
+    sources.insert(0);
+    ConceptDenotation targets(num_objects);
+    targets.insert(num_objects - 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(function(sources, edges, targets));
+    }
+}
+
+static void BM_SumConceptDistance(benchmark::State& state, int num_objects) {
+    auto edges = make_graph_role_denotation(num_objects);
+    ConceptDenotation sources(num_objects);
+    sources.insert(0);
+    ConceptDenotation targets(num_objects);
+    targets.set();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utils::compute_multi_source_multi_target_shortest_distances(sources, edges, targets));
+    }
+}
+
+static int register_benchmarks() {
+    for (int num_objects : num_objects_per_domain) {
+        std::string suffix = "/";
+        suffix += std::to_string(num_objects);
+        benchmark::RegisterBenchmark((std::string("ConceptDistance/probing") + suffix).c_str(), BM_ConceptDistance<decltype(&compute_shortest_distance_by_probing)>, &compute_shortest_distance_by_probing, num_objects);
+        benchmark::RegisterBenchmark((std::string("ConceptDistance/frontier") + suffix).c_str(), BM_ConceptDistance<decltype(&utils::compute_multi_source_multi_target_shortest_distance)>, &utils::compute_multi_source_multi_target_shortest_distance, num_objects);
+        benchmark::RegisterBenchmark((std::string("SumConceptDistance/frontier") + suffix).c_str(), BM_SumConceptDistance, num_objects);
+    }
+    return 0;
+}
+
+[[maybe_unused]] static int registered = register_benchmarks();
+
+}
@@ -0,0 +1,151 @@
+#include <benchmark/benchmark.h>
+
+#include "utils.h"
+
+#include "../../include/dlplan/utils/bitset_kernels.h"
+#include "../../include/dlplan/utils/dynamic_bitset.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace dlplan;
+using namespace dlplan::kernels;
+
+
+namespace dlplan::benchmarks::core {
+
+static std::vector<Block> make_random_blocks(std::size_t num_blocks, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<Block> result(num_blocks);
+    for (auto& block : result) block = rng();
+    return result;
+}
+
+static std::size_t compute_num_blocks(int num_bits) {
+    return (num_bits + 63) / 64;
+}
+
+static void BM_Kernel_And(benchmark::State& state, const BitsetKernels* kernels, int num_bits) {
+    std::size_t num_blocks = compute_num_blocks(num_bits);
+    auto left = make_random_blocks(num_blocks, 1);
+    auto right = make_random_blocks(num_blocks, 2);
+    for (auto _ : state) {
+        kernels->bitwise_and(left.data(), right.data(), num_blocks);
+        benchmark::DoNotOptimize(left.data());
+    }
+}
+
+static void BM_Kernel_Or(benchmark::State& state, const BitsetKernels* kernels, int num_bits) {
+    std::size_t num_blocks = compute_num_blocks(num_bits);
+    auto left = make_random_blocks(num_blocks, 1);
+    auto right = make_random_blocks(num_blocks, 2);
+    for (auto _ : state) {
+        kernels->bitwise_or(left.data(), right.data(), num_blocks);
+        benchmark::DoNotOptimize(left.data());
+    }
+}
+
+static void BM_Kernel_Not(benchmark::State& state, const BitsetKernels* kernels, int num_bits) {
+    std::size_t num_blocks = compute_num_blocks(num_bits);
+    auto data = make_random_blocks(num_blocks, 1);
+    for (auto _ : state) {
+        kernels->bitwise_not(data.data(), num_blocks);
+        benchmark::DoNotOptimize(data.data());
+    }
+}
+
+static void BM_Kernel_IsSubsetOf(benchmark::State& state, const BitsetKernels* kernels, int num_bits) {
+    std::size_t num_blocks = compute_num_blocks(num_bits);
+    // worst case: left is a subset of right, hence all blocks must be inspected
+    auto right = make_random_blocks(num_blocks, 1);
+    auto left = right;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(kernels->is_subset_of(left.data(), right.data(), num_blocks));
+    }
+}
+
+static void BM_Kernel_Equal(benchmark::State& state, const BitsetKernels* kernels, int num_bits) {
+    std::size_t num_blocks = compute_num_blocks(num_bits);
+    auto left = make_random_blocks(num_blocks, 1);
+    auto right = left;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(kernels->equal(left.data(), right.data(), num_blocks));
+    }
+}
+
+static void BM_Kernel_Count(benchmark::State& state, const BitsetKernels* kernels, int num_bits) {
+    std::size_t num_blocks = compute_num_blocks(num_bits);
+    auto data = make_random_blocks(num_blocks, 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(kernels->count(data.data(), num_blocks));
+    }
+}
+
+/// Baseline: the previous bit-by-bit count over 32-bit blocks.
+static void BM_DynamicBitset_Count_Unsigned(benchmark::State& state, int num_bits) {
+    DynamicBitset<unsigned> bitset(num_bits);
+    for (int i = 0; i < num_bits; i += 3) bitset.set(i);
+    for (auto _ : state) {
+        int result = 0;
+        for (int pos = 0; pos < num_bits; ++pos) result += bitset.test(pos);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+static void BM_DynamicBitset_Count(benchmark::State& state, int num_bits) {
+    DynamicBitset<std::uint64_t> bitset(num_bits);
+    for (int i = 0; i < num_bits; i += 3) bitset.set(i);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bitset.count());
+    }
+}
+
+static void BM_DynamicBitset_And_Unsigned(benchmark::State& state, int num_bits) {
+    DynamicBitset<unsigned> left(num_bits);
+    DynamicBitset<unsigned> right(num_bits);
+    right.set();
+    for (auto _ : state) {
+        left &= right;
+        benchmark::DoNotOptimize(left);
+    }
+}
+
+static void BM_DynamicBitset_And(benchmark::State& state, int num_bits) {
+    DynamicBitset<std::uint64_t> left(num_bits);
+    DynamicBitset<std::uint64_t> right(num_bits);
+    right.set();
+    for (auto _ : state) {
+        left &= right;
+        benchmark::DoNotOptimize(left);
+    }
+}
+
+static int register_benchmarks() {
+    for (int num_objects : num_objects_per_domain) {
+        // concept denotations have num_objects bits, role denotations num_objects^2 bits
+        for (int num_bits : { num_objects, num_objects * num_objects }) {
+            std::string suffix = "/";
+            suffix += std::to_string(num_bits);
+            for (auto variant : get_supported_variants()) {
+                const BitsetKernels* kernels = get_kernels(variant);
+                std::string name = to_string(variant);
+                benchmark::RegisterBenchmark((std::string("Kernel_And/") + name + suffix).c_str(), BM_Kernel_And, kernels, num_bits);
+                benchmark::RegisterBenchmark((std::string("Kernel_Or/") + name + suffix).c_str(), BM_Kernel_Or, kernels, num_bits);
+                benchmark::RegisterBenchmark((std::string("Kernel_Not/") + name + suffix).c_str(), BM_Kernel_Not, kernels, num_bits);
+                benchmark::RegisterBenchmark((std::string("Kernel_IsSubsetOf/") + name + suffix).c_str(), BM_Kernel_IsSubsetOf, kernels, num_bits);
+                benchmark::RegisterBenchmark((std::string("Kernel_Equal/") + name + suffix).c_str(), BM_Kernel_Equal, kernels, num_bits);
+                benchmark::RegisterBenchmark((std::string("Kernel_Count/") + name + suffix).c_str(), BM_Kernel_Count, kernels, num_bits);
+            }
+            benchmark::RegisterBenchmark((std::string("DynamicBitset_Count/unsigned") + suffix).c_str(), BM_DynamicBitset_Count_Unsigned, num_bits);
+            benchmark::RegisterBenchmark((std::string("DynamicBitset_Count/uint64") + suffix).c_str(), BM_DynamicBitset_Count, num_bits);
+            benchmark::RegisterBenchmark((std::string("DynamicBitset_And/unsigned") + suffix).c_str(), BM_DynamicBitset_And_Unsigned, num_bits);
+            benchmark::RegisterBenchmark((std::string("DynamicBitset_And/uint64") + suffix).c_str(), BM_DynamicBitset_And, num_bits);
+        }
+    }
+    return 0;
+}
+
+[[maybe_unused]] static int registered = register_benchmarks();
+
+}
@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+
+#include "utils.h"
+
+#include "../../include/dlplan/core.h"
+#include "../../include/dlplan/core/elements/utils.h"
+
+#include <algorithm>
+#include <string>
+
+using namespace dlplan::core;
+
+
+namespace dlplan::benchmarks::core {
+
+/// Baseline: the previous Floyd-Warshall on every state followed by a loop over all triples.
+static int compute_role_distance_by_floyd_warshall(const RoleDenotation& role_from_denot, const RoleDenotation& role_denot, const RoleDenotation& role_to_denot) {
+    int num_objects = role_denot.get_num_objects();
+    std::vector<std::vector<int>> dist(num_objects, std::vector<int>(num_objects, INF));
+    for (const auto& pair : role_denot) {
+        dist[pair.first][pair.second] = 1;
+    }
+    for (int i = 0; i < num_objects; ++i) {
+        dist[i][i] = 0;
+    }
+    for (int k = 0; k < num_objects; ++k) {
+        for (int i = 0; i < num_objects; ++i) {
+            for (int j = 0; j < num_objects; ++j) {
+                dist[i][j] = std::min(dist[i][j], utils::path_addition(dist[i][k], dist[k][j]));
+            }
+        }
+    }
+    int result = INF;
+    for (int k = 0; k < num_objects; ++k) {
+        for (int i = 0; i < num_objects; ++i) {
+            if (role_from_denot.contains(std::make_pair(k, i))) {
+                for (int j = 0; j < num_objects; ++j) {
+                    if (role_to_denot.contains(std::make_pair(k, j))) {
+                        result = std::min<int>(result, dist[i][j]);
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+static const int num_states = 100;
+
+static void BM_RoleDistance_FloydWarshall(benchmark::State& state, int num_objects) {
+    RoadFixture fixture(num_objects, num_states);
+    auto role_from = fixture.factory->parse_role("r_primitive(start,0,1)");
+    auto role = fixture.factory->parse_role("r_primitive(conn,0,1)");
+    auto role_to = fixture.factory->parse_role("r_primitive(end,0,1)");
+    for (auto _ : state) {
+        for (const auto& dlplan_state : fixture.states) {
+            benchmark::DoNotOptimize(compute_role_distance_by_floyd_warshall(
+                role_from->evaluate(dlplan_state), role->evaluate(dlplan_state), role_to->evaluate(dlplan_state)));
+        }
+    }
+}
+
+static void BM_RoleDistance(benchmark::State& state, int num_objects) {
+    RoadFixture fixture(num_objects, num_states);
+    auto numerical = fixture.factory->parse_numerical("n_role_distance(r_primitive(start,0,1),r_primitive(conn,0,1),r_primitive(end,0,1))");
+    for (auto _ : state) {
+        for (const auto& dlplan_state : fixture.states) {
+            benchmark::DoNotOptimize(numerical->evaluate(dlplan_state));
+        }
+    }
+}
+
+static void BM_RoleDistance_Cached(benchmark::State& state, int num_objects) {
+    RoadFixture fixture(num_objects, num_states);
+    auto numerical = fixture.factory->parse_numerical("n_role_distance(r_primitive(start,0,1),r_primitive(conn,0,1),r_primitive(end,0,1))");
+    for (auto _ : state) {
+        // a fresh cache per iteration such that the numerical is evaluated on every state
+        DenotationsCaches caches;
+        benchmark::DoNotOptimize(numerical->evaluate(fixture.states, caches));
+    }
+}
+
+static int register_benchmarks() {
+    std::vector<int> sizes = num_objects_per_domain;
+    sizes.push_back(50);
+    std::sort(sizes.begin(), sizes.end());
+    for (int num_objects : sizes) {
+        std::string suffix = "/";
+        suffix += std::to_string(num_objects);
+        benchmark::RegisterBenchmark((std::string("RoleDistance100States/floyd_warshall") + suffix).c_str(), BM_RoleDistance_FloydWarshall, num_objects);
+        benchmark::RegisterBenchmark((std::string("RoleDistance100States/bfs") + suffix).c_str(), BM_RoleDistance, num_objects);
+        benchmark::RegisterBenchmark((std::string("RoleDistance100States/bfs_cached") + suffix).c_str(), BM_RoleDistance_Cached, num_objects);
+    }
+    return 0;
+}
+
+[[maybe_unused]] static int registered = register_benchmarks();
+
+}
@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+
+#include "utils.h"
+
+#include "../../include/dlplan/core.h"
+
+#include <memory>
+#include <random>
+#include <string>
+
+using namespace dlplan::core;
+
+
+namespace dlplan::benchmarks::core {
+
+/// @brief A state over num_objects objects whose conn atoms form a graph
+///        that resembles the road networks in spanner and visitall:
+///        a chain plus num_objects random shortcuts.
+struct GraphFixture {
+    std::shared_ptr<VocabularyInfo> vocabulary;
+    std::shared_ptr<InstanceInfo> instance;
+    std::unique_ptr<State> state;
+    std::unique_ptr<SyntacticElementFactory> factory;
+
+    explicit GraphFixture(int num_objects)
+        : vocabulary(std::make_shared<VocabularyInfo>()) {
+        vocabulary->add_predicate("conn", 2);
+        instance = std::make_shared<InstanceInfo>(0, vocabulary);
+        AtomIndices atom_indices;
+        for (int i = 0; i + 1 < num_objects; ++i) {
+            atom_indices.push_back(instance->add_atom("conn", {std::to_string(i), std::to_string(i + 1)}).get_index());
+        }
+        std::mt19937 rng(num_objects);
+        std::uniform_int_distribution<int> dist(0, num_objects - 1);
+        for (int i = 0; i < num_objects; ++i) {
+            atom_indices.push_back(instance->add_atom("conn", {std::to_string(dist(rng)), std::to_string(dist(rng))}).get_index());
+        }
+        state = std::make_unique<State>(0, instance, atom_indices);
+        factory = std::make_unique<SyntacticElementFactory>(vocabulary);
+    }
+};
+
+/// Baseline: the previous fixpoint iteration that joins all pairs until nothing changes.
+static void compute_transitive_closure_by_join(const RoleDenotation& denot, RoleDenotation& result) {
+    result = denot;
+    bool changed = false;
+    do {
+        RoleDenotation tmp_result = result;
+        for (const auto& pair_1 : tmp_result) {
+            for (const auto& pair_2 : tmp_result) {
+                if (pair_1.second == pair_2.first) {
+                    result.insert(std::make_pair(pair_1.first, pair_2.second));
+                }
+            }
+        }
+        changed = (result.size() != tmp_result.size());
+    } while (changed);
+}
+
+static void BM_TransitiveClosure_Join(benchmark::State& state, int num_objects) {
+    GraphFixture fixture(num_objects);
+    auto role = fixture.factory->parse_role("r_primitive(conn,0,1)");
+    for (auto _ : state) {
+        RoleDenotation result(num_objects);
+        compute_transitive_closure_by_join(role->evaluate(*fixture.state), result);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+static void BM_TransitiveClosure(benchmark::State& state, int num_objects) {
+    GraphFixture fixture(num_objects);
+    auto role = fixture.factory->parse_role("r_transitive_closure(r_primitive(conn,0,1))");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(role->evaluate(*fixture.state));
+    }
+}
+
+static void BM_TransitiveReflexiveClosure(benchmark::State& state, int num_objects) {
+    GraphFixture fixture(num_objects);
+    auto role = fixture.factory->parse_role("r_transitive_reflexive_closure(r_primitive(conn,0,1))");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(role->evaluate(*fixture.state));
+    }
+}
+
+static int register_benchmarks() {
+    for (int num_objects : num_objects_per_domain) {
+        std::string suffix = "/";
+        suffix += std::to_string(num_objects);
+        benchmark::RegisterBenchmark((std::string("TransitiveClosure/join") + suffix).c_str(), BM_TransitiveClosure_Join, num_objects);
+        benchmark::RegisterBenchmark((std::string("TransitiveClosure/warshall") + suffix).c_str(), BM_TransitiveClosure, num_objects);
+        benchmark::RegisterBenchmark((std::string("TransitiveReflexiveClosure/warshall") + suffix).c_str(), BM_TransitiveReflexiveClosure, num_objects);
+    }
+    return 0;
+}
+
+[[maybe_unused]] static int registered = register_benchmarks();
+
+}
@@ -0,0 +1,63 @@
+#ifndef DLPLAN_BENCHMARKS_CORE_UTILS_H_
+#define DLPLAN_BENCHMARKS_CORE_UTILS_H_
+
+#include "../../include/dlplan/core.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+
+namespace dlplan::benchmarks::core {
+
+/*
+  Number of objects in the largest instances of the domains in benchmarks/
+  without constants: blocksworld (5), gripper and visitall (7), miconic (8),
+  barman (12), childsnack (13), reward (16), spanner (18), delivery (20).
+  Two larger sizes show the asymptotic behavior.
+*/
+inline const std::vector<int> num_objects_per_domain = { 5, 7, 8, 12, 13, 16, 18, 20, 64, 128 };
+
+/// @brief States over num_objects objects whose conn atoms form a chain
+///        plus num_objects random shortcuts, as in transitive_closure.cpp.
+///        The states differ in the start and end atoms of the agents,
+///        which resembles the movement of trucks along a road network.
+struct RoadFixture {
+    std::shared_ptr<dlplan::core::VocabularyInfo> vocabulary;
+    std::shared_ptr<dlplan::core::InstanceInfo> instance;
+    dlplan::core::States states;
+    std::unique_ptr<dlplan::core::SyntacticElementFactory> factory;
+
+    RoadFixture(int num_objects, int num_states)
+        : vocabulary(std::make_shared<dlplan::core::VocabularyInfo>()) {
+        vocabulary->add_predicate("conn", 2);
+        vocabulary->add_predicate("start", 2);
+        vocabulary->add_predicate("end", 2);
+        instance = std::make_shared<dlplan::core::InstanceInfo>(0, vocabulary);
+        dlplan::core::AtomIndices conn_atom_indices;
+        for (int i = 0; i + 1 < num_objects; ++i) {
+            conn_atom_indices.push_back(instance->add_atom("conn", {std::to_string(i), std::to_string(i + 1)}).get_index());
+        }
+        std::mt19937 rng(num_objects);
+        std::uniform_int_distribution<int> dist(0, num_objects - 1);
+        for (int i = 0; i < num_objects; ++i) {
+            conn_atom_indices.push_back(instance->add_atom("conn", {std::to_string(dist(rng)), std::to_string(dist(rng))}).get_index());
+        }
+        for (int s = 0; s < num_states; ++s) {
+            dlplan::core::AtomIndices atom_indices = conn_atom_indices;
+            // two agents, each with a start and an end location
+            for (int agent = 0; agent < 2; ++agent) {
+                std::string agent_name = std::to_string(agent);
+                atom_indices.push_back(instance->add_atom("start", {agent_name, std::to_string(dist(rng))}).get_index());
+                atom_indices.push_back(instance->add_atom("end", {agent_name, std::to_string(dist(rng))}).get_index());
+            }
+            states.emplace_back(s, instance, atom_indices);
+        }
+        factory = std::make_unique<dlplan::core::SyntacticElementFactory>(vocabulary);
+    }
+};
+
+}
+
+#endif
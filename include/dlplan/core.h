@@ -4,8 +4,14 @@
 #ifndef DLPLAN_INCLUDE_DLPLAN_CORE_H_
 #define DLPLAN_INCLUDE_DLPLAN_CORE_H_
 
+#include <array>
+#include <cassert>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <string>
+#include <type_traits>
 #include <unordered_set>
 #include <unordered_map>
 #include <vector>
@@ -21,7 +27,10 @@
 // Forward declarations of this header
 namespace dlplan::core {
 class ConceptDenotation;
+class ConceptDenotationView;
 class RoleDenotation;
+template<typename Denotation>
+class DenotationMatrix;
 class DenotationsCaches;
 struct DenotationsCacheKey;
 class Constant;
@@ -31,11 +40,16 @@ class Object;
 class Atom;
 class InstanceInfo;
 class State;
+class StateDelta;
+struct EvaluationInstruction;
+class EvaluationPlan;
+class EvaluationPlanBuilder;
+class EvaluationFrame;
 class SyntacticElementFactory;
 class SyntacticElementFactoryImpl;
 
-using ConceptDenotations = std::vector<std::shared_ptr<const ConceptDenotation>>;
-using RoleDenotations = std::vector<std::shared_ptr<const RoleDenotation>>;
+using ConceptDenotations = DenotationMatrix<ConceptDenotation>;
+using RoleDenotations = DenotationMatrix<RoleDenotation>;
 using BooleanDenotations = std::vector<bool>;
 using NumericalDenotations = std::vector<int>;
 
@@ -58,6 +72,8 @@ using ElementIndex = int;
 using InstanceIndex = int;
 
 using StateIndex = int;
+
+class PairwiseDistances;
 }
 
 
@@ -115,9 +131,35 @@ namespace dlplan::core {
 class ConceptDenotation : public Base<ConceptDenotation> {
 private:
     int m_num_objects;
-    DynamicBitset<unsigned> m_data;
+    DynamicBitset<std::uint64_t> m_data;
+
+    friend class ConceptDenotationView;
+    template<typename Denotation>
+    friend class DenotationMatrix;
 
 public:
+    /// @brief Forward iterator over the object indices of the denotation in ascending order.
+    class const_iterator {
+    private:
+        DynamicBitset<std::uint64_t>::const_iterator m_it;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ObjectIndex;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const ObjectIndex*;
+        using reference = ObjectIndex;
+
+        const_iterator() = default;
+        explicit const_iterator(DynamicBitset<std::uint64_t>::const_iterator it) : m_it(it) { }
+
+        ObjectIndex operator*() const { return static_cast<ObjectIndex>(*m_it); }
+        const_iterator& operator++() { ++m_it; return *this; }
+        const_iterator operator++(int) { const_iterator prev = *this; ++m_it; return prev; }
+        bool operator==(const const_iterator& other) const { return m_it == other.m_it; }
+        bool operator!=(const const_iterator& other) const { return m_it != other.m_it; }
+    };
+
     ConceptDenotation(int num_objects);
     ConceptDenotation(const ConceptDenotation& other);
     ConceptDenotation& operator=(const ConceptDenotation& other);
@@ -134,8 +176,14 @@ public:
     ConceptDenotation& operator-=(const ConceptDenotation& other);
     ConceptDenotation& operator~();
 
+    ConceptDenotation& operator&=(const ConceptDenotationView& other);
+    ConceptDenotation& operator|=(const ConceptDenotationView& other);
+    ConceptDenotation& operator-=(const ConceptDenotationView& other);
+
     bool contains(ObjectIndex value) const;
     void set();
+    /// @brief Removes all objects.
+    void clear();
     void insert(ObjectIndex value);
     void erase(ObjectIndex value);
 
@@ -143,6 +191,8 @@ public:
     bool empty() const;
     bool intersects(const ConceptDenotation& other) const;
     bool is_subset_of(const ConceptDenotation& other) const;
+    bool intersects(const ConceptDenotationView& other) const;
+    bool is_subset_of(const ConceptDenotationView& other) const;
 
     /// @brief Compute a vector representation of this concept denotation.
     /// @return A vector of object indices.
@@ -152,7 +202,52 @@ public:
     /// @return A vector of object indices in ascending order.
     ObjectIndices to_sorted_vector() const;
 
+    /// @brief Iterates over the object indices without allocating memory.
+    const_iterator begin() const { return const_iterator(m_data.begin()); }
+    const_iterator end() const { return const_iterator(m_data.end()); }
+
     int get_num_objects() const;
+
+    /// @brief Returns the number of bytes that the denotation owns on the heap.
+    std::size_t get_dynamic_memory_usage() const;
+};
+
+
+/// @brief A read-only view on a set of objects that shares the word layout
+///        of ConceptDenotation, e.g., a row of a RoleDenotation.
+///
+/// The view does not own its data and is invalidated if the viewed
+/// denotation is modified or destroyed.
+class ConceptDenotationView {
+private:
+    const std::uint64_t* m_blocks;
+    int m_num_objects;
+    int m_num_blocks;
+
+public:
+    ConceptDenotationView(const std::uint64_t* blocks, int num_objects);
+    ConceptDenotationView(const ConceptDenotation& denotation);
+
+    bool contains(ObjectIndex value) const {
+        assert(value >= 0 && value < m_num_objects);
+        return (m_blocks[value / 64] >> (value % 64)) & 1;
+    }
+
+    int size() const;
+    bool empty() const;
+    bool intersects(const ConceptDenotationView& other) const;
+    bool is_subset_of(const ConceptDenotationView& other) const;
+
+    ConceptDenotation::const_iterator begin() const {
+        return ConceptDenotation::const_iterator(DynamicBitset<std::uint64_t>::const_iterator(m_blocks, m_num_blocks, true));
+    }
+    ConceptDenotation::const_iterator end() const {
+        return ConceptDenotation::const_iterator(DynamicBitset<std::uint64_t>::const_iterator(m_blocks, m_num_blocks, false));
+    }
+
+    const std::uint64_t* data() const { return m_blocks; }
+    int get_num_blocks() const { return m_num_blocks; }
+    int get_num_objects() const { return m_num_objects; }
 };
 
 
@@ -166,9 +261,50 @@ public:
 class RoleDenotation : public Base<RoleDenotation> {
 private:
     int m_num_objects;
-    DynamicBitset<unsigned> m_data;
+    // Each row is padded to a multiple of 64 bits such that the successors
+    // of an object can be accessed as a ConceptDenotationView.
+    int m_num_blocks_per_row;
+    // Instances with up to 16 objects need at most 16 blocks and are stored
+    // inline without heap allocation.
+    DynamicBitset<std::uint64_t, 16> m_data;
+
+    std::size_t compute_position(const PairOfObjectIndices& value) const {
+        return static_cast<std::size_t>(value.first) * m_num_blocks_per_row * 64 + value.second;
+    }
+
+    void zero_padding_bits();
+
+    template<typename Denotation>
+    friend class DenotationMatrix;
 
 public:
+    /// @brief Forward iterator over the pairs of object indices of the denotation
+    ///        in ascending order by first then second element.
+    class const_iterator {
+    private:
+        DynamicBitset<std::uint64_t>::const_iterator m_it;
+        int m_num_bits_per_row;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = PairOfObjectIndices;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const PairOfObjectIndices*;
+        using reference = PairOfObjectIndices;
+
+        const_iterator() : m_it(), m_num_bits_per_row(0) { }
+        const_iterator(DynamicBitset<std::uint64_t>::const_iterator it, int num_bits_per_row) : m_it(it), m_num_bits_per_row(num_bits_per_row) { }
+
+        PairOfObjectIndices operator*() const {
+            std::size_t position = *m_it;
+            return PairOfObjectIndices(position / m_num_bits_per_row, position % m_num_bits_per_row);
+        }
+        const_iterator& operator++() { ++m_it; return *this; }
+        const_iterator operator++(int) { const_iterator prev = *this; ++m_it; return prev; }
+        bool operator==(const const_iterator& other) const { return m_it == other.m_it; }
+        bool operator!=(const const_iterator& other) const { return m_it != other.m_it; }
+    };
+
     explicit RoleDenotation(int num_objects);
     RoleDenotation(const RoleDenotation& other);
     RoleDenotation& operator=(const RoleDenotation& other);
@@ -187,6 +323,8 @@ public:
 
     bool contains(const PairOfObjectIndices& value) const;
     void set();
+    /// @brief Removes all pairs.
+    void clear();
     void insert(const PairOfObjectIndices& value);
     void erase(const PairOfObjectIndices& value);
 
@@ -195,6 +333,21 @@ public:
     bool intersects(const RoleDenotation& other) const;
     bool is_subset_of(const RoleDenotation& other) const;
 
+    /// @brief Returns the successors of an object, i.e., the row of the
+    ///        bit matrix. Columns are the rows of the transpose.
+    ConceptDenotationView get_row(ObjectIndex source) const;
+
+    /// @brief Adds all pairs (source, b) where b in other.
+    void unite_row(ObjectIndex source, const ConceptDenotationView& other);
+
+    /// @brief Removes all pairs (source, b) where b notin other.
+    void intersect_row(ObjectIndex source, const ConceptDenotationView& other);
+
+    /// @brief Compute the transpose, i.e., the inverse relation.
+    ///        Since cached denotations are shared and immutable,
+    ///        callers that need columns compute the transpose once.
+    RoleDenotation transpose() const;
+
     /// @brief Compute a vector representation of this role denotation.
     /// @return A vector of pairs of object indices.
     PairsOfObjectIndices to_vector() const;
@@ -203,9 +356,89 @@ public:
     /// @return A vector of pairs of object indices in ascending order by first then second element.
     PairsOfObjectIndices to_sorted_vector() const;
 
+    /// @brief Iterates over the pairs of object indices without allocating memory.
+    const_iterator begin() const { return const_iterator(m_data.begin(), m_num_blocks_per_row * 64); }
+    const_iterator end() const { return const_iterator(m_data.end(), m_num_blocks_per_row * 64); }
+
     int get_num_objects() const;
+    int get_num_blocks_per_row() const;
+
+    /// @brief Returns the number of bytes that the denotation owns on the heap.
+    std::size_t get_dynamic_memory_usage() const;
 };
 
+/// @brief Encapsulates the denotations of an element on a sequence of states
+///        and provides functionality to access and modify them.
+///
+/// Row i holds the denotation on the i-th state in the word layout of the
+/// Denotation type. All rows are stored contiguously in a single array of
+/// blocks such that matrices are hashed and compared blockwise, and
+/// elements are evaluated with tight loops over the states.
+template<typename Denotation>
+class DenotationMatrix {
+private:
+    std::vector<std::uint64_t> m_blocks;
+    // Row i occupies the blocks in the range [m_offsets[i], m_offsets[i+1]).
+    std::vector<std::size_t> m_offsets;
+    std::vector<int> m_num_objects;
+
+    static std::size_t compute_num_blocks(int num_objects);
+
+public:
+    using denotation_type = Denotation;
+
+    DenotationMatrix();
+    /// @brief Creates a matrix with empty denotations on the given states.
+    explicit DenotationMatrix(const States& states);
+
+    bool operator==(const DenotationMatrix& other) const;
+    bool operator!=(const DenotationMatrix& other) const;
+    std::size_t hash() const;
+    /// @brief Returns a 128-bit hash of the matrix. Equal matrices have
+    ///        equal fingerprints and distinct matrices almost never do.
+    std::array<std::uint64_t, 2> compute_fingerprint() const;
+
+    /// @brief Applies the operation to all rows at once. The matrices must
+    ///        be created from the same states.
+    DenotationMatrix& operator&=(const DenotationMatrix& other);
+    DenotationMatrix& operator|=(const DenotationMatrix& other);
+    DenotationMatrix& operator-=(const DenotationMatrix& other);
+
+    /// @brief Copies row i into the given denotation. The denotation is only
+    ///        reallocated if its number of objects differs.
+    void load_row(std::size_t i, Denotation& denotation) const;
+    /// @brief Overwrites row i with the given denotation.
+    void store_row(std::size_t i, const Denotation& denotation);
+    /// @brief Resets the given denotation to the empty denotation of row i.
+    void reset_denotation(std::size_t i, Denotation& denotation) const;
+    Denotation get_denotation(std::size_t i) const;
+
+    int count(std::size_t i) const;
+    bool empty(std::size_t i) const;
+    /// @brief Returns true iff row i is a subset of row i of the other matrix.
+    bool is_subset_of(std::size_t i, const DenotationMatrix& other) const;
+
+    /// @brief Returns the number of rows.
+    std::size_t size() const;
+    int get_num_objects(std::size_t i) const;
+
+    /// @brief Returns the number of bytes that the matrix owns on the heap.
+    std::size_t get_dynamic_memory_usage() const;
+};
+
+template<typename Denotation>
+inline std::size_t get_dynamic_memory_usage(const DenotationMatrix<Denotation>& denotations) {
+    return denotations.get_dynamic_memory_usage();
+}
+
+inline std::size_t get_dynamic_memory_usage(const ConceptDenotation& denotation) {
+    return denotation.get_dynamic_memory_usage();
+}
+
+inline std::size_t get_dynamic_memory_usage(const RoleDenotation& denotation) {
+    return denotation.get_dynamic_memory_usage();
+}
+
 /// @brief Encapsulates a key to store and retrieve denotations from the cache.
 struct DenotationsCacheKey {
     ElementIndex element;
@@ -218,12 +451,115 @@ struct DenotationsCacheKey {
 };
 
 
+/// @brief Statistics of the evaluations of an element with caches.
+struct ElementStatistics {
+    std::size_t num_hits = 0;
+    std::size_t num_misses = 0;
+    // Cumulative time of the evaluations that missed the cache, including
+    // the evaluation of the children of the element.
+    std::chrono::nanoseconds evaluate_time = std::chrono::nanoseconds(0);
+    // Cumulative bytes of the denotations computed on misses.
+    std::size_t num_bytes = 0;
+};
+
+
 /// @brief Encapsulates caches for denotations and provides functionality to
 ///        insert and retrieve denotations into and respectively from the cache.
+///
+/// Building with DLPLAN_INSTRUMENTATION records ElementStatistics for each
+/// evaluated element. Otherwise, the recording compiles away.
+///
+/// Caches constructed as thread-safe can be shared by threads that evaluate
+/// elements concurrently. Threads that race to evaluate the same element on
+/// the same state compute equal denotations and obtain the same cached object.
+///
+/// Caches that are not thread-safe can be bounded by a memory budget. Once
+/// the budget is exceeded, the denotations of states that were not used since
+/// the previous eviction are evicted. If that does not suffice, the
+/// denotations of all states are evicted. Denotations of static elements and
+/// of collections of states, i.e., keys with state -1, are pinned unless
+/// collections are evicted as well.
+///
+/// Thread-safe caches can additionally evaluate elements on collections of
+/// states in parallel, see set_num_threads. The resulting denotations are
+/// identical to the sequential evaluation.
 class DenotationsCaches {
+private:
+    std::size_t m_memory_budget;
+    // Evict only if the number of bytes exceeds this threshold, which is
+    // the budget on top of the pinned denotations if they exceed the budget
+    // and the budget otherwise.
+    std::size_t m_eviction_threshold;
+    bool m_evict_collections;
+    std::size_t m_num_evictions;
+    std::size_t m_num_evicted_entries;
+    int m_evaluation_depth;
+    int m_num_threads;
+#ifdef DLPLAN_INSTRUMENTATION
+    std::vector<ElementStatistics> m_statistics;
+    std::unique_ptr<std::mutex> m_statistics_mutex;
+
+    ElementStatistics& get_statistics(ElementIndex element);
+    void record_miss(ElementIndex element, std::chrono::nanoseconds time, std::size_t num_bytes);
+#endif
+
+    void evict_if_over_budget();
+
 public:
+    /// @brief Marks an evaluation of an element that missed the cache.
+    ///        Eviction only happens when entering the outermost evaluation,
+    ///        because only there no references into the caches are held by
+    ///        the evaluation.
+    class EvaluationScope {
+    private:
+        DenotationsCaches& m_caches;
+#ifdef DLPLAN_INSTRUMENTATION
+        ElementIndex m_element;
+        std::size_t m_num_bytes;
+        std::chrono::steady_clock::time_point m_start;
+#endif
+
+    public:
+        EvaluationScope(DenotationsCaches& caches, [[maybe_unused]] ElementIndex element) : m_caches(caches) {
+            if (m_caches.m_memory_budget > 0 && m_caches.m_evaluation_depth++ == 0) {
+                m_caches.evict_if_over_budget();
+            }
+#ifdef DLPLAN_INSTRUMENTATION
+            m_element = element;
+            m_num_bytes = 0;
+            m_start = std::chrono::steady_clock::now();
+#endif
+        }
+        ~EvaluationScope() {
+            if (m_caches.m_memory_budget > 0) {
+                --m_caches.m_evaluation_depth;
+            }
+#ifdef DLPLAN_INSTRUMENTATION
+            m_caches.record_miss(m_element, std::chrono::steady_clock::now() - m_start, m_num_bytes);
+#endif
+        }
+
+        /// @brief Records the size of the computed denotation.
+        template<typename Denotation>
+        void set_result([[maybe_unused]] const Denotation& denotation) {
+#ifdef DLPLAN_INSTRUMENTATION
+            using dlplan::get_dynamic_memory_usage;
+            m_num_bytes = sizeof(Denotation) + get_dynamic_memory_usage(denotation);
+#endif
+        }
+    };
+
+    /// @brief Records an evaluation of an element that hit the cache.
+    void record_hit([[maybe_unused]] ElementIndex element) {
+#ifdef DLPLAN_INSTRUMENTATION
+        std::unique_lock lock(*m_statistics_mutex, std::defer_lock);
+        if (data.is_thread_safe()) lock.lock();
+        get_statistics(element).num_hits += 1;
+#endif
+    }
 
     DenotationsCaches();
+    explicit DenotationsCaches(bool thread_safe);
     ~DenotationsCaches();
     DenotationsCaches(const DenotationsCaches& other) = delete;
     DenotationsCaches& operator=(const DenotationsCaches& other) = delete;
@@ -240,6 +576,59 @@ public:
         RoleDenotations,
         BooleanDenotations,
         NumericalDenotations> data;
+
+    // Caches the denotations of the static atoms per element and instance
+    // that primitive elements, which are not static, add in every state.
+    // They are no denotations of the elements, hence they are kept apart
+    // from the keys of the elements in data.
+    SharedObjectCache<DenotationsCacheKey,
+        ConceptDenotation,
+        RoleDenotation> static_atom_denotations;
+
+    // Caches the pairwise distances of unique role denotations in data.
+    std::unordered_map<std::shared_ptr<const RoleDenotation>, std::unique_ptr<PairwiseDistances>> pairwise_distances;
+    // Guards pairwise_distances if data is thread-safe.
+    std::unique_ptr<std::mutex> pairwise_distances_mutex;
+    std::size_t pairwise_distances_num_bytes;
+
+    /// @brief Sets the number of bytes above which denotations of states are
+    ///        evicted. A budget of 0 disables eviction, which is the default.
+    ///        Requires caches that are not thread-safe.
+    /// @param evict_collections whether denotations of collections of states
+    ///        are evicted as well, which later evaluations then recompute
+    ///        from the denotations of the children.
+    ///
+    /// Eviction invalidates references obtained from Element::evaluate_ref
+    /// by an earlier evaluation, whereas shared pointers remain valid.
+    /// If the pinned denotations exceed the budget, the denotations of
+    /// states may occupy the budget in addition to them. Eviction copies
+    /// the kept denotations, hence it temporarily occupies their bytes in
+    /// addition to the bytes before the eviction.
+    void set_memory_budget(std::size_t num_bytes, bool evict_collections = false);
+    std::size_t get_memory_budget() const;
+
+    /// @brief Sets the number of threads that evaluate an element on a
+    ///        collection of states. The states are split into ranges that
+    ///        the calling thread and the workers of the default thread pool
+    ///        process concurrently. The default is 1, i.e., sequential.
+    ///        More than 1 thread requires caches that are thread-safe.
+    void set_num_threads(int num_threads);
+    int get_num_threads() const;
+
+    /// @brief Returns the approximate number of bytes of the cached denotations.
+    std::size_t get_num_bytes() const;
+    /// @brief Returns the number of times that denotations were evicted.
+    std::size_t get_num_evictions() const;
+    /// @brief Returns the total number of evicted denotations of elements on states.
+    std::size_t get_num_evicted_entries() const;
+
+    /// @brief Returns whether evaluations record ElementStatistics, which
+    ///        requires building with DLPLAN_INSTRUMENTATION.
+    static bool is_instrumentation_enabled();
+    /// @brief Returns the statistics of all elements that were evaluated
+    ///        with these caches, or nothing without instrumentation.
+    std::unordered_map<ElementIndex, ElementStatistics> get_element_statistics() const;
+    void clear_element_statistics();
 };
 
 
@@ -431,6 +820,10 @@ private:
     std::unordered_map<std::string, ObjectIndex> m_object_name_to_index;
     std::vector<Object> m_objects;
 
+    // Indices of the atoms and static atoms of each predicate.
+    std::vector<AtomIndices> m_atom_indices_by_predicate;
+    std::vector<AtomIndices> m_static_atom_indices_by_predicate;
+
     const Atom& add_atom(PredicateIndex predicate_index, const ObjectIndices& object_indices, bool is_static);
     const Atom& add_atom(const Predicate& predicate, const std::vector<Object>& objects, bool is_static);
     const Atom& add_atom(const std::string& predicate_name, const std::vector<std::string>& object_names, bool is_static);
@@ -473,6 +866,10 @@ public:
     std::shared_ptr<VocabularyInfo> get_vocabulary_info() const;
     const std::vector<Atom>& get_atoms() const;
     const std::vector<Atom>& get_static_atoms() const;
+    /// @brief Returns the indices into get_atoms() of the atoms of the predicate.
+    const AtomIndices& get_atom_indices_of_predicate(PredicateIndex predicate_index) const;
+    /// @brief Returns the indices into get_static_atoms() of the static atoms of the predicate.
+    const AtomIndices& get_static_atom_indices_of_predicate(PredicateIndex predicate_index) const;
     const std::vector<Object>& get_objects() const;
     const Atom& get_atom(const std::string& name) const;
     const Object& get_object(const std::string& name) const;
@@ -485,6 +882,12 @@ class State : public Base<State> {
 private:
     std::shared_ptr<InstanceInfo> m_instance_info;
     AtomIndices m_atom_indices;
+    // The atom indices grouped by predicate, where the atoms of predicate p
+    // are in the range [m_predicate_offsets[p], m_predicate_offsets[p+1]).
+    AtomIndices m_atom_indices_by_predicate;
+    std::vector<int> m_predicate_offsets;
+
+    void compute_atom_indices_by_predicate();
 
 public:
     State(StateIndex index, std::shared_ptr<InstanceInfo> instance_info, const std::vector<Atom>& atoms);
@@ -502,6 +905,50 @@ public:
 
     std::shared_ptr<InstanceInfo> get_instance_info() const;
     const AtomIndices& get_atom_indices() const;
+    /// @brief Returns the indices of the atoms of the predicate in the state.
+    std::span<const AtomIndex> get_atom_indices_of_predicate(PredicateIndex predicate_index) const;
+};
+
+
+/// @brief Describes a state by the atoms that were added to and deleted from
+///        its parent state, e.g., a successor state during search.
+///
+/// While a delta is active on the current thread, elements that miss the
+/// cache on its state derive their denotation from the cached denotation
+/// on the parent state if they can.
+class StateDelta {
+private:
+    const State& m_state;
+    const State& m_parent_state;
+    const AtomIndices& m_added_atoms;
+    const AtomIndices& m_deleted_atoms;
+
+public:
+    /// @brief Activates the delta on the current thread for the lifetime of
+    ///        the scope and restores the previously active delta afterwards.
+    class Scope {
+    private:
+        const StateDelta* m_previous;
+
+    public:
+        explicit Scope(const StateDelta& delta);
+        ~Scope();
+        Scope(const Scope& other) = delete;
+        Scope& operator=(const Scope& other) = delete;
+    };
+
+    StateDelta(const State& state, const State& parent_state, const AtomIndices& added_atoms, const AtomIndices& deleted_atoms);
+
+    /// @brief Returns the delta that is active on the current thread or nullptr.
+    static const StateDelta* get_active();
+
+    /// @brief Returns true iff the delta describes the given state.
+    bool is_delta_of(const State& state) const;
+
+    const State& get_state() const;
+    const State& get_parent_state() const;
+    const AtomIndices& get_added_atoms() const;
+    const AtomIndices& get_deleted_atoms() const;
 };
 
 
@@ -553,7 +1000,45 @@ protected:
     virtual Denotation evaluate_impl(const State& , DenotationsCaches& ) const = 0;
     virtual DenotationList evaluate_impl(const States& , DenotationsCaches& ) const = 0;
 
+    /// @brief Computes the denotation on the state of the delta given the
+    ///        handle of the cached denotation on its parent state.
+    ///        The default recomputes the denotation from scratch.
+    /// @return the handle of the denotation in the caches.
+    virtual ObjectHandle evaluate_delta_impl(const StateDelta& delta, ObjectHandle /*parent_handle*/, DenotationsCaches& caches) const {
+        return caches.data.insert(evaluate_impl(delta.get_state(), caches));
+    }
+
+    /// @brief Compiles the children with the builder and adds the
+    ///        instruction that computes the denotation from their slots.
+    /// @return the slot of the denotation.
+    virtual int compile_impl(EvaluationPlanBuilder& builder) const = 0;
+
+    friend class EvaluationPlanBuilder;
+
+    ObjectHandle evaluate_handle(const State& state, DenotationsCaches& caches) const {
+        auto key = DenotationsCacheKey{ Base<Element<Denotation, DenotationList>>::get_index(), state.get_instance_info()->get_index(), BaseElement<Element<Denotation, DenotationList>>::is_static() ? -1 : state.get_index() };
+        auto handle = caches.data.get_handle<Denotation>(key);
+        if (handle == UNDEFINED_HANDLE) {
+            DenotationsCaches::EvaluationScope scope(caches, key.element);
+            const StateDelta* delta = StateDelta::get_active();
+            ObjectHandle parent_handle = UNDEFINED_HANDLE;
+            if (delta && key.state != -1 && delta->is_delta_of(state)) {
+                parent_handle = caches.data.get_handle<Denotation>(DenotationsCacheKey{ key.element, key.instance, delta->get_parent_state().get_index() });
+            }
+            handle = (parent_handle == UNDEFINED_HANDLE)
+                ? caches.data.insert(evaluate_impl(state, caches))
+                : evaluate_delta_impl(*delta, parent_handle, caches);
+            handle = caches.data.insert_mapping<Denotation>(key, handle);
+            scope.set_result(caches.data.get_object<Denotation>(handle));
+        } else {
+            caches.record_hit(key.element);
+        }
+        return handle;
+    }
+
 public:
+    using denotation_type = Denotation;
+
     virtual ~Element() = default;
 
     virtual bool are_equal_impl(const Element& other) const = 0;
@@ -564,20 +1049,34 @@ public:
 
     virtual Denotation evaluate(const State& ) const = 0;
     std::shared_ptr<const Denotation> evaluate(const State& state, DenotationsCaches& caches) const {
-        auto key = DenotationsCacheKey{ Base<Element<Denotation, DenotationList>>::get_index(), state.get_instance_info()->get_index(), BaseElement<Element<Denotation, DenotationList>>::is_static() ? -1 : state.get_index() };
-        auto cached = caches.data.get<Denotation>(key);
-        if (cached) return cached;
-        auto denotation = caches.data.insert_unique(evaluate_impl(state, caches));
-        caches.data.insert_mapping(key, denotation);
-        return denotation;
+        return caches.data.get_shared<Denotation>(evaluate_handle(state, caches));
+    }
+    /// @brief Returns a reference to the cached denotation that remains valid
+    ///        for the lifetime of the caches. Cheaper than evaluate because
+    ///        it does not share ownership.
+    const Denotation& evaluate_ref(const State& state, DenotationsCaches& caches) const {
+        return caches.data.get_object<Denotation>(evaluate_handle(state, caches));
+    }
+    /// @brief Evaluates the element on a state that results from the parent
+    ///        state by adding and deleting the given atoms. Denotations that
+    ///        are cached on the parent state are reused where possible,
+    ///        hence the parent state should be evaluated with the same caches.
+    std::shared_ptr<const Denotation> evaluate_delta(const State& state, const State& parent_state, const AtomIndices& added_atoms, const AtomIndices& deleted_atoms, DenotationsCaches& caches) const {
+        StateDelta delta(state, parent_state, added_atoms, deleted_atoms);
+        StateDelta::Scope scope(delta);
+        return evaluate(state, caches);
     }
     std::shared_ptr<const DenotationList> evaluate(const States& states, DenotationsCaches& caches) const {
         auto key = DenotationsCacheKey{ Base<Element<Denotation, DenotationList>>::get_index(), -1, -1 };
-        auto cached = caches.data.get<DenotationList>(key);
-        if (cached) return cached;
-        auto result_denotations = caches.data.insert_unique(evaluate_impl(states, caches));
-        caches.data.insert_mapping(key, result_denotations);
-        return result_denotations;
+        auto handle = caches.data.get_handle<DenotationList>(key);
+        if (handle == UNDEFINED_HANDLE) {
+            DenotationsCaches::EvaluationScope scope(caches, key.element);
+            handle = caches.data.insert_mapping<DenotationList>(key, caches.data.insert(evaluate_impl(states, caches)));
+            scope.set_result(caches.data.get_object<DenotationList>(handle));
+        } else {
+            caches.record_hit(key.element);
+        }
+        return caches.data.get_shared<DenotationList>(handle);
     }
 };
 
@@ -596,7 +1095,14 @@ protected:
     virtual Denotation evaluate_impl(const State& , DenotationsCaches& ) const = 0;
     virtual DenotationList evaluate_impl(const States& , DenotationsCaches& ) const = 0;
 
+    /// @brief Compiles the element into an evaluation plan, see Element.
+    virtual int compile_impl(EvaluationPlanBuilder& builder) const = 0;
+
+    friend class EvaluationPlanBuilder;
+
 public:
+    using denotation_type = Denotation;
+
     virtual ~ElementLight() = default;
 
     virtual bool are_equal_impl(const ElementLight& other) const = 0;
@@ -608,21 +1114,36 @@ public:
     virtual Denotation evaluate(const State& ) const = 0;
     Denotation evaluate(const State& state, DenotationsCaches& caches) const {
         auto key = DenotationsCacheKey{ Base<ElementLight<Denotation, DenotationList>>::get_index(), state.get_instance_info()->get_index(), BaseElement<ElementLight<Denotation, DenotationList>>::is_static() ? -1 : state.get_index() };
-        auto cached = caches.data.get<Denotation>(key);
-        // ElementLight dereferences the denotation because it is cheap to copy,
-        // e.g. std::shared_ptr<const int> -> int
-        if (cached) return *cached;  // dereference the cached value
-        auto denotation = caches.data.insert_unique(evaluate_impl(state, caches));
-        caches.data.insert_mapping(key, denotation);
-        return *denotation;  // dereference the newly inserted denoation
+        auto handle = caches.data.get_handle<Denotation>(key);
+        if (handle == UNDEFINED_HANDLE) {
+            DenotationsCaches::EvaluationScope scope(caches, key.element);
+            handle = caches.data.insert_mapping<Denotation>(key, caches.data.insert(evaluate_impl(state, caches)));
+            scope.set_result(caches.data.get_object<Denotation>(handle));
+        } else {
+            caches.record_hit(key.element);
+        }
+        // ElementLight copies the denotation because it is cheap to copy,
+        // e.g. int, hence no shared pointer is needed.
+        return caches.data.get_object<Denotation>(handle);
+    }
+    /// @brief Evaluates the element on a state that results from the parent
+    ///        state by adding and deleting the given atoms, see Element.
+    Denotation evaluate_delta(const State& state, const State& parent_state, const AtomIndices& added_atoms, const AtomIndices& deleted_atoms, DenotationsCaches& caches) const {
+        StateDelta delta(state, parent_state, added_atoms, deleted_atoms);
+        StateDelta::Scope scope(delta);
+        return evaluate(state, caches);
     }
     std::shared_ptr<const DenotationList> evaluate(const States& states, DenotationsCaches& caches) const {
         auto key = DenotationsCacheKey{ Base<ElementLight<Denotation, DenotationList>>::get_index(), -1, -1 };
-        auto cached = caches.data.get<DenotationList>(key);
-        if (cached) return cached;
-        auto result_denotations = caches.data.insert_unique(evaluate_impl(states, caches));
-        caches.data.insert_mapping(key, result_denotations);
-        return result_denotations;
+        auto handle = caches.data.get_handle<DenotationList>(key);
+        if (handle == UNDEFINED_HANDLE) {
+            DenotationsCaches::EvaluationScope scope(caches, key.element);
+            handle = caches.data.insert_mapping<DenotationList>(key, caches.data.insert(evaluate_impl(states, caches)));
+            scope.set_result(caches.data.get_object<DenotationList>(handle));
+        } else {
+            caches.record_hit(key.element);
+        }
+        return caches.data.get_shared<DenotationList>(handle);
     }
 };
 
@@ -644,6 +1165,203 @@ using Boolean = ElementLight<bool, BooleanDenotations>;
 using Numerical = ElementLight<int, NumericalDenotations>;
 
 
+/// @brief Represents an instruction of an evaluation plan that computes the
+///        denotation of an element into a slot of an evaluation frame from
+///        the slots of the denotations of its children.
+struct EvaluationInstruction {
+    using Function = void(*)(const EvaluationInstruction& instruction, const State& state, EvaluationFrame& frame);
+
+    Function function;
+    // The compiled element, which function casts back to its type.
+    const void* element;
+    int result;
+    std::array<int, 3> arguments;
+};
+
+
+/// @brief Flattens the element DAGs of a set of elements into a sequence of
+///        instructions in topological order. Elements shared between the
+///        DAGs are compiled once and each element gets its own slot, such
+///        that an EvaluationFrame can execute the plan on a state without
+///        virtual dispatch and cache lookups.
+///
+/// The instructions of static elements are kept separately because their
+/// denotations only change with the instance.
+class EvaluationPlan {
+private:
+    std::vector<std::shared_ptr<const Boolean>> m_booleans;
+    std::vector<std::shared_ptr<const Numerical>> m_numericals;
+    std::vector<std::shared_ptr<const Concept>> m_concepts;
+    std::vector<std::shared_ptr<const Role>> m_roles;
+
+    std::vector<EvaluationInstruction> m_static_instructions;
+    std::vector<EvaluationInstruction> m_instructions;
+    int m_num_concept_slots;
+    int m_num_role_slots;
+    int m_num_numerical_slots;
+    int m_num_boolean_slots;
+    // Maps each compiled element to the slot of its denotation.
+    std::unordered_map<const void*, int> m_slots;
+
+    int get_slot(const void* element) const;
+
+    friend class EvaluationPlanBuilder;
+    friend class EvaluationFrame;
+
+public:
+    /// @brief Compiles the given elements. The plan keeps them alive.
+    EvaluationPlan(
+        const std::vector<std::shared_ptr<const Boolean>>& booleans,
+        const std::vector<std::shared_ptr<const Numerical>>& numericals,
+        const std::vector<std::shared_ptr<const Concept>>& concepts,
+        const std::vector<std::shared_ptr<const Role>>& roles = {});
+
+    /// @brief Returns the slot of the denotation of a compiled element in
+    ///        the frames of the plan, which callers that evaluate many
+    ///        frames resolve once.
+    int get_slot(const Boolean& boolean) const;
+    int get_slot(const Numerical& numerical) const;
+    int get_slot(const Concept& concept_) const;
+    int get_slot(const Role& role) const;
+
+    /// @brief Returns the number of instructions including the static ones.
+    int get_num_instructions() const;
+    int get_num_static_instructions() const;
+};
+
+
+/// @brief Provides functionality for elements to add their instructions to
+///        an evaluation plan during compilation.
+class EvaluationPlanBuilder {
+private:
+    EvaluationPlan& m_plan;
+
+    explicit EvaluationPlanBuilder(EvaluationPlan& plan);
+
+    template<typename Denotation>
+    int allocate_slot();
+
+    friend class EvaluationPlan;
+
+public:
+    /// @brief Compiles the element unless it was compiled before.
+    /// @return the slot of the denotation of the element.
+    template<typename Denotation, typename DenotationList>
+    int compile(const Element<Denotation, DenotationList>& element);
+    template<typename Denotation, typename DenotationList>
+    int compile(const ElementLight<Denotation, DenotationList>& element);
+
+    /// @brief Adds an instruction that calls function on the element with
+    ///        the slots of the denotations of its children as arguments.
+    /// @return the slot of the denotation of the element.
+    template<typename T>
+    int add_instruction(const T& element, EvaluationInstruction::Function function, std::array<int, 3> arguments = {});
+};
+
+template<typename Denotation>
+int EvaluationPlanBuilder::allocate_slot() {
+    if constexpr (std::is_same_v<Denotation, ConceptDenotation>) {
+        return m_plan.m_num_concept_slots++;
+    } else if constexpr (std::is_same_v<Denotation, RoleDenotation>) {
+        return m_plan.m_num_role_slots++;
+    } else if constexpr (std::is_same_v<Denotation, int>) {
+        return m_plan.m_num_numerical_slots++;
+    } else {
+        static_assert(std::is_same_v<Denotation, bool>, "EvaluationPlanBuilder::allocate_slot - unknown denotation type.");
+        return m_plan.m_num_boolean_slots++;
+    }
+}
+
+template<typename Denotation, typename DenotationList>
+int EvaluationPlanBuilder::compile(const Element<Denotation, DenotationList>& element) {
+    auto result = m_plan.m_slots.find(&element);
+    if (result != m_plan.m_slots.end()) {
+        return result->second;
+    }
+    int slot = element.compile_impl(*this);
+    m_plan.m_slots.emplace(&element, slot);
+    return slot;
+}
+
+template<typename Denotation, typename DenotationList>
+int EvaluationPlanBuilder::compile(const ElementLight<Denotation, DenotationList>& element) {
+    auto result = m_plan.m_slots.find(&element);
+    if (result != m_plan.m_slots.end()) {
+        return result->second;
+    }
+    int slot = element.compile_impl(*this);
+    m_plan.m_slots.emplace(&element, slot);
+    return slot;
+}
+
+template<typename T>
+int EvaluationPlanBuilder::add_instruction(const T& element, EvaluationInstruction::Function function, std::array<int, 3> arguments) {
+    int slot = allocate_slot<typename T::denotation_type>();
+    auto& instructions = element.is_static() ? m_plan.m_static_instructions : m_plan.m_instructions;
+    instructions.push_back(EvaluationInstruction{ function, &element, slot, arguments });
+    return slot;
+}
+
+
+/// @brief Holds preallocated denotations for the slots of an evaluation
+///        plan and executes the plan on states.
+///
+/// The denotations are only reallocated when the number of objects changes,
+/// hence evaluating states of the same instance does not allocate memory
+/// except for elements that need auxiliary sets, e.g., concept distances.
+/// The pairwise distances of role distances are kept in the frame alike.
+/// A frame is not thread-safe but any number of frames can share a plan.
+class EvaluationFrame {
+private:
+    std::shared_ptr<const EvaluationPlan> m_plan;
+    // The static slots hold the denotations on this instance.
+    std::shared_ptr<InstanceInfo> m_instance_info;
+    int m_num_objects;
+
+    std::vector<ConceptDenotation> m_concept_denotations;
+    std::vector<RoleDenotation> m_role_denotations;
+    std::vector<int> m_numerical_denotations;
+    std::vector<char> m_boolean_denotations;
+    // Scratch distances by the numerical slot of the instruction that uses
+    // them, created on first use.
+    std::vector<std::unique_ptr<PairwiseDistances>> m_pairwise_distances;
+
+public:
+    explicit EvaluationFrame(std::shared_ptr<const EvaluationPlan> plan);
+    EvaluationFrame(EvaluationFrame&& other);
+    EvaluationFrame& operator=(EvaluationFrame&& other);
+    ~EvaluationFrame();
+
+    /// @brief Executes the plan on the state. The denotations remain valid
+    ///        until the next call.
+    void evaluate(const State& state);
+
+    /* Access to the slots for the instructions. */
+    ConceptDenotation& get_concept_denotation(int slot) { return m_concept_denotations[slot]; }
+    const ConceptDenotation& get_concept_denotation(int slot) const { return m_concept_denotations[slot]; }
+    RoleDenotation& get_role_denotation(int slot) { return m_role_denotations[slot]; }
+    const RoleDenotation& get_role_denotation(int slot) const { return m_role_denotations[slot]; }
+    int get_numerical_denotation(int slot) const { return m_numerical_denotations[slot]; }
+    void set_numerical_denotation(int slot, int value) { m_numerical_denotations[slot] = value; }
+    bool get_boolean_denotation(int slot) const { return m_boolean_denotations[slot]; }
+    void set_boolean_denotation(int slot, bool value) { m_boolean_denotations[slot] = value; }
+    /// @brief Returns the scratch distances of the instruction with the
+    ///        given numerical slot, reset to the edges. Their buffers are
+    ///        reused as long as the number of objects does not change.
+    PairwiseDistances& get_pairwise_distances(int slot, const RoleDenotation& edges);
+
+    /// @brief Returns the denotation of an element of the plan on the
+    ///        last evaluated state. Looks up the slot of the element, see
+    ///        EvaluationPlan::get_slot to avoid the lookup.
+    bool get_denotation(const Boolean& boolean) const;
+    int get_denotation(const Numerical& numerical) const;
+    const ConceptDenotation& get_denotation(const Concept& concept_) const;
+    const RoleDenotation& get_denotation(const Role& role) const;
+
+    std::shared_ptr<const EvaluationPlan> get_plan() const;
+};
+
+
 /// @brief Provides functionality for the syntactically unique creation of elements.
 class SyntacticElementFactory {
 private:
@@ -32,8 +32,8 @@ private:
     evaluate_impl(const State& state, DenotationsCaches& caches) const override {
         bool denotation;
         compute_result(
-                *m_element_left->evaluate(state, caches),
-                *m_element_right->evaluate(state, caches),
+                m_element_left->evaluate_ref(state, caches),
+                m_element_right->evaluate_ref(state, caches),
                 denotation);
         return denotation;
     }
@@ -42,18 +42,34 @@ private:
     evaluate_impl(const States& states, DenotationsCaches& caches) const override {
         BooleanDenotations denotations;
         auto element_left_denotations = m_element_left->evaluate(states, caches);
-        auto element_right_denotations = m_element_left->evaluate(states, caches);
+        auto element_right_denotations = m_element_right->evaluate(states, caches);
         for (size_t i = 0; i < states.size(); ++i) {
-            bool denotation;
-            compute_result(
-                *(*element_left_denotations)[i],
-                *(*element_right_denotations)[i],
-                denotation);
-            denotations.push_back(denotation);
+            denotations.push_back(element_left_denotations->is_subset_of(i, *element_right_denotations));
         }
         return denotations;
     }
 
+    int compile_impl(EvaluationPlanBuilder& builder) const override {
+        return builder.add_instruction(*this, &InclusionBoolean::execute, {builder.compile(*m_element_left), builder.compile(*m_element_right)});
+    }
+
+    static const typename T::denotation_type& get_element_denotation(EvaluationFrame& frame, int slot) {
+        if constexpr (std::is_same_v<T, Concept>) {
+            return frame.get_concept_denotation(slot);
+        } else {
+            return frame.get_role_denotation(slot);
+        }
+    }
+
+    static void execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+        bool denotation;
+        static_cast<const InclusionBoolean*>(instruction.element)->compute_result(
+            get_element_denotation(frame, instruction.arguments[0]),
+            get_element_denotation(frame, instruction.arguments[1]),
+            denotation);
+        frame.set_boolean_denotation(instruction.result, denotation);
+    }
+
     InclusionBoolean(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const T> element_left, std::shared_ptr<const T> element_right)
     : Boolean(index, vocabulary_info, element_left->is_static() && element_right->is_static()),
       m_element_left(element_left),
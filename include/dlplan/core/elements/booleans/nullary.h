@@ -28,6 +28,10 @@ private:
     BooleanDenotations
     evaluate_impl(const States& states, DenotationsCaches&) const override;
 
+    int compile_impl(EvaluationPlanBuilder& builder) const override;
+
+    static void execute(const EvaluationInstruction& instruction, const State& state, EvaluationFrame& frame);
+
     NullaryBoolean(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, const Predicate& predicate);
 
     template<typename... Ts>
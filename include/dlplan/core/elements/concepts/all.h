@@ -28,6 +28,10 @@ private:
 
     ConceptDenotations evaluate_impl(const States& states, DenotationsCaches& caches) const override;
 
+    int compile_impl(EvaluationPlanBuilder& builder) const override;
+
+    static void execute(const EvaluationInstruction& instruction, const State& state, EvaluationFrame& frame);
+
     AllConcept(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Role> role, std::shared_ptr<const Concept> concept_);
 
     template<typename... Ts>
@@ -28,6 +28,12 @@ private:
 
     ConceptDenotations evaluate_impl(const States& states, DenotationsCaches& caches) const override;
 
+    ObjectHandle evaluate_delta_impl(const StateDelta& delta, ObjectHandle parent_handle, DenotationsCaches& caches) const override;
+
+    int compile_impl(EvaluationPlanBuilder& builder) const override;
+
+    static void execute(const EvaluationInstruction& instruction, const State& state, EvaluationFrame& frame);
+
     DiffConcept(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Concept> concept_1, std::shared_ptr<const Concept> concept_2);
     template<typename... Ts>
     friend class dlplan::ReferenceCountedObjectFactory;
@@ -23,12 +23,23 @@ private:
     const Predicate m_predicate;
     const int m_pos;
 
+    void insert_objects(const std::vector<Atom>& atoms, std::span<const AtomIndex> atom_indices, ConceptDenotation& result) const;
+    /// @brief Adds the objects of the static atoms, which are precomputed
+    ///        once per instance in the caches.
+    void insert_static_objects(const InstanceInfo& instance_info, ConceptDenotation& result, DenotationsCaches& caches) const;
+
     void compute_result(const State& state, ConceptDenotation& result) const;
 
-    ConceptDenotation evaluate_impl(const State& state, DenotationsCaches&) const override;
+    ConceptDenotation evaluate_impl(const State& state, DenotationsCaches& caches) const override;
 
     ConceptDenotations evaluate_impl(const States& states, DenotationsCaches& caches) const override;
 
+    ObjectHandle evaluate_delta_impl(const StateDelta& delta, ObjectHandle parent_handle, DenotationsCaches& caches) const override;
+
+    int compile_impl(EvaluationPlanBuilder& builder) const override;
+
+    static void execute(const EvaluationInstruction& instruction, const State& state, EvaluationFrame& frame);
+
     PrimitiveConcept(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, const Predicate& predicate, int pos);
 
     template<typename... Ts>
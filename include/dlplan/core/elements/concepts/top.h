@@ -23,6 +23,10 @@ private:
 
     ConceptDenotations evaluate_impl(const States& states, DenotationsCaches& caches) const override;
 
+    int compile_impl(EvaluationPlanBuilder& builder) const override;
+
+    static void execute(const EvaluationInstruction& instruction, const State& state, EvaluationFrame& frame);
+
     TopConcept(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info);
 
     template<typename... Ts>
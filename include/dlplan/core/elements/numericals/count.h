@@ -37,7 +37,7 @@ private:
     int evaluate_impl(const State& state, DenotationsCaches& caches) const override {
         int denotation;
         compute_result(
-            *m_element->evaluate(state, caches),
+            m_element->evaluate_ref(state, caches),
             denotation);
         return denotation;
     }
@@ -47,15 +47,31 @@ private:
         denotations.reserve(states.size());
         auto element_denotations = m_element->evaluate(states, caches);
         for (size_t i = 0; i < states.size(); ++i) {
-            int denotation;
-            compute_result(
-                *(*element_denotations)[i],
-                denotation);
-            denotations.push_back(denotation);
+            denotations.push_back(element_denotations->count(i));
         }
         return denotations;
     }
 
+    int compile_impl(EvaluationPlanBuilder& builder) const override {
+        return builder.add_instruction(*this, &CountNumerical::execute, {builder.compile(*m_element)});
+    }
+
+    static const typename T::denotation_type& get_element_denotation(EvaluationFrame& frame, int slot) {
+        if constexpr (std::is_same_v<T, Concept>) {
+            return frame.get_concept_denotation(slot);
+        } else {
+            return frame.get_role_denotation(slot);
+        }
+    }
+
+    static void execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+        int denotation;
+        static_cast<const CountNumerical*>(instruction.element)->compute_result(
+            get_element_denotation(frame, instruction.arguments[0]),
+            denotation);
+        frame.set_numerical_denotation(instruction.result, denotation);
+    }
+
     CountNumerical(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const T> element)
         : Numerical(index, vocabulary_info, element->is_static()), m_element(element) { }
 
@@ -23,12 +23,16 @@ private:
     const std::shared_ptr<const Role> m_role;
     const std::shared_ptr<const Role> m_role_to;
 
-    void compute_result(const RoleDenotation& role_from_denot, const RoleDenotation& role_denot, const RoleDenotation& role_to_denot, int& result) const;
+    void compute_result(const RoleDenotation& role_from_denot, PairwiseDistances& pairwise_distances, const RoleDenotation& role_to_denot, int& result) const;
 
     int evaluate_impl(const State& state, DenotationsCaches& caches) const override;
 
     NumericalDenotations evaluate_impl(const States& states, DenotationsCaches& caches) const override;
 
+    int compile_impl(EvaluationPlanBuilder& builder) const override;
+
+    static void execute(const EvaluationInstruction& instruction, const State& state, EvaluationFrame& frame);
+
     SumRoleDistanceNumerical(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Role> role_from, std::shared_ptr<const Role> role, std::shared_ptr<const Role> role_to);
 
     template<typename... Ts>
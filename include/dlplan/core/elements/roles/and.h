@@ -27,6 +27,12 @@ private:
     RoleDenotation evaluate_impl(const State& state, DenotationsCaches& caches) const override;
 
     RoleDenotations evaluate_impl(const States& states, DenotationsCaches& caches) const override;
+
+    ObjectHandle evaluate_delta_impl(const StateDelta& delta, ObjectHandle parent_handle, DenotationsCaches& caches) const override;
+
+    int compile_impl(EvaluationPlanBuilder& builder) const override;
+
+    static void execute(const EvaluationInstruction& instruction, const State& state, EvaluationFrame& frame);
     AndRole(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Role> role_1, std::shared_ptr<const Role> role_2);
 
     template<typename... Ts>
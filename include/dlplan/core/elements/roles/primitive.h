@@ -21,12 +21,23 @@ private:
     const int m_pos_1;
     const int m_pos_2;
 
+    void insert_pairs(const std::vector<Atom>& atoms, std::span<const AtomIndex> atom_indices, RoleDenotation& result) const;
+    /// @brief Adds the pairs of the static atoms, which are precomputed
+    ///        once per instance in the caches.
+    void insert_static_pairs(const InstanceInfo& instance_info, RoleDenotation& result, DenotationsCaches& caches) const;
+
     void compute_result(const State& state, RoleDenotation& result) const;
 
-    RoleDenotation evaluate_impl(const State& state, DenotationsCaches&) const override;
+    RoleDenotation evaluate_impl(const State& state, DenotationsCaches& caches) const override;
 
     RoleDenotations evaluate_impl(const States& states, DenotationsCaches& caches) const override;
 
+    ObjectHandle evaluate_delta_impl(const StateDelta& delta, ObjectHandle parent_handle, DenotationsCaches& caches) const override;
+
+    int compile_impl(EvaluationPlanBuilder& builder) const override;
+
+    static void execute(const EvaluationInstruction& instruction, const State& state, EvaluationFrame& frame);
+
     PrimitiveRole(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, const Predicate& predicate, int pos_1, int pos_2);
 
     template<typename... Ts>
@@ -3,6 +3,9 @@
 
 #include "../../core.h"
 
+#include <functional>
+#include <mutex>
+
 
 const int SCORE_CONSTANT = 1;
 const int SCORE_LINEAR = 100;
@@ -11,18 +14,104 @@ const int SCORE_QUBIC = SCORE_LINEAR * SCORE_LINEAR * SCORE_LINEAR;
 
 const int INF = std::numeric_limits<int>::max();
 
+namespace dlplan::core {
+
+/// @brief Shortest distances between pairs of objects in the graph of a role
+///        denotation. The distances from a source are computed with a BFS
+///        over bit rows the first time that they are requested, hence only
+///        the sources that are actually relevant are explored.
+class PairwiseDistances {
+private:
+    // The edges must outlive this object.
+    const RoleDenotation* m_edges;
+    int m_num_objects;
+    // Row-major distances from each source to each target.
+    std::vector<int> m_distances;
+    ConceptDenotation m_computed_sources;
+    // Scratch sets of the BFS, which the lock covers as well.
+    ConceptDenotation m_visited;
+    ConceptDenotation m_frontier;
+    ConceptDenotation m_next;
+    bool m_thread_safe;
+    std::mutex m_mutex;
+
+public:
+    explicit PairwiseDistances(const RoleDenotation& edges, bool thread_safe = false);
+
+    /// @brief Computes the distances of other edges from now on. Keeps the
+    ///        buffers if the number of objects is the same and then only
+    ///        resets the rows that were computed before.
+    void reset(const RoleDenotation& edges);
+
+    /// @brief Returns a pointer to the distances from source to each object.
+    const int* get_distances_from(ObjectIndex source);
+};
+
+}
+
+
 namespace dlplan::core::utils {
 
 using Distances = std::vector<int>;
-using PairwiseDistances = std::vector<Distances>;
 
 extern int path_addition(int a, int b);
 
 extern int compute_multi_source_multi_target_shortest_distance(const ConceptDenotation& sources, const RoleDenotation& edges, const ConceptDenotation& targets);
 
+/// @brief Returns the distances from the closest source for each object, but
+///        stops the search once all targets are reached. Hence only the
+///        entries of the targets are meaningful, whereas other objects may
+///        be at distance INF although they are reachable.
 extern Distances compute_multi_source_multi_target_shortest_distances(const ConceptDenotation& sources, const RoleDenotation& edges, const ConceptDenotation& targets);
 
-extern PairwiseDistances compute_floyd_warshall(const RoleDenotation& edges);
+/// @brief Returns the pairwise distances of a role denotation that is stored
+///        in caches. Since cached denotations are unique, all states that
+///        share the role denotation share the pairwise distances.
+extern PairwiseDistances& get_pairwise_distances(const std::shared_ptr<const RoleDenotation>& edges, DenotationsCaches& caches);
+
+/// @brief Calls body(begin, end) on consecutive ranges that partition the
+///        indices of the states. If the caches allow more than one thread,
+///        then the ranges are processed concurrently in an arbitrary order.
+///        Hence, the body must keep its scratch denotations local and write
+///        only to the rows of the result in its range.
+extern void for_each_state_range(const States& states, const DenotationsCaches& caches, const std::function<void(std::size_t, std::size_t)>& body);
+
+/// @brief Returns true iff the left argument precedes the right one in the
+///        canonical order of the arguments of commutative elements. Unlike
+///        indices, the order does not depend on the order of creation,
+///        hence elements created concurrently have the same representation.
+template<typename Derived>
+bool is_canonically_ordered(const Base<Derived>& left, const Base<Derived>& right) {
+    return left.str() < right.str();
+}
+
+/// @brief Returns true iff the element has the same denotation on the state
+///        of the delta and on its parent state. Cached denotations are
+///        unique, hence it suffices to compare their addresses.
+template<typename Denotation, typename DenotationList>
+bool is_unchanged(const Element<Denotation, DenotationList>& element, const StateDelta& delta, DenotationsCaches& caches) {
+    return &element.evaluate_ref(delta.get_state(), caches) == &element.evaluate_ref(delta.get_parent_state(), caches);
+}
+
+/// @brief Extends the relation to its transitive closure in place
+///        using Warshall's algorithm over bit rows in O(n^3/64).
+extern void compute_transitive_closure(RoleDenotation& relation);
+
+/// @brief Adds the composition {(a,c) | (a,b) in left and (b,c) in right}
+///        to result. Selects between the two methods below depending on
+///        the density of left.
+extern void compute_composition(const RoleDenotation& left, const RoleDenotation& right, RoleDenotation& result);
+
+/// @brief Boolean matrix product that unites the rows of right selected by
+///        each row of left, blocked over the middle index for cache reuse.
+///        Takes O(|left| * n/64) word operations.
+extern void compute_composition_by_rows(const RoleDenotation& left, const RoleDenotation& right, RoleDenotation& result);
+
+/// @brief Boolean matrix product with the method of Four Russians that
+///        precomputes the unions of all subsets of each group of 8 rows of
+///        right. Takes O(n/8 * (256 + n) * n/64) word operations
+///        independently of the density of left.
+extern void compute_composition_four_russians(const RoleDenotation& left, const RoleDenotation& right, RoleDenotation& result);
 
 }
 
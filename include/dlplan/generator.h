@@ -4,6 +4,9 @@
 #ifndef DLPLAN_INCLUDE_DLPLAN_GENERATOR_H_
 #define DLPLAN_INCLUDE_DLPLAN_GENERATOR_H_
 
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 #include <tuple>
@@ -21,6 +24,26 @@ using GeneratedFeatures = std::tuple<
     std::vector<std::shared_ptr<const core::Concept>>,
     std::vector<std::shared_ptr<const core::Role>>
 >;
+/// @brief Receives a feature as soon as the generator admits it, together
+///        with its denotations on the states and its complexity. Returning
+///        false stops the generation.
+template<typename Element, typename Denotations>
+using FeatureCallback = std::function<bool(const std::shared_ptr<const Element>&, const std::shared_ptr<const Denotations>&, int)>;
+
+/// @brief Lets any thread request that a running generation stops after
+///        its current candidate. Copies share the request.
+class CancellationToken {
+private:
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+
+public:
+    CancellationToken();
+
+    void cancel();
+    bool is_cancelled() const;
+    /// @brief Withdraws the request such that the token can be reused.
+    void reset();
+};
 
 /// @brief Provides functionality for automatically generating state features
 ///        that are distinguishable on a finite set of states.
@@ -47,6 +70,103 @@ public:
         int time_limit=3600,
         int feature_limit=10000);
 
+    /// @brief Continues an interrupted generation from the checkpoint file
+    ///        at the complexity after the last completed layer. Generates
+    ///        from scratch if the checkpoint file does not exist yet.
+    ///        Throws if the checkpoint was written for other states,
+    ///        complexity limits, enabled rules, fingerprint, probe or
+    ///        incremental settings, or if an element has other denotations.
+    GeneratedFeatures resume(
+        core::SyntacticElementFactory& factory,
+        const core::States& states,
+        int concept_complexity_limit=9,
+        int role_complexity_limit=9,
+        int boolean_complexity_limit=9,
+        int count_numerical_complexity_limit=9,
+        int distance_numerical_complexity_limit=9,
+        int time_limit=3600,
+        int feature_limit=10000);
+
+    /// @brief Adds the states to the sample of the last generation, which
+    ///        must have been incremental, and returns its features together
+    ///        with the dropped duplicates that the additional states
+    ///        distinguish from them, in the order of generation. Evaluates
+    ///        the elements on the additional states only and enumerates no
+    ///        new compositions, in particular none of the readmitted
+    ///        features. The factory of the last generation must be alive.
+    ///        Passes the features to the callbacks like generate, in the
+    ///        order of generation, and does not screen on probe states.
+    ///        Cancellation, SIGINT and the limits stop it like generate.
+    ///        A generation or extension that stopped early is not
+    ///        extended later, but the last complete extension is.
+    GeneratedFeatures extend(const core::States& states);
+
+    /// @brief Sets the number of threads that generate the candidates of a
+    ///        complexity layer concurrently. The generated features are the
+    ///        same for every number of threads.
+    /// @param num_threads A positive number of threads, 1 by default.
+    void set_num_threads(int num_threads);
+
+    /// @brief Detects features with equal denotations by 128-bit
+    ///        fingerprints of the denotations instead of the denotations
+    ///        themselves, such that no denotations on the states are kept.
+    ///        Each task of a rule then evaluates its candidates in caches
+    ///        of its own, which recompute the denotations of the composed
+    ///        elements and are released when the task completes. With a
+    ///        memory limit, the caches of a task evict denotations once
+    ///        they exceed the limit divided by twice the number of threads,
+    ///        which bounds them at the expense of recomputation. Matching
+    ///        fingerprints are confirmed by reevaluation, hence the
+    ///        generated features do not change. This trades time for memory.
+    void set_use_fingerprints(bool enable);
+
+    /// @brief Evaluates each candidate on a diverse subset of the states
+    ///        first and drops it without evaluating it on all states if a
+    ///        generated feature has the same denotations on the subset.
+    ///        This is approximate: a dropped candidate may differ from all
+    ///        generated features on other states. The generated features
+    ///        still have pairwise different denotations on all states.
+    /// @param num_probe_states The size of the subset. 0, the default,
+    ///        disables probing, and so does any size of at least the
+    ///        number of states.
+    void set_num_probe_states(int num_probe_states);
+    /// @brief Keeps the sample and all elements that generate constructs,
+    ///        including the duplicates that it drops, such that extend can
+    ///        add states later. Candidates dropped on probe states are not
+    ///        kept. Disabled by default since it requires more memory.
+    void set_incremental(bool enable);
+    /// @brief Sets the token that stops the generation when cancelled. The
+    ///        generation then returns the features admitted so far. SIGINT
+    ///        stops the running generation alike but leaves the token as is.
+    void set_cancellation_token(CancellationToken token);
+    /// @brief Stops the generation like a cancellation once the cached
+    ///        denotations occupy more than the given number of bytes. 0,
+    ///        the default, disables the limit. The caches of a task count
+    ///        once the task completes.
+    void set_memory_limit(std::size_t num_bytes);
+    /// @brief Returns the largest number of bytes that the cached
+    ///        denotations occupied during the last generation, including
+    ///        the caches of a task when it completes.
+    std::size_t get_peak_num_bytes() const;
+
+    /// @brief Sets the callbacks that receive the generated features in the
+    ///        order of generation, including the features restored from a
+    ///        checkpoint. If a callback returns false, the generation stops
+    ///        and returns the features that were admitted so far.
+    void set_boolean_callback(FeatureCallback<core::Boolean, core::BooleanDenotations> callback);
+    void set_numerical_callback(FeatureCallback<core::Numerical, core::NumericalDenotations> callback);
+    void set_concept_callback(FeatureCallback<core::Concept, core::ConceptDenotations> callback);
+    void set_role_callback(FeatureCallback<core::Role, core::RoleDenotations> callback);
+
+    /// @brief Sets the file to which the generated features, the
+    ///        fingerprints of their denotations and the rule statistics
+    ///        are written after each completed complexity
+    ///        layer, and from which resume reads them. An incremental
+    ///        generator also writes the dropped duplicates in the order of
+    ///        generation, such that a resumed generation can be extended.
+    ///        An empty filename, the default, disables checkpoints.
+    void set_checkpoint_file(const std::string& filename);
+
     void set_generate_empty_boolean(bool enable);
     void set_generate_inclusion_boolean(bool enable);
     void set_generate_nullary_boolean(bool enable);
@@ -111,7 +231,7 @@ extern GeneratedFeatures generate_features(
     bool generate_concept_distance_numerical=true,
     bool generate_count_numerical=true,
     bool generate_and_role=true,
-    bool generate_compose_role=false,
+    bool generate_compose_role=true,
     bool generate_diff_role=false,
     bool generate_identity_role=false,
     bool generate_inverse_role=true,
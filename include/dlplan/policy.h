@@ -5,6 +5,7 @@
 
 #include <unordered_set>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <vector>
@@ -22,6 +23,8 @@ class BaseCondition;
 class BaseEffect;
 class Rule;
 class Policy;
+class PolicyEvaluationPlan;
+class PolicyEvaluationFrames;
 class PolicyFactory;
 class BaseConditionVisitor;
 class BaseEffectVisitor;
@@ -241,6 +244,17 @@ public:
     std::shared_ptr<const Rule> evaluate_effects(const core::State& source_state, const core::State& target_state, const std::vector<std::shared_ptr<const Rule>>& rules) const;
     std::shared_ptr<const Rule> evaluate_effects(const core::State& source_state, const core::State& target_state, const std::vector<std::shared_ptr<const Rule>>& rules, core::DenotationsCaches& caches) const;
 
+    /**
+     * Approach 3: evaluate with a compiled evaluation plan of the features instead of caches, e.g.,
+     *   PolicyEvaluationFrames frames(policy.compile_evaluation_plan());
+     *   policy.evaluate(source_state, target_state, frames);
+     * The frames must hold a plan of this policy.
+     */
+    std::shared_ptr<const PolicyEvaluationPlan> compile_evaluation_plan() const;
+    std::shared_ptr<const Rule> evaluate(const core::State& source_state, const core::State& target_state, PolicyEvaluationFrames& frames) const;
+    std::vector<std::shared_ptr<const Rule>> evaluate_conditions(const core::State& source_state, PolicyEvaluationFrames& frames) const;
+    std::shared_ptr<const Rule> evaluate_effects(const core::State& source_state, const core::State& target_state, const std::vector<std::shared_ptr<const Rule>>& rules, PolicyEvaluationFrames& frames) const;
+
     const Booleans& get_booleans() const;
     const Numericals& get_numericals() const;
     const Concepts& get_concepts() const;
@@ -248,6 +262,89 @@ public:
 };
 
 
+/// @brief Compiles the features of a policy into a core::EvaluationPlan and
+///        resolves the conditions and effects of its rules to the slots of
+///        their features in the plan. Hence, evaluating the rules on frames
+///        of the plan requires neither virtual dispatch nor lookups.
+///        A plan can be shared by any number of PolicyEvaluationFrames.
+class PolicyEvaluationPlan {
+public:
+    enum class ConditionType {
+        POSITIVE_BOOLEAN, NEGATIVE_BOOLEAN,
+        GREATER_NUMERICAL, EQUAL_NUMERICAL,
+        GREATER_CONCEPT, EQUAL_CONCEPT
+    };
+
+    enum class EffectType {
+        POSITIVE_BOOLEAN, NEGATIVE_BOOLEAN, UNCHANGED_BOOLEAN,
+        INCREMENT_NUMERICAL, INCREMENT_OR_UNCHANGED_NUMERICAL, DECREMENT_NUMERICAL,
+        DECREMENT_OR_UNCHANGED_NUMERICAL, UNCHANGED_NUMERICAL, GREATER_NUMERICAL, EQUAL_NUMERICAL,
+        INCREMENT_CONCEPT, DECREMENT_CONCEPT, UNCHANGED_CONCEPT, GREATER_CONCEPT, EQUAL_CONCEPT
+    };
+
+    /// @brief A condition or effect with the slot of its feature.
+    template<typename Type>
+    struct CompiledFeature {
+        Type type;
+        int slot;
+    };
+
+    struct CompiledRule {
+        std::shared_ptr<const Rule> rule;
+        std::vector<CompiledFeature<ConditionType>> conditions;
+        std::vector<CompiledFeature<EffectType>> effects;
+    };
+
+private:
+    int m_policy_index;
+    std::shared_ptr<const core::EvaluationPlan> m_plan;
+    // The rules in the order of the policy.
+    std::vector<CompiledRule> m_rules;
+    // Maps the index of a rule to its position in m_rules or -1.
+    std::vector<int> m_rule_positions;
+
+public:
+    explicit PolicyEvaluationPlan(const Policy& policy);
+
+    /// @brief Returns the compiled rule or nullptr if the rule is not in the policy.
+    const CompiledRule* get_rule(const Rule& rule) const;
+    const std::vector<CompiledRule>& get_rules() const;
+    const std::shared_ptr<const core::EvaluationPlan>& get_plan() const;
+    int get_policy_index() const;
+
+    /// @brief Returns whether the conditions of the rule hold on the
+    ///        denotations in the frame of the source state.
+    static bool evaluate_conditions(const CompiledRule& rule, const core::EvaluationFrame& source_frame);
+    /// @brief Returns whether the effects of the rule hold on the
+    ///        denotations in the frames of the source and target state.
+    static bool evaluate_effects(const CompiledRule& rule, const core::EvaluationFrame& source_frame, const core::EvaluationFrame& target_frame);
+};
+
+
+/// @brief Holds the frames of a PolicyEvaluationPlan for the source and the
+///        target state and serves as the backend of Policy::evaluate that
+///        executes the plan instead of evaluating the elements. The source
+///        frame is only evaluated again if the source state changes, as in
+///        evaluating (s,s1), (s,s2), ..., (s,sn). The frames are not thread-safe.
+class PolicyEvaluationFrames {
+private:
+    std::shared_ptr<const PolicyEvaluationPlan> m_plan;
+    core::EvaluationFrame m_source_frame;
+    core::EvaluationFrame m_target_frame;
+    std::optional<core::State> m_source_state;
+
+public:
+    explicit PolicyEvaluationFrames(std::shared_ptr<const PolicyEvaluationPlan> plan);
+
+    /// @brief Executes the plan on the source state unless the source frame holds it.
+    const core::EvaluationFrame& evaluate_source(const core::State& source_state);
+    /// @brief Executes the plan on the target state.
+    const core::EvaluationFrame& evaluate_target(const core::State& target_state);
+
+    const std::shared_ptr<const PolicyEvaluationPlan>& get_plan() const;
+};
+
+
 /// @brief Provides functionality for the syntactically unique creation of
 ///        conditions, effects, rules, and policies.
 class PolicyFactory {
@@ -0,0 +1,61 @@
+/// @brief Provides word-level kernels for the bitset operations that
+///        underlie concept and role denotations.
+
+#ifndef DLPLAN_INCLUDE_DLPLAN_UTILS_BITSET_KERNELS_H_
+#define DLPLAN_INCLUDE_DLPLAN_UTILS_BITSET_KERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace dlplan::kernels {
+
+using Block = std::uint64_t;
+
+/// @brief The instruction set that a set of kernels is compiled for.
+///
+/// SCALAR is portable C++ and always available. The remaining variants
+/// are only available on x86-64 and are selected at runtime if the
+/// executing CPU supports the respective instructions.
+enum class KernelVariant {
+    SCALAR,
+    POPCNT,
+    AVX2,
+    AVX512
+};
+
+/// @brief A table of kernels operating on arrays of num_blocks 64-bit blocks.
+///
+/// The in-place operations store their result in the first argument.
+struct BitsetKernels {
+    KernelVariant variant;
+    void (*bitwise_and)(Block* dst, const Block* src, std::size_t num_blocks);
+    void (*bitwise_or)(Block* dst, const Block* src, std::size_t num_blocks);
+    void (*bitwise_and_not)(Block* dst, const Block* src, std::size_t num_blocks);
+    void (*bitwise_not)(Block* dst, std::size_t num_blocks);
+    bool (*intersects)(const Block* left, const Block* right, std::size_t num_blocks);
+    bool (*is_subset_of)(const Block* left, const Block* right, std::size_t num_blocks);
+    bool (*equal)(const Block* left, const Block* right, std::size_t num_blocks);
+    bool (*none)(const Block* data, std::size_t num_blocks);
+    std::size_t (*count)(const Block* data, std::size_t num_blocks);
+};
+
+/// @brief Returns the fastest kernels supported by the executing CPU.
+///        The selection is performed once on first use.
+extern const BitsetKernels& get_kernels();
+
+/// @brief Returns the kernels of the given variant or nullptr if the
+///        executing CPU or the compiler does not support it.
+extern const BitsetKernels* get_kernels(KernelVariant variant);
+
+/// @brief Returns all variants that are supported by the executing CPU
+///        in ascending order of preference.
+extern std::vector<KernelVariant> get_supported_variants();
+
+extern std::string to_string(KernelVariant variant);
+
+}
+
+#endif
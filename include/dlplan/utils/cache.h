@@ -18,78 +18,496 @@
 #ifndef DLPLAN_INCLUDE_DLPLAN_UTILS_UNIQUE_FACTORY_HPP_
 #define DLPLAN_INCLUDE_DLPLAN_UTILS_UNIQUE_FACTORY_HPP_
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <utility>
 #include <unordered_map>
 #include <unordered_set>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <iostream>
+#include <stdexcept>
 #include <tuple>
 #include <vector>
 #include <cassert>
 
 
 namespace dlplan {
+/// @brief Dense index of an object in a SharedObjectCache.
+using ObjectHandle = std::uint32_t;
+
+static constexpr ObjectHandle UNDEFINED_HANDLE = std::numeric_limits<ObjectHandle>::max();
+
+/// @brief Returns the number of bytes that the object owns on the heap.
+///        Types that own heap memory provide an overload in their namespace.
+template<typename T>
+std::size_t get_dynamic_memory_usage(const T&) {
+    return 0;
+}
+
+template<typename T>
+std::size_t get_dynamic_memory_usage(const std::vector<T>& vec) {
+    return vec.capacity() * sizeof(T);
+}
+
+inline std::size_t get_dynamic_memory_usage(const std::vector<bool>& vec) {
+    return vec.capacity() / 8;
+}
+
+/// @brief Stores objects contiguously in chunks of doubling size and
+///        addresses them by dense 32-bit handles.
+///
+/// Chunks are never reallocated, hence references to objects remain
+/// valid for the lifetime of the arena. Shared pointers to objects share
+/// ownership of the chunk that contains them. Reading objects whose handle
+/// was obtained under a lock is safe concurrently with push_back, but
+/// push_back itself must be serialized by the caller.
+template<typename T>
+class ObjectArena {
+private:
+    static constexpr std::size_t first_chunk_size = 16;
+    // enough chunks to address all handles
+    static constexpr std::size_t max_num_chunks = 28;
+
+    // Wraps the object such that std::vector<bool> is not specialized.
+    struct Slot {
+        T value;
+        std::size_t hash;
+    };
+
+    std::array<std::shared_ptr<std::vector<Slot>>, max_num_chunks> m_chunks;
+    std::size_t m_num_chunks;
+    std::atomic<std::size_t> m_size;
+
+    static std::pair<std::size_t, std::size_t> locate(ObjectHandle handle) {
+        // chunk c holds the handles in [16 * (2^c - 1), 16 * (2^(c+1) - 1))
+        std::size_t chunk = std::bit_width(handle / first_chunk_size + 1) - 1;
+        std::size_t offset = handle - first_chunk_size * ((std::size_t(1) << chunk) - 1);
+        return { chunk, offset };
+    }
+
+    const Slot& get_slot(ObjectHandle handle) const {
+        assert(handle < m_size.load(std::memory_order_relaxed));
+        auto [chunk, offset] = locate(handle);
+        return m_chunks[chunk]->data()[offset];
+    }
+
+public:
+    ObjectArena() : m_num_chunks(0), m_size(0) { }
+
+    ObjectHandle push_back(T&& object, std::size_t hash) {
+        std::size_t size = m_size.load(std::memory_order_relaxed);
+        if (size == UNDEFINED_HANDLE) {
+            throw std::runtime_error("ObjectArena::push_back - number of objects exceeds the range of handles.");
+        }
+        if (m_num_chunks == 0 || m_chunks[m_num_chunks - 1]->size() == m_chunks[m_num_chunks - 1]->capacity()) {
+            auto chunk = std::make_shared<std::vector<Slot>>();
+            chunk->reserve(first_chunk_size << m_num_chunks);
+            m_chunks[m_num_chunks++] = std::move(chunk);
+        }
+        m_chunks[m_num_chunks - 1]->push_back(Slot{ std::move(object), hash });
+        m_size.store(size + 1, std::memory_order_release);
+        return static_cast<ObjectHandle>(size);
+    }
+
+    const T& operator[](ObjectHandle handle) const {
+        return get_slot(handle).value;
+    }
+
+    std::size_t get_hash(ObjectHandle handle) const {
+        return get_slot(handle).hash;
+    }
+
+    std::shared_ptr<const T> share(ObjectHandle handle) const {
+        auto [chunk, offset] = locate(handle);
+        return std::shared_ptr<const T>(m_chunks[chunk], &get_slot(handle).value);
+    }
+
+    std::size_t size() const {
+        return m_size.load(std::memory_order_acquire);
+    }
+
+    /// @brief Returns the number of bytes that an object occupies in the arena.
+    static constexpr std::size_t get_slot_size() {
+        return sizeof(Slot);
+    }
+};
+
+
+/// @brief Deduplicates objects by value and maps keys to the unique objects.
+///
+/// Unique objects are stored in an ObjectArena per type. The tables from
+/// values and keys to handles use open addressing with linear probing over
+/// flat arrays, which avoids a node allocation per entry.
+///
+/// The tables are split into shards by hash. If the cache is constructed as
+/// thread-safe, each shard is guarded by a reader-writer lock such that
+/// lookups in different shards and concurrent lookups in the same shard do
+/// not block each other. Threads that race to insert equal objects or the
+/// same key obtain the same handle, namely the one of the first insertion.
+///
+/// Each key remembers the generation in which it was inserted or, if usage
+/// tracking is enabled, last looked up. Eviction removes the keys of older
+/// generations and compacts the arenas, which invalidates all handles.
 template<typename Key, typename... Ts>
 class SharedObjectCache {
 private:
-    // @brief Hashing of the underlying object.
-    template<typename T>
-    struct ValueHash {
-        std::size_t operator()(const std::shared_ptr<const T>& ptr) const {
-            return std::hash<T>()(*ptr);
-        }
+    static constexpr std::size_t num_shards = 16;
+
+    struct MappingSlot {
+        Key key;
+        ObjectHandle handle;
+        // Written on lookups, which only hold a shared lock if usage
+        // tracking is enabled, and that requires a single thread.
+        mutable std::uint32_t generation;
     };
 
-    /// @brief Equality comparison of the objects underlying the pointers.
-    template<typename T>
-    struct ValueEqual {
-        bool operator()(const std::shared_ptr<const T>& left, const std::shared_ptr<const T>& right) const {
-            return *left == *right;
-        }
+    // Open addressing table of handles of objects by value.
+    struct UniqueShard {
+        mutable std::shared_mutex mutex;
+        std::vector<ObjectHandle> slots;
+        std::size_t size = 0;
+    };
+
+    // Open addressing table from keys to handles of objects.
+    struct MappingShard {
+        mutable std::shared_mutex mutex;
+        std::vector<MappingSlot> slots;
+        std::size_t size = 0;
     };
 
     template<typename T>
     struct PerTypeCache {
-        std::unordered_set<std::shared_ptr<const T>, ValueHash<T>, ValueEqual<T>> unique;
-        std::unordered_map<Key, std::shared_ptr<const T>> mapping;
+        std::mutex objects_mutex;
+        ObjectArena<T> objects;
+        std::array<UniqueShard, num_shards> unique;
+        std::array<MappingShard, num_shards> mapping;
+        // Bytes of the objects and of the tables.
+        std::atomic<std::size_t> num_bytes = 0;
     };
 
-    std::tuple<PerTypeCache<Ts>...> m_cache;
+    // Behind pointers because mutexes are not movable.
+    std::tuple<std::unique_ptr<PerTypeCache<Ts>>...> m_cache;
+    bool m_thread_safe;
+    bool m_track_usage;
+    std::uint32_t m_generation;
+
+    template<typename T>
+    PerTypeCache<T>& get_cache() const {
+        return *std::get<std::unique_ptr<PerTypeCache<T>>>(m_cache);
+    }
+
+    /// @brief Fibonacci hashing to spread weak hashes over the table.
+    static std::size_t compute_slot(std::size_t hash, std::size_t capacity) {
+        return (hash * 0x9E3779B97F4A7C15ull) >> (64 - std::countr_zero(capacity));
+    }
+
+    static std::size_t compute_shard(std::size_t hash) {
+        return (hash ^ (hash >> 32)) % num_shards;
+    }
+
+    template<typename T>
+    static ObjectHandle find_unique(const PerTypeCache<T>& t_cache, const UniqueShard& shard, const T& object, std::size_t hash) {
+        if (shard.slots.empty()) {
+            return UNDEFINED_HANDLE;
+        }
+        std::size_t mask = shard.slots.size() - 1;
+        std::size_t slot = compute_slot(hash, shard.slots.size());
+        while (shard.slots[slot] != UNDEFINED_HANDLE) {
+            ObjectHandle handle = shard.slots[slot];
+            if (t_cache.objects.get_hash(handle) == hash && t_cache.objects[handle] == object) {
+                return handle;
+            }
+            slot = (slot + 1) & mask;
+        }
+        return UNDEFINED_HANDLE;
+    }
+
+    template<typename T>
+    static void insert_unique_slot(const PerTypeCache<T>& t_cache, UniqueShard& shard, ObjectHandle handle) {
+        std::size_t mask = shard.slots.size() - 1;
+        std::size_t slot = compute_slot(t_cache.objects.get_hash(handle), shard.slots.size());
+        while (shard.slots[slot] != UNDEFINED_HANDLE) {
+            slot = (slot + 1) & mask;
+        }
+        shard.slots[slot] = handle;
+    }
+
+    template<typename T>
+    static void grow_unique(PerTypeCache<T>& t_cache, UniqueShard& shard) {
+        std::vector<ObjectHandle> old_slots(std::max<std::size_t>(16, 2 * shard.slots.size()), UNDEFINED_HANDLE);
+        std::swap(old_slots, shard.slots);
+        t_cache.num_bytes += (shard.slots.size() - old_slots.size()) * sizeof(ObjectHandle);
+        for (ObjectHandle handle : old_slots) {
+            if (handle != UNDEFINED_HANDLE) {
+                insert_unique_slot(t_cache, shard, handle);
+            }
+        }
+    }
+
+    /// @brief Moves a new object into the arena and the table of unique objects.
+    ///        The caller must hold the lock of the shard.
+    template<typename T>
+    ObjectHandle insert_new_unique(PerTypeCache<T>& t_cache, UniqueShard& shard, T&& object, std::size_t hash) {
+        std::size_t num_bytes = ObjectArena<T>::get_slot_size() + get_dynamic_memory_usage(object);
+        ObjectHandle handle;
+        {
+            std::unique_lock objects_lock(t_cache.objects_mutex, std::defer_lock);
+            if (m_thread_safe) objects_lock.lock();
+            handle = t_cache.objects.push_back(std::move(object), hash);
+        }
+        t_cache.num_bytes += num_bytes;
+        // keep the load factor at most 1/2
+        if (2 * (shard.size + 1) > shard.slots.size()) {
+            grow_unique(t_cache, shard);
+        }
+        insert_unique_slot(t_cache, shard, handle);
+        ++shard.size;
+        return handle;
+    }
+
+    static const MappingSlot* find_mapping(const MappingShard& shard, const Key& key, std::size_t hash) {
+        if (shard.slots.empty()) {
+            return nullptr;
+        }
+        std::size_t mask = shard.slots.size() - 1;
+        std::size_t slot = compute_slot(hash, shard.slots.size());
+        while (shard.slots[slot].handle != UNDEFINED_HANDLE) {
+            if (shard.slots[slot].key == key) {
+                return &shard.slots[slot];
+            }
+            slot = (slot + 1) & mask;
+        }
+        return nullptr;
+    }
+
+    static void insert_mapping_slot(MappingShard& shard, const MappingSlot& entry) {
+        std::size_t mask = shard.slots.size() - 1;
+        std::size_t slot = compute_slot(std::hash<Key>()(entry.key), shard.slots.size());
+        while (shard.slots[slot].handle != UNDEFINED_HANDLE) {
+            slot = (slot + 1) & mask;
+        }
+        shard.slots[slot] = entry;
+    }
+
+    template<typename T>
+    static void insert_new_mapping(PerTypeCache<T>& t_cache, MappingShard& shard, const MappingSlot& entry) {
+        // keep the load factor at most 3/4
+        if (4 * (shard.size + 1) > 3 * shard.slots.size()) {
+            std::vector<MappingSlot> old_slots(std::max<std::size_t>(16, 2 * shard.slots.size()), MappingSlot{ Key(), UNDEFINED_HANDLE, 0 });
+            std::swap(old_slots, shard.slots);
+            t_cache.num_bytes += (shard.slots.size() - old_slots.size()) * sizeof(MappingSlot);
+            for (const auto& slot : old_slots) {
+                if (slot.handle != UNDEFINED_HANDLE) {
+                    insert_mapping_slot(shard, slot);
+                }
+            }
+        }
+        insert_mapping_slot(shard, entry);
+        ++shard.size;
+    }
+
+    /// @brief Rebuilds the cache of type T with the keys that are pinned or
+    ///        were used in the current generation and the objects they map to.
+    template<typename T, typename IsPinned>
+    std::size_t evict_type(const IsPinned& is_pinned) {
+        auto& old_cache = get_cache<T>();
+        auto new_cache = std::make_unique<PerTypeCache<T>>();
+        std::vector<ObjectHandle> remapping(old_cache.objects.size(), UNDEFINED_HANDLE);
+        std::size_t num_evicted = 0;
+        for (const auto& old_shard : old_cache.mapping) {
+            for (const auto& entry : old_shard.slots) {
+                if (entry.handle == UNDEFINED_HANDLE) {
+                    continue;
+                }
+                if (entry.generation != m_generation && !is_pinned(entry.key)) {
+                    ++num_evicted;
+                    continue;
+                }
+                ObjectHandle& handle = remapping[entry.handle];
+                if (handle == UNDEFINED_HANDLE) {
+                    // copy because shared pointers may still refer to the old object
+                    std::size_t hash = old_cache.objects.get_hash(entry.handle);
+                    handle = insert_new_unique(*new_cache, new_cache->unique[compute_shard(hash)], T(old_cache.objects[entry.handle]), hash);
+                }
+                std::size_t hash = std::hash<Key>()(entry.key);
+                insert_new_mapping(*new_cache, new_cache->mapping[compute_shard(hash)], MappingSlot{ entry.key, handle, entry.generation });
+            }
+        }
+        std::get<std::unique_ptr<PerTypeCache<T>>>(m_cache) = std::move(new_cache);
+        return num_evicted;
+    }
+
+    template<typename T, typename IsPinned>
+    std::size_t get_num_pinned_bytes_type(const IsPinned& is_pinned) const {
+        const auto& t_cache = get_cache<T>();
+        std::vector<bool> is_counted(t_cache.objects.size(), false);
+        std::size_t num_bytes = 0;
+        for (const auto& shard : t_cache.mapping) {
+            for (const auto& entry : shard.slots) {
+                if (entry.handle == UNDEFINED_HANDLE || !is_pinned(entry.key)) {
+                    continue;
+                }
+                num_bytes += sizeof(MappingSlot);
+                if (!is_counted[entry.handle]) {
+                    is_counted[entry.handle] = true;
+                    num_bytes += ObjectArena<T>::get_slot_size() + get_dynamic_memory_usage(t_cache.objects[entry.handle]);
+                }
+            }
+        }
+        return num_bytes;
+    }
 
 public:
-    SharedObjectCache()  { }
+    /// @param thread_safe whether the cache can be shared across threads.
+    explicit SharedObjectCache(bool thread_safe = false)
+        : m_cache(std::make_unique<PerTypeCache<Ts>>()...),
+          m_thread_safe(thread_safe),
+          m_track_usage(false),
+          m_generation(0) { }
+
+    bool is_thread_safe() const {
+        return m_thread_safe;
+    }
+
+    /// @brief Enables that lookups move keys into the current generation.
+    ///        Requires a cache that is not thread-safe.
+    void set_track_usage(bool track_usage) {
+        if (track_usage && m_thread_safe) {
+            throw std::runtime_error("SharedObjectCache::set_track_usage - usage tracking requires a cache that is not thread-safe.");
+        }
+        m_track_usage = track_usage;
+    }
+
+    /// @brief Returns the handle of the object mapped to by the key
+    ///        or UNDEFINED_HANDLE if there is none.
+    template<typename T>
+    ObjectHandle get_handle(const Key& key) const {
+        std::size_t hash = std::hash<Key>()(key);
+        const auto& shard = get_cache<T>().mapping[compute_shard(hash)];
+        std::shared_lock lock(shard.mutex, std::defer_lock);
+        if (m_thread_safe) lock.lock();
+        const MappingSlot* entry = find_mapping(shard, key, hash);
+        if (!entry) {
+            return UNDEFINED_HANDLE;
+        }
+        if (m_track_usage) {
+            entry->generation = m_generation;
+        }
+        return entry->handle;
+    }
 
     template<typename T>
     std::shared_ptr<const T> get(const Key& key) const {
-        auto& t_mapping = std::get<PerTypeCache<T>>(m_cache).mapping;
-        auto it = t_mapping.find(key);
-        if (it == t_mapping.end()) {
+        ObjectHandle handle = get_handle<T>(key);
+        if (handle == UNDEFINED_HANDLE) {
             return nullptr;
         }
-        return it->second;
+        return get_shared<T>(handle);
+    }
+
+    /// @brief Returns a reference to the object that remains valid for
+    ///        the lifetime of the cache or until the next eviction.
+    template<typename T>
+    const T& get_object(ObjectHandle handle) const {
+        return get_cache<T>().objects[handle];
+    }
+
+    template<typename T>
+    std::shared_ptr<const T> get_shared(ObjectHandle handle) const {
+        return get_cache<T>().objects.share(handle);
+    }
+
+    /// @brief Maps the key to the handle unless the key is already mapped.
+    /// @return the handle that the key is mapped to after the call.
+    template<typename T>
+    ObjectHandle insert_mapping(const Key& key, ObjectHandle handle) {
+        auto& t_cache = get_cache<T>();
+        std::size_t hash = std::hash<Key>()(key);
+        auto& shard = t_cache.mapping[compute_shard(hash)];
+        std::unique_lock lock(shard.mutex, std::defer_lock);
+        if (m_thread_safe) lock.lock();
+        const MappingSlot* entry = find_mapping(shard, key, hash);
+        if (entry) {
+            return entry->handle;
+        }
+        insert_new_mapping(t_cache, shard, MappingSlot{ key, handle, m_generation });
+        return handle;
     }
 
+    /// @brief Returns the handle of the unique object equal to the given
+    ///        object. The object is only moved into the cache if there is none.
     template<typename T>
-    void insert_mapping(const Key& key, std::shared_ptr<const T>& element) {
-        auto& t_cache = std::get<PerTypeCache<T>>(m_cache);
-        auto& t_mapping = t_cache.mapping;
-        if (get<T>(key)) {
-            throw std::runtime_error("Must call get first before insertion.");
+    ObjectHandle insert(T&& object) {
+        auto& t_cache = get_cache<T>();
+        std::size_t hash = std::hash<T>()(object);
+        auto& shard = t_cache.unique[compute_shard(hash)];
+        if (m_thread_safe) {
+            // optimistic lookup that does not block other readers
+            std::shared_lock lock(shard.mutex);
+            ObjectHandle handle = find_unique(t_cache, shard, object, hash);
+            if (handle != UNDEFINED_HANDLE) {
+                return handle;
+            }
         }
-        t_mapping.emplace(key, element);
+        std::unique_lock lock(shard.mutex, std::defer_lock);
+        if (m_thread_safe) lock.lock();
+        ObjectHandle handle = find_unique(t_cache, shard, object, hash);
+        if (handle != UNDEFINED_HANDLE) {
+            return handle;
+        }
+        return insert_new_unique(t_cache, shard, std::move(object), hash);
     }
 
     template<typename T>
     std::shared_ptr<const T> insert_unique(T&& object) {
-        auto& t_cache = std::get<PerTypeCache<T>>(m_cache);
-        auto& t_unique = t_cache.unique;
-        auto result = t_unique.insert(std::make_shared<T>(std::move(object)));
-        return *result.first;
+        return get_shared<T>(insert(std::move(object)));
+    }
+
+    /// @brief Removes all keys that are not pinned and were not used in the
+    ///        current generation, together with the objects that only they
+    ///        map to, and starts a new generation. Invalidates all handles
+    ///        and references, whereas shared pointers remain valid.
+    ///        Must not be called concurrently with other operations.
+    ///
+    /// The kept objects are copied into new arenas, because shared pointers
+    /// may still refer to the old ones. Hence, the cache temporarily
+    /// occupies the bytes of the old objects plus those of the kept ones.
+    /// @return the number of removed keys.
+    template<typename IsPinned>
+    std::size_t evict(const IsPinned& is_pinned) {
+        std::size_t num_evicted = (evict_type<Ts>(is_pinned) + ...);
+        ++m_generation;
+        return num_evicted;
+    }
+
+    /// @brief Returns the number of unique objects of the given type.
+    template<typename T>
+    std::size_t size() const {
+        return get_cache<T>().objects.size();
+    }
+
+    /// @brief Returns the approximate number of bytes of the objects and tables.
+    std::size_t get_num_bytes() const {
+        return (get_cache<Ts>().num_bytes.load(std::memory_order_relaxed) + ...);
+    }
+
+    /// @brief Returns the approximate number of bytes of the pinned keys
+    ///        and the objects they map to, i.e., of what eviction keeps at
+    ///        least. Must not be called concurrently with other operations.
+    template<typename IsPinned>
+    std::size_t get_num_pinned_bytes(const IsPinned& is_pinned) const {
+        return (get_num_pinned_bytes_type<Ts>(is_pinned) + ...);
     }
 };
 
 }
 
 
-#endif
\ No newline at end of file
+#endif
@@ -2,24 +2,112 @@
 #define DLPLAN_INCLUDE_DLPLAN_UTILS_DYNAMIC_BITSET_H
 
 #include "hash.h"
+#include "bitset_kernels.h"
 
+#include <boost/container/small_vector.hpp>
+
+#include <algorithm>
+#include <bit>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <limits>
+#include <type_traits>
 #include <vector>
 
 
 /*
   Poor man's version of boost::dynamic_bitset, mostly copied from there.
+
+  With 64-bit blocks, operations on bitsets with more than
+  kernel_threshold blocks are delegated to the runtime-dispatched
+  kernels in bitset_kernels.h. Smaller bitsets, e.g., concept denotations
+  of instances with few objects, are handled inline to avoid the
+  indirect call.
 */
 namespace dlplan {
 
-template<typename Block = unsigned int>
+/// @brief Forward iterator over the positions of the set bits in ascending order.
+///
+/// Skips zero blocks and extracts the positions within a block with
+/// count-trailing-zeros, hence iterating over k set bits in a bitset
+/// with b blocks takes O(b + k) time without allocation.
+template<typename Block>
+class DynamicBitsetConstIterator {
+    static const int bits_per_block = std::numeric_limits<Block>::digits;
+
+private:
+    const Block* m_blocks;
+    std::size_t m_num_blocks;
+    std::size_t m_block_index;
+    // The remaining set bits of the current block.
+    Block m_current;
+
+    void advance_to_nonzero_block() {
+        while (m_current == 0) {
+            if (++m_block_index >= m_num_blocks) {
+                m_block_index = m_num_blocks;
+                return;
+            }
+            m_current = m_blocks[m_block_index];
+        }
+    }
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::size_t*;
+    using reference = std::size_t;
+
+    DynamicBitsetConstIterator() : m_blocks(nullptr), m_num_blocks(0), m_block_index(0), m_current(0) { }
+
+    DynamicBitsetConstIterator(const Block* blocks, std::size_t num_blocks, bool at_begin)
+        : m_blocks(blocks), m_num_blocks(num_blocks), m_block_index(num_blocks), m_current(0) {
+        if (at_begin && num_blocks > 0) {
+            m_block_index = 0;
+            m_current = m_blocks[0];
+            advance_to_nonzero_block();
+        }
+    }
+
+    std::size_t operator*() const {
+        return m_block_index * bits_per_block + std::countr_zero(m_current);
+    }
+
+    DynamicBitsetConstIterator& operator++() {
+        // clear the lowest set bit
+        m_current &= m_current - 1;
+        advance_to_nonzero_block();
+        return *this;
+    }
+
+    DynamicBitsetConstIterator operator++(int) {
+        DynamicBitsetConstIterator prev = *this;
+        ++(*this);
+        return prev;
+    }
+
+    bool operator==(const DynamicBitsetConstIterator& other) const {
+        return m_block_index == other.m_block_index && m_current == other.m_current;
+    }
+
+    bool operator!=(const DynamicBitsetConstIterator& other) const {
+        return !(*this == other);
+    }
+};
+
+
+/// @brief A bitset whose size is fixed at construction. Up to InlineBlocks
+///        blocks are stored inline, larger bitsets fall back to the heap.
+template<typename Block = std::uint64_t, std::size_t InlineBlocks = 1>
 class DynamicBitset {
     static_assert(
         !std::numeric_limits<Block>::is_signed,
         "Block type must be unsigned");
 
-    std::vector<Block> blocks;
+    boost::container::small_vector<Block, InlineBlocks> blocks;
     std::size_t num_bits;
 
     static const Block zeros;
@@ -27,6 +115,13 @@ class DynamicBitset {
 
     static const int bits_per_block = std::numeric_limits<Block>::digits;
 
+    static constexpr bool use_kernels = std::is_same_v<Block, kernels::Block>;
+    static constexpr std::size_t kernel_threshold = 4;
+
+    bool dispatch() const {
+        return use_kernels && blocks.size() > kernel_threshold;
+    }
+
     static int compute_num_blocks(std::size_t num_bits) {
         return num_bits / bits_per_block +
                static_cast<int>(num_bits % bits_per_block != 0);
@@ -58,9 +153,11 @@ class DynamicBitset {
     }
 
     /// @brief Constructor for serialization.
-    //DynamicBitset() : blocks(std::vector<Block>()), num_bits(0) { }
+    //DynamicBitset() : blocks(), num_bits(0) { }
 
 public:
+    using const_iterator = DynamicBitsetConstIterator<Block>;
+
     explicit DynamicBitset(std::size_t num_bits)
         : blocks(compute_num_blocks(num_bits), zeros),
           num_bits(num_bits) {
@@ -70,21 +167,47 @@ public:
         return num_bits;
     }
 
+    std::size_t num_blocks() const {
+        return blocks.size();
+    }
+
+    /// @brief Returns the number of bytes of the blocks that are not stored inline.
+    std::size_t get_dynamic_memory_usage() const {
+        return blocks.capacity() > InlineBlocks ? blocks.capacity() * sizeof(Block) : 0;
+    }
+
+    /// @brief Direct access to the underlying blocks, e.g., to operate on
+    ///        word-aligned subranges. Bits beyond size() must remain zero.
+    const Block* data() const {
+        return blocks.data();
+    }
+
+    Block* data() {
+        return blocks.data();
+    }
+
     /*
       Count the number of set bits.
-
-      The computation could be made faster by using a more sophisticated
-      algorithm (see https://en.wikipedia.org/wiki/Hamming_weight).
     */
     int count() const {
+        if constexpr (use_kernels) {
+            if (dispatch()) {
+                return kernels::get_kernels().count(blocks.data(), blocks.size());
+            }
+        }
         int result = 0;
-        for (std::size_t pos = 0; pos < num_bits; ++pos) {
-            result += static_cast<int>(test(pos));
+        for (std::size_t i = 0; i < blocks.size(); ++i) {
+            result += std::popcount(blocks[i]);
         }
         return result;
     }
 
     bool none() const {
+        if constexpr (use_kernels) {
+            if (dispatch()) {
+                return kernels::get_kernels().none(blocks.data(), blocks.size());
+            }
+        }
         for (std::size_t i = 0; i < blocks.size(); ++i) {
             if (blocks[i]) return false;
         }
@@ -120,10 +243,18 @@ public:
     }
 
     bool operator==(const DynamicBitset& other) const {
-        if (this != &other) {
-            return (blocks == other.blocks) && (num_bits == other.num_bits);
+        if (this == &other) {
+            return true;
         }
-        return true;
+        if (num_bits != other.num_bits) {
+            return false;
+        }
+        if constexpr (use_kernels) {
+            if (dispatch()) {
+                return kernels::get_kernels().equal(blocks.data(), other.blocks.data(), blocks.size());
+            }
+        }
+        return blocks == other.blocks;
     }
 
     bool operator!=(const DynamicBitset& other) const {
@@ -132,6 +263,12 @@ public:
 
     DynamicBitset& operator&=(const DynamicBitset& other) {
         assert(size() == other.size());
+        if constexpr (use_kernels) {
+            if (dispatch()) {
+                kernels::get_kernels().bitwise_and(blocks.data(), other.blocks.data(), blocks.size());
+                return *this;
+            }
+        }
         for (std::size_t i = 0; i < blocks.size(); ++i) {
             blocks[i] &= other.blocks[i];
         }
@@ -140,6 +277,12 @@ public:
 
     DynamicBitset& operator|=(const DynamicBitset& other) {
         assert(size() == other.size());
+        if constexpr (use_kernels) {
+            if (dispatch()) {
+                kernels::get_kernels().bitwise_or(blocks.data(), other.blocks.data(), blocks.size());
+                return *this;
+            }
+        }
         for (std::size_t i = 0; i < blocks.size(); ++i) {
             blocks[i] |= other.blocks[i];
         }
@@ -148,6 +291,12 @@ public:
 
     DynamicBitset& operator-=(const DynamicBitset& other) {
         assert(size() == other.size());
+        if constexpr (use_kernels) {
+            if (dispatch()) {
+                kernels::get_kernels().bitwise_and_not(blocks.data(), other.blocks.data(), blocks.size());
+                return *this;
+            }
+        }
         for (std::size_t i = 0; i < blocks.size(); ++i) {
             blocks[i] = blocks[i] & ~other.blocks[i];
         }
@@ -155,6 +304,13 @@ public:
     }
 
     DynamicBitset& operator~() {
+        if constexpr (use_kernels) {
+            if (dispatch()) {
+                kernels::get_kernels().bitwise_not(blocks.data(), blocks.size());
+                zero_unused_bits();
+                return *this;
+            }
+        }
         for (std::size_t i = 0; i < blocks.size(); ++i) {
             blocks[i] = ~blocks[i];
         }
@@ -164,6 +320,11 @@ public:
 
     bool intersects(const DynamicBitset &other) const {
         assert(size() == other.size());
+        if constexpr (use_kernels) {
+            if (dispatch()) {
+                return kernels::get_kernels().intersects(blocks.data(), other.blocks.data(), blocks.size());
+            }
+        }
         for (std::size_t i = 0; i < blocks.size(); ++i) {
             if (blocks[i] & other.blocks[i])
                 return true;
@@ -173,6 +334,11 @@ public:
 
     bool is_subset_of(const DynamicBitset &other) const {
         assert(size() == other.size());
+        if constexpr (use_kernels) {
+            if (dispatch()) {
+                return kernels::get_kernels().is_subset_of(blocks.data(), other.blocks.data(), blocks.size());
+            }
+        }
         for (std::size_t i = 0; i < blocks.size(); ++i) {
             if (blocks[i] & ~other.blocks[i])
                 return false;
@@ -180,16 +346,29 @@ public:
         return true;
     }
 
+    const_iterator begin() const {
+        return const_iterator(blocks.data(), blocks.size(), true);
+    }
+
+    const_iterator end() const {
+        return const_iterator(blocks.data(), blocks.size(), false);
+    }
+
     std::size_t hash() const {
-        return hash_vector(blocks);
+        // same as hash_vector
+        std::size_t aggregated_hash = 0;
+        for (const auto& block : blocks) {
+            hash_combine(aggregated_hash, std::hash<Block>()(block));
+        }
+        return aggregated_hash;
     }
 };
 
-template<typename Block>
-const Block DynamicBitset<Block>::zeros = Block(0);
+template<typename Block, std::size_t InlineBlocks>
+const Block DynamicBitset<Block, InlineBlocks>::zeros = Block(0);
 
-template<typename Block>
-const Block DynamicBitset<Block>::ones = ~DynamicBitset<Block>::zeros;
+template<typename Block, std::size_t InlineBlocks>
+const Block DynamicBitset<Block, InlineBlocks>::ones = ~DynamicBitset<Block, InlineBlocks>::zeros;
 }
 
 
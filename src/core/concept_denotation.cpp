@@ -7,13 +7,14 @@
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
 
+#include <bit>
 #include <sstream>
 
 
 namespace dlplan::core {
 // we assign index undefined since we do not care
 ConceptDenotation::ConceptDenotation(int num_objects)
-    : Base<ConceptDenotation>(std::numeric_limits<int>::max()), m_num_objects(num_objects), m_data(DynamicBitset<unsigned>(num_objects)) { }
+    : Base<ConceptDenotation>(std::numeric_limits<int>::max()), m_num_objects(num_objects), m_data(DynamicBitset<std::uint64_t>(num_objects)) { }
 
 ConceptDenotation::ConceptDenotation(const ConceptDenotation& other) = default;
 
@@ -63,6 +64,36 @@ ConceptDenotation& ConceptDenotation::operator~() {
     return *this;
 }
 
+ConceptDenotation& ConceptDenotation::operator&=(const ConceptDenotationView& other) {
+    assert(m_num_objects == other.get_num_objects());
+    std::uint64_t* blocks = m_data.data();
+    const std::uint64_t* other_blocks = other.data();
+    for (int i = 0; i < other.get_num_blocks(); ++i) {
+        blocks[i] &= other_blocks[i];
+    }
+    return *this;
+}
+
+ConceptDenotation& ConceptDenotation::operator|=(const ConceptDenotationView& other) {
+    assert(m_num_objects == other.get_num_objects());
+    std::uint64_t* blocks = m_data.data();
+    const std::uint64_t* other_blocks = other.data();
+    for (int i = 0; i < other.get_num_blocks(); ++i) {
+        blocks[i] |= other_blocks[i];
+    }
+    return *this;
+}
+
+ConceptDenotation& ConceptDenotation::operator-=(const ConceptDenotationView& other) {
+    assert(m_num_objects == other.get_num_objects());
+    std::uint64_t* blocks = m_data.data();
+    const std::uint64_t* other_blocks = other.data();
+    for (int i = 0; i < other.get_num_blocks(); ++i) {
+        blocks[i] &= ~other_blocks[i];
+    }
+    return *this;
+}
+
 bool ConceptDenotation::contains(ObjectIndex value) const {
     assert(value >= 0 && value < m_num_objects);
     return m_data.test(value);
@@ -72,6 +103,10 @@ void ConceptDenotation::set() {
     m_data.set();
 }
 
+void ConceptDenotation::clear() {
+    m_data.reset();
+}
+
 void ConceptDenotation::insert(ObjectIndex value) {
     assert(value >= 0 && value < m_num_objects);
     m_data.set(value);
@@ -98,6 +133,14 @@ bool ConceptDenotation::is_subset_of(const ConceptDenotation& other) const {
     return m_data.is_subset_of(other.m_data);
 }
 
+bool ConceptDenotation::intersects(const ConceptDenotationView& other) const {
+    return ConceptDenotationView(*this).intersects(other);
+}
+
+bool ConceptDenotation::is_subset_of(const ConceptDenotationView& other) const {
+    return ConceptDenotationView(*this).is_subset_of(other);
+}
+
 ObjectIndices ConceptDenotation::to_vector() const {
     // In the case of bitset, the to_sorted_vector has best runtime complexity.
     return to_sorted_vector();
@@ -105,13 +148,10 @@ ObjectIndices ConceptDenotation::to_vector() const {
 
 ObjectIndices ConceptDenotation::to_sorted_vector() const {
     ObjectIndices result;
-    result.reserve(m_num_objects);
-    for (ObjectIndex i = 0; i < m_num_objects; ++i) {
-        if (m_data.test(i)) {
-            result.push_back(i);
-        }
+    result.reserve(size());
+    for (const auto& value : *this) {
+        result.push_back(value);
     }
-    result.shrink_to_fit();
     return result;
 }
 
@@ -119,4 +159,47 @@ int ConceptDenotation::get_num_objects() const {
     return m_num_objects;
 }
 
+std::size_t ConceptDenotation::get_dynamic_memory_usage() const {
+    return m_data.get_dynamic_memory_usage();
+}
+
+
+
+ConceptDenotationView::ConceptDenotationView(const std::uint64_t* blocks, int num_objects)
+    : m_blocks(blocks), m_num_objects(num_objects), m_num_blocks((num_objects + 63) / 64) { }
+
+ConceptDenotationView::ConceptDenotationView(const ConceptDenotation& denotation)
+    : ConceptDenotationView(denotation.m_data.data(), denotation.m_num_objects) { }
+
+int ConceptDenotationView::size() const {
+    int result = 0;
+    for (int i = 0; i < m_num_blocks; ++i) {
+        result += std::popcount(m_blocks[i]);
+    }
+    return result;
+}
+
+bool ConceptDenotationView::empty() const {
+    for (int i = 0; i < m_num_blocks; ++i) {
+        if (m_blocks[i]) return false;
+    }
+    return true;
+}
+
+bool ConceptDenotationView::intersects(const ConceptDenotationView& other) const {
+    assert(m_num_objects == other.m_num_objects);
+    for (int i = 0; i < m_num_blocks; ++i) {
+        if (m_blocks[i] & other.m_blocks[i]) return true;
+    }
+    return false;
+}
+
+bool ConceptDenotationView::is_subset_of(const ConceptDenotationView& other) const {
+    assert(m_num_objects == other.m_num_objects);
+    for (int i = 0; i < m_num_blocks; ++i) {
+        if (m_blocks[i] & ~other.m_blocks[i]) return false;
+    }
+    return true;
+}
+
 }
@@ -27,10 +27,10 @@ namespace std {
         return denotation.hash();
     }
     size_t hash<dlplan::core::ConceptDenotations>::operator()(const dlplan::core::ConceptDenotations& denotations) const {
-        return dlplan::hash_vector(denotations);
+        return denotations.hash();
     }
     size_t hash<dlplan::core::RoleDenotations>::operator()(const dlplan::core::RoleDenotations& denotations) const {
-        return dlplan::hash_vector(denotations);
+        return denotations.hash();
     }
     size_t hash<dlplan::core::DenotationsCacheKey>::operator()(const dlplan::core::DenotationsCacheKey& key) const {
         return key.hash();
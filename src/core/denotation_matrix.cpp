@@ -0,0 +1,169 @@
+#include "../../include/dlplan/core.h"
+
+#include "../utils/MurmurHash3.h"
+#include "../../include/dlplan/utils/bitset_kernels.h"
+#include "../../include/dlplan/utils/hash.h"
+
+#include <cstring>
+#include <type_traits>
+
+
+namespace dlplan::core {
+
+template<typename Denotation>
+std::size_t DenotationMatrix<Denotation>::compute_num_blocks(int num_objects) {
+    std::size_t num_blocks_per_row = (static_cast<std::size_t>(num_objects) + 63) / 64;
+    if constexpr (std::is_same_v<Denotation, RoleDenotation>) {
+        return num_objects * num_blocks_per_row;
+    } else {
+        return num_blocks_per_row;
+    }
+}
+
+template<typename Denotation>
+DenotationMatrix<Denotation>::DenotationMatrix() : m_offsets({0}) { }
+
+template<typename Denotation>
+DenotationMatrix<Denotation>::DenotationMatrix(const States& states) {
+    m_offsets.reserve(states.size() + 1);
+    m_num_objects.reserve(states.size());
+    m_offsets.push_back(0);
+    for (const auto& state : states) {
+        int num_objects = state.get_instance_info()->get_objects().size();
+        m_num_objects.push_back(num_objects);
+        m_offsets.push_back(m_offsets.back() + compute_num_blocks(num_objects));
+    }
+    m_blocks.resize(m_offsets.back(), 0);
+}
+
+template<typename Denotation>
+bool DenotationMatrix<Denotation>::operator==(const DenotationMatrix& other) const {
+    if (this == &other) {
+        return true;
+    }
+    return m_num_objects == other.m_num_objects
+        && std::memcmp(m_blocks.data(), other.m_blocks.data(), m_blocks.size() * sizeof(std::uint64_t)) == 0;
+}
+
+template<typename Denotation>
+bool DenotationMatrix<Denotation>::operator!=(const DenotationMatrix& other) const {
+    return !(*this == other);
+}
+
+template<typename Denotation>
+std::size_t DenotationMatrix<Denotation>::hash() const {
+    std::uint64_t result[2];
+    MurmurHash3_x64_128(m_blocks.data(), m_blocks.size() * sizeof(std::uint64_t), m_blocks.size(), result);
+    std::size_t seed = result[0];
+    hash_combine(seed, hash_vector(m_num_objects));
+    return seed;
+}
+
+template<typename Denotation>
+std::array<std::uint64_t, 2> DenotationMatrix<Denotation>::compute_fingerprint() const {
+    std::array<std::uint64_t, 2> result;
+    MurmurHash3_x64_128(m_blocks.data(), m_blocks.size() * sizeof(std::uint64_t), m_blocks.size(), result.data());
+    // Matrices with equal blocks can differ in the number of objects per row.
+    std::uint64_t objects[2];
+    MurmurHash3_x64_128(m_num_objects.data(), m_num_objects.size() * sizeof(int), m_num_objects.size(), objects);
+    result[0] ^= objects[0];
+    result[1] ^= objects[1];
+    return result;
+}
+
+template<typename Denotation>
+DenotationMatrix<Denotation>& DenotationMatrix<Denotation>::operator&=(const DenotationMatrix& other) {
+    assert(m_num_objects == other.m_num_objects);
+    kernels::get_kernels().bitwise_and(m_blocks.data(), other.m_blocks.data(), m_blocks.size());
+    return *this;
+}
+
+template<typename Denotation>
+DenotationMatrix<Denotation>& DenotationMatrix<Denotation>::operator|=(const DenotationMatrix& other) {
+    assert(m_num_objects == other.m_num_objects);
+    kernels::get_kernels().bitwise_or(m_blocks.data(), other.m_blocks.data(), m_blocks.size());
+    return *this;
+}
+
+template<typename Denotation>
+DenotationMatrix<Denotation>& DenotationMatrix<Denotation>::operator-=(const DenotationMatrix& other) {
+    assert(m_num_objects == other.m_num_objects);
+    kernels::get_kernels().bitwise_and_not(m_blocks.data(), other.m_blocks.data(), m_blocks.size());
+    return *this;
+}
+
+template<typename Denotation>
+void DenotationMatrix<Denotation>::load_row(std::size_t i, Denotation& denotation) const {
+    assert(i < size());
+    if (denotation.m_num_objects != m_num_objects[i]) {
+        denotation = Denotation(m_num_objects[i]);
+    }
+    assert(denotation.m_data.num_blocks() == m_offsets[i + 1] - m_offsets[i]);
+    std::memcpy(denotation.m_data.data(), &m_blocks[m_offsets[i]], (m_offsets[i + 1] - m_offsets[i]) * sizeof(std::uint64_t));
+}
+
+template<typename Denotation>
+void DenotationMatrix<Denotation>::store_row(std::size_t i, const Denotation& denotation) {
+    assert(i < size());
+    if (denotation.m_num_objects != m_num_objects[i]) {
+        throw std::runtime_error("DenotationMatrix::store_row - mismatched number of objects.");
+    }
+    std::memcpy(&m_blocks[m_offsets[i]], denotation.m_data.data(), (m_offsets[i + 1] - m_offsets[i]) * sizeof(std::uint64_t));
+}
+
+template<typename Denotation>
+void DenotationMatrix<Denotation>::reset_denotation(std::size_t i, Denotation& denotation) const {
+    assert(i < size());
+    if (denotation.m_num_objects != m_num_objects[i]) {
+        denotation = Denotation(m_num_objects[i]);
+    } else {
+        std::memset(denotation.m_data.data(), 0, denotation.m_data.num_blocks() * sizeof(std::uint64_t));
+    }
+}
+
+template<typename Denotation>
+Denotation DenotationMatrix<Denotation>::get_denotation(std::size_t i) const {
+    Denotation result(m_num_objects[i]);
+    load_row(i, result);
+    return result;
+}
+
+template<typename Denotation>
+int DenotationMatrix<Denotation>::count(std::size_t i) const {
+    assert(i < size());
+    return kernels::get_kernels().count(&m_blocks[m_offsets[i]], m_offsets[i + 1] - m_offsets[i]);
+}
+
+template<typename Denotation>
+bool DenotationMatrix<Denotation>::empty(std::size_t i) const {
+    assert(i < size());
+    return kernels::get_kernels().none(&m_blocks[m_offsets[i]], m_offsets[i + 1] - m_offsets[i]);
+}
+
+template<typename Denotation>
+bool DenotationMatrix<Denotation>::is_subset_of(std::size_t i, const DenotationMatrix& other) const {
+    assert(i < size() && m_num_objects[i] == other.m_num_objects[i]);
+    return kernels::get_kernels().is_subset_of(&m_blocks[m_offsets[i]], &other.m_blocks[m_offsets[i]], m_offsets[i + 1] - m_offsets[i]);
+}
+
+template<typename Denotation>
+std::size_t DenotationMatrix<Denotation>::size() const {
+    return m_num_objects.size();
+}
+
+template<typename Denotation>
+int DenotationMatrix<Denotation>::get_num_objects(std::size_t i) const {
+    return m_num_objects[i];
+}
+
+template<typename Denotation>
+std::size_t DenotationMatrix<Denotation>::get_dynamic_memory_usage() const {
+    return m_blocks.capacity() * sizeof(std::uint64_t)
+        + m_offsets.capacity() * sizeof(std::size_t)
+        + m_num_objects.capacity() * sizeof(int);
+}
+
+template class DenotationMatrix<ConceptDenotation>;
+template class DenotationMatrix<RoleDenotation>;
+
+}
@@ -1,11 +1,31 @@
 #include "../../include/dlplan/core.h"
 
+#include "../../include/dlplan/core/elements/utils.h"
 #include "../../include/dlplan/utils/hash.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 
 namespace dlplan::core {
 
-DenotationsCaches::DenotationsCaches() = default;
+DenotationsCaches::DenotationsCaches() : DenotationsCaches(false) { }
+
+DenotationsCaches::DenotationsCaches(bool thread_safe)
+    : m_memory_budget(0),
+      m_eviction_threshold(0),
+      m_evict_collections(false),
+      m_num_evictions(0),
+      m_num_evicted_entries(0),
+      m_evaluation_depth(0),
+      m_num_threads(1),
+#ifdef DLPLAN_INSTRUMENTATION
+      m_statistics_mutex(std::make_unique<std::mutex>()),
+#endif
+      data(thread_safe),
+      static_atom_denotations(thread_safe),
+      pairwise_distances_mutex(std::make_unique<std::mutex>()),
+      pairwise_distances_num_bytes(0) { }
 
 DenotationsCaches::~DenotationsCaches() = default;
 
@@ -13,6 +33,121 @@ DenotationsCaches::DenotationsCaches(DenotationsCaches&& other) = default;
 
 DenotationsCaches& DenotationsCaches::operator=(DenotationsCaches&& other) = default;
 
+void DenotationsCaches::evict_if_over_budget() {
+    if (get_num_bytes() <= m_eviction_threshold) {
+        return;
+    }
+    auto is_pinned = [this](const DenotationsCacheKey& key) {
+        return key.state == -1 && !(m_evict_collections && key.instance == -1);
+    };
+    // Pairwise distances are keyed by role denotations, which keeps them alive.
+    pairwise_distances.clear();
+    pairwise_distances_num_bytes = 0;
+    // First evict the states that were not used since the previous eviction.
+    m_num_evicted_entries += data.evict(is_pinned);
+    if (get_num_bytes() > m_memory_budget) {
+        m_num_evicted_entries += data.evict(is_pinned);
+    }
+    ++m_num_evictions;
+    // Eviction cannot go below the pinned denotations. If they exceed the
+    // budget, the unpinned ones may still occupy the budget on top of them
+    // such that not every evaluation evicts.
+    std::size_t num_pinned_bytes = data.get_num_pinned_bytes(is_pinned) + static_atom_denotations.get_num_bytes();
+    m_eviction_threshold = (num_pinned_bytes > m_memory_budget) ? num_pinned_bytes + m_memory_budget : m_memory_budget;
+}
+
+void DenotationsCaches::set_memory_budget(std::size_t num_bytes, bool evict_collections) {
+    if (data.is_thread_safe() && num_bytes > 0) {
+        throw std::runtime_error("DenotationsCaches::set_memory_budget - memory budget requires caches that are not thread-safe.");
+    }
+    if (m_evaluation_depth > 0) {
+        throw std::runtime_error("DenotationsCaches::set_memory_budget - cannot change the memory budget during an evaluation.");
+    }
+    m_memory_budget = num_bytes;
+    m_eviction_threshold = num_bytes;
+    m_evict_collections = evict_collections;
+    data.set_track_usage(num_bytes > 0);
+}
+
+std::size_t DenotationsCaches::get_memory_budget() const {
+    return m_memory_budget;
+}
+
+void DenotationsCaches::set_num_threads(int num_threads) {
+    if (num_threads < 1) {
+        throw std::runtime_error("DenotationsCaches::set_num_threads - number of threads must be positive.");
+    }
+    if (!data.is_thread_safe() && num_threads > 1) {
+        throw std::runtime_error("DenotationsCaches::set_num_threads - parallel evaluation requires caches that are thread-safe.");
+    }
+    m_num_threads = num_threads;
+}
+
+int DenotationsCaches::get_num_threads() const {
+    return m_num_threads;
+}
+
+std::size_t DenotationsCaches::get_num_bytes() const {
+    return data.get_num_bytes() + static_atom_denotations.get_num_bytes() + pairwise_distances_num_bytes;
+}
+
+std::size_t DenotationsCaches::get_num_evictions() const {
+    return m_num_evictions;
+}
+
+std::size_t DenotationsCaches::get_num_evicted_entries() const {
+    return m_num_evicted_entries;
+}
+
+#ifdef DLPLAN_INSTRUMENTATION
+ElementStatistics& DenotationsCaches::get_statistics(ElementIndex element) {
+    if (element >= static_cast<ElementIndex>(m_statistics.size())) {
+        m_statistics.resize(element + 1);
+    }
+    return m_statistics[element];
+}
+
+void DenotationsCaches::record_miss(ElementIndex element, std::chrono::nanoseconds time, std::size_t num_bytes) {
+    std::unique_lock lock(*m_statistics_mutex, std::defer_lock);
+    if (data.is_thread_safe()) lock.lock();
+    auto& statistics = get_statistics(element);
+    statistics.num_misses += 1;
+    statistics.evaluate_time += time;
+    statistics.num_bytes += num_bytes;
+}
+#endif
+
+bool DenotationsCaches::is_instrumentation_enabled() {
+#ifdef DLPLAN_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::unordered_map<ElementIndex, ElementStatistics> DenotationsCaches::get_element_statistics() const {
+    std::unordered_map<ElementIndex, ElementStatistics> result;
+#ifdef DLPLAN_INSTRUMENTATION
+    std::unique_lock lock(*m_statistics_mutex, std::defer_lock);
+    if (data.is_thread_safe()) lock.lock();
+    for (ElementIndex element = 0; element < static_cast<ElementIndex>(m_statistics.size()); ++element) {
+        const auto& statistics = m_statistics[element];
+        if (statistics.num_hits > 0 || statistics.num_misses > 0) {
+            result.emplace(element, statistics);
+        }
+    }
+#endif
+    return result;
+}
+
+void DenotationsCaches::clear_element_statistics() {
+#ifdef DLPLAN_INSTRUMENTATION
+    std::unique_lock lock(*m_statistics_mutex, std::defer_lock);
+    if (data.is_thread_safe()) lock.lock();
+    m_statistics.clear();
+#endif
+}
+
 bool DenotationsCacheKey::operator==(const DenotationsCacheKey& other) const {
     return (element == other.element) &&
            (instance == other.instance) &&
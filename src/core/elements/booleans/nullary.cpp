@@ -4,21 +4,8 @@
 namespace dlplan::core {
 
 void NullaryBoolean::compute_result(const State& state, bool& result) const {
-    const auto& atoms = state.get_instance_info()->get_atoms();
-    for (int atom_idx : state.get_atom_indices()) {
-        const auto& atom = atoms[atom_idx];
-        if (atom.get_predicate_index() == m_predicate.get_index()) {
-            result = true;
-            return;
-        }
-    }
-    for (const auto &atom : state.get_instance_info()->get_static_atoms()) {
-        if (atom.get_predicate_index() == m_predicate.get_index()) {
-            result = true;
-            return;
-        }
-    }
-    result = false;
+    result = !state.get_atom_indices_of_predicate(m_predicate.get_index()).empty()
+        || !state.get_instance_info()->get_static_atom_indices_of_predicate(m_predicate.get_index()).empty();
 }
 
 bool NullaryBoolean::evaluate_impl(const State& state, DenotationsCaches&) const {
@@ -34,6 +21,16 @@ NullaryBoolean::evaluate_impl(const States& states, DenotationsCaches&) const {
     return denotations;
 }
 
+int NullaryBoolean::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &NullaryBoolean::execute);
+}
+
+void NullaryBoolean::execute(const EvaluationInstruction& instruction, const State& state, EvaluationFrame& frame) {
+    bool denotation;
+    static_cast<const NullaryBoolean*>(instruction.element)->compute_result(state, denotation);
+    frame.set_boolean_denotation(instruction.result, denotation);
+}
+
 NullaryBoolean::NullaryBoolean(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, const Predicate& predicate)
 : Boolean(index, vocabulary_info, predicate.is_static()), m_predicate(predicate) {
     if (predicate.get_arity() != 0) {
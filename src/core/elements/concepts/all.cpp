@@ -3,11 +3,10 @@
 
 namespace dlplan::core {
 void AllConcept::compute_result(const RoleDenotation& role_denot, const ConceptDenotation& concept_denot, ConceptDenotation& result) const {
-    // find counterexamples b : exists b . (a,b) in R and b notin C
-    result.set();
-    for (const auto& pair : role_denot.to_vector()) {
-        if (!concept_denot.contains(pair.second)) {
-            result.erase(pair.first);
+    // find examples a : forall b . (a,b) in R implies b in C
+    for (int i = 0; i < role_denot.get_num_objects(); ++i) {
+        if (role_denot.get_row(i).is_subset_of(concept_denot)) {
+            result.insert(i);
         }
     }
 }
@@ -15,28 +14,47 @@ void AllConcept::compute_result(const RoleDenotation& role_denot, const ConceptD
 ConceptDenotation AllConcept::evaluate_impl(const State& state, DenotationsCaches& caches) const {
     ConceptDenotation denotation(state.get_instance_info()->get_objects().size());
     compute_result(
-        *m_role->evaluate(state, caches),
-        *m_concept->evaluate(state, caches),
+        m_role->evaluate_ref(state, caches),
+        m_concept->evaluate_ref(state, caches),
         denotation);
     return denotation;
 }
 
 ConceptDenotations AllConcept::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    ConceptDenotations denotations;
-    denotations.reserve(states.size());
+    ConceptDenotations denotations(states);
     auto role_denotations = m_role->evaluate(states, caches);
     auto concept_denotations = m_concept->evaluate(states, caches);
-    for (size_t i = 0; i < states.size(); ++i) {
-        ConceptDenotation denotation(states[i].get_instance_info()->get_objects().size());
-        compute_result(
-            *(*role_denotations)[i],
-            *(*concept_denotations)[i],
-            denotation);
-        denotations.push_back(caches.data.insert_unique<ConceptDenotation>(std::move(denotation)));
-    }
+    utils::for_each_state_range(states, caches, [&](size_t begin, size_t end) {
+        RoleDenotation role_denotation(0);
+        ConceptDenotation concept_denotation(0);
+        ConceptDenotation denotation(0);
+        for (size_t i = begin; i < end; ++i) {
+            role_denotations->load_row(i, role_denotation);
+            concept_denotations->load_row(i, concept_denotation);
+            denotations.reset_denotation(i, denotation);
+            compute_result(
+                role_denotation,
+                concept_denotation,
+                denotation);
+            denotations.store_row(i, denotation);
+        }
+    });
     return denotations;
 }
 
+int AllConcept::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &AllConcept::execute, {builder.compile(*m_role), builder.compile(*m_concept)});
+}
+
+void AllConcept::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+    auto& result = frame.get_concept_denotation(instruction.result);
+    result.clear();
+    static_cast<const AllConcept*>(instruction.element)->compute_result(
+        frame.get_role_denotation(instruction.arguments[0]),
+        frame.get_concept_denotation(instruction.arguments[1]),
+        result);
+}
+
 AllConcept::AllConcept(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Role> role, std::shared_ptr<const Concept> concept_)
     : Concept(index, vocabulary_info, role->is_static() && concept_->is_static()), m_role(role), m_concept(concept_) { }
 
@@ -6,14 +6,16 @@ ConceptDenotation BotConcept::evaluate_impl(const State& state, DenotationsCache
     return ConceptDenotation(state.get_instance_info()->get_objects().size());
 }
 
-ConceptDenotations BotConcept::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    ConceptDenotations denotations;
-    denotations.reserve(states.size());
-    for (size_t i = 0; i < states.size(); ++i) {
-        ConceptDenotation denotation(states[i].get_instance_info()->get_objects().size());
-        denotations.push_back(caches.data.insert_unique(std::move(denotation)));
-    }
-    return denotations;
+ConceptDenotations BotConcept::evaluate_impl(const States& states, DenotationsCaches&) const {
+    return ConceptDenotations(states);
+}
+
+int BotConcept::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &BotConcept::execute);
+}
+
+void BotConcept::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+    frame.get_concept_denotation(instruction.result).clear();
 }
 
 BotConcept::BotConcept(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info)
@@ -11,26 +11,48 @@ void NotConcept::compute_result(const ConceptDenotation& denot, ConceptDenotatio
 ConceptDenotation NotConcept::evaluate_impl(const State& state, DenotationsCaches& caches) const {
     ConceptDenotation denotation(state.get_instance_info()->get_objects().size());
     compute_result(
-        *m_concept->evaluate(state, caches),
+        m_concept->evaluate_ref(state, caches),
         denotation);
     return denotation;
 }
 
 ConceptDenotations NotConcept::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    ConceptDenotations denotations;
-    denotations.reserve(states.size());
+    ConceptDenotations denotations(states);
     // get denotations of children
     auto concept_denotations = m_concept->evaluate(states, caches);
-    for (size_t i = 0; i < states.size(); ++i) {
-        ConceptDenotation denotation(states[i].get_instance_info()->get_objects().size());
-        compute_result(
-            *(*concept_denotations)[i],
-            denotation);
-        denotations.push_back(caches.data.insert_unique(std::move(denotation)));
-    }
+    utils::for_each_state_range(states, caches, [&](size_t begin, size_t end) {
+        ConceptDenotation concept_denotation(0);
+        ConceptDenotation denotation(0);
+        for (size_t i = begin; i < end; ++i) {
+            concept_denotations->load_row(i, concept_denotation);
+            denotations.reset_denotation(i, denotation);
+            compute_result(
+                concept_denotation,
+                denotation);
+            denotations.store_row(i, denotation);
+        }
+    });
     return denotations;
 }
 
+ObjectHandle NotConcept::evaluate_delta_impl(const StateDelta& delta, ObjectHandle parent_handle, DenotationsCaches& caches) const {
+    if (utils::is_unchanged(*m_concept, delta, caches)) {
+        return parent_handle;
+    }
+    return caches.data.insert(evaluate_impl(delta.get_state(), caches));
+}
+
+int NotConcept::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &NotConcept::execute, {builder.compile(*m_concept)});
+}
+
+void NotConcept::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+    auto& result = frame.get_concept_denotation(instruction.result);
+    static_cast<const NotConcept*>(instruction.element)->compute_result(
+        frame.get_concept_denotation(instruction.arguments[0]),
+        result);
+}
+
 NotConcept::NotConcept(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Concept> concept_)
     : Concept(index, vocabulary_info, concept_->is_static()), m_concept(concept_){ }
 
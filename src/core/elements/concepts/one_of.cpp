@@ -25,18 +25,30 @@ ConceptDenotation OneOfConcept::evaluate_impl(const State& state, DenotationsCac
 }
 
 ConceptDenotations OneOfConcept::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    ConceptDenotations denotations;
-    denotations.reserve(states.size());
-    for (size_t i = 0; i < states.size(); ++i) {
-        ConceptDenotation denotation(states[i].get_instance_info()->get_objects().size());
-        compute_result(
-            states[i],
-            denotation);
-        denotations.push_back(caches.data.insert_unique(std::move(denotation)));
-    }
+    ConceptDenotations denotations(states);
+    utils::for_each_state_range(states, caches, [&](size_t begin, size_t end) {
+        ConceptDenotation denotation(0);
+        for (size_t i = begin; i < end; ++i) {
+            denotations.reset_denotation(i, denotation);
+            compute_result(
+                states[i],
+                denotation);
+            denotations.store_row(i, denotation);
+        }
+    });
     return denotations;
 }
 
+int OneOfConcept::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &OneOfConcept::execute);
+}
+
+void OneOfConcept::execute(const EvaluationInstruction& instruction, const State& state, EvaluationFrame& frame) {
+    auto& result = frame.get_concept_denotation(instruction.result);
+    result.clear();
+    static_cast<const OneOfConcept*>(instruction.element)->compute_result(state, result);
+}
+
 OneOfConcept::OneOfConcept(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, const Constant& constant)
     : Concept(index, vocabulary_info, true), m_constant(constant) { }
 
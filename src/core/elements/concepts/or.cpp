@@ -11,32 +11,44 @@ ConceptDenotation OrConcept::evaluate_impl(const State& state, DenotationsCaches
     ConceptDenotation denotation(state.get_instance_info()->get_objects().size());
     denotation.set();
     compute_result(
-        *m_concept_left->evaluate(state, caches),
-        *m_concept_right->evaluate(state, caches),
+        m_concept_left->evaluate_ref(state, caches),
+        m_concept_right->evaluate_ref(state, caches),
         denotation);
     return denotation;
 }
 
 ConceptDenotations OrConcept::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    ConceptDenotations denotations;
-    denotations.reserve(states.size());
     auto concept_left_denotations = m_concept_left->evaluate(states, caches);
     auto concept_right_denotations = m_concept_right->evaluate(states, caches);
-    for (size_t i = 0; i < states.size(); ++i) {
-        ConceptDenotation denotation(states[i].get_instance_info()->get_objects().size());
-        compute_result(
-            *(*concept_left_denotations)[i],
-            *(*concept_right_denotations)[i],
-            denotation);
-        denotations.push_back(caches.data.insert_unique(std::move(denotation)));
-    }
+    ConceptDenotations denotations(*concept_left_denotations);
+    denotations |= *concept_right_denotations;
     return denotations;
 }
 
+ObjectHandle OrConcept::evaluate_delta_impl(const StateDelta& delta, ObjectHandle parent_handle, DenotationsCaches& caches) const {
+    if (utils::is_unchanged(*m_concept_left, delta, caches)
+        && utils::is_unchanged(*m_concept_right, delta, caches)) {
+        return parent_handle;
+    }
+    return caches.data.insert(evaluate_impl(delta.get_state(), caches));
+}
+
+int OrConcept::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &OrConcept::execute, {builder.compile(*m_concept_left), builder.compile(*m_concept_right)});
+}
+
+void OrConcept::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+    auto& result = frame.get_concept_denotation(instruction.result);
+    static_cast<const OrConcept*>(instruction.element)->compute_result(
+        frame.get_concept_denotation(instruction.arguments[0]),
+        frame.get_concept_denotation(instruction.arguments[1]),
+        result);
+}
+
 OrConcept::OrConcept(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Concept> concept_1, std::shared_ptr<const Concept> concept_2)
     : Concept(index, vocabulary_info, concept_1->is_static() && concept_2->is_static()),
-    m_concept_left(concept_1->get_index() < concept_2->get_index() ? concept_1 : concept_2),
-    m_concept_right(concept_1->get_index() < concept_2->get_index() ? concept_2 : concept_1) { }
+    m_concept_left(utils::is_canonically_ordered(*concept_1, *concept_2) ? concept_1 : concept_2),
+    m_concept_right(m_concept_left == concept_1 ? concept_2 : concept_1) { }
 
 bool OrConcept::are_equal_impl(const Concept& other) const {
     if (typeid(*this) == typeid(other)) {
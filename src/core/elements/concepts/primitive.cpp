@@ -2,47 +2,108 @@
 
 #include "../../../utils/collections.h"
 
+#include <algorithm>
+
 
 namespace dlplan::core {
-void PrimitiveConcept::compute_result(const State& state, ConceptDenotation& result) const {
-    const auto& instance_info = *state.get_instance_info();
-    const auto& atoms = instance_info.get_atoms();
-    for (int atom_idx : state.get_atom_indices()) {
+void PrimitiveConcept::insert_objects(const std::vector<Atom>& atoms, std::span<const AtomIndex> atom_indices, ConceptDenotation& result) const {
+    for (int atom_idx : atom_indices) {
         const auto& atom = atoms[atom_idx];
-        if (atom.get_predicate_index() == m_predicate.get_index()) {
-            assert(dlplan::utils::in_bounds(m_pos, atom.get_object_indices()));
-            result.insert(atom.get_object_indices()[m_pos]);
-        }
+        assert(atom.get_predicate_index() == m_predicate.get_index());
+        assert(dlplan::utils::in_bounds(m_pos, atom.get_object_indices()));
+        result.insert(atom.get_object_indices()[m_pos]);
     }
-    for (const auto &atom : state.get_instance_info()->get_static_atoms()) {
-        if (atom.get_predicate_index() == m_predicate.get_index()) {
-            assert(dlplan::utils::in_bounds(m_pos, atom.get_object_indices()));
-            result.insert(atom.get_object_indices()[m_pos]);
-        }
+}
+
+void PrimitiveConcept::insert_static_objects(const InstanceInfo& instance_info, ConceptDenotation& result, DenotationsCaches& caches) const {
+    const auto& static_atom_indices = instance_info.get_static_atom_indices_of_predicate(m_predicate.get_index());
+    if (static_atom_indices.empty()) {
+        return;
+    }
+    if (m_is_static) {
+        // the denotation of the element itself is cached per instance
+        insert_objects(instance_info.get_static_atoms(), static_atom_indices, result);
+        return;
     }
+    // Otherwise, the contribution of the static atoms is the same in all
+    // states of the instance.
+    auto key = DenotationsCacheKey{ get_index(), instance_info.get_index(), -1 };
+    auto handle = caches.static_atom_denotations.get_handle<ConceptDenotation>(key);
+    if (handle == UNDEFINED_HANDLE) {
+        ConceptDenotation denotation(instance_info.get_objects().size());
+        insert_objects(instance_info.get_static_atoms(), static_atom_indices, denotation);
+        handle = caches.static_atom_denotations.insert_mapping<ConceptDenotation>(key, caches.static_atom_denotations.insert(std::move(denotation)));
+    }
+    result |= caches.static_atom_denotations.get_object<ConceptDenotation>(handle);
 }
 
-ConceptDenotation PrimitiveConcept::evaluate_impl(const State& state, DenotationsCaches&) const {
-    ConceptDenotation denotation(state.get_instance_info()->get_objects().size());
-    compute_result(
-        state,
-        denotation);
+void PrimitiveConcept::compute_result(const State& state, ConceptDenotation& result) const {
+    const auto& instance_info = *state.get_instance_info();
+    insert_objects(instance_info.get_atoms(), state.get_atom_indices_of_predicate(m_predicate.get_index()), result);
+    insert_objects(instance_info.get_static_atoms(), instance_info.get_static_atom_indices_of_predicate(m_predicate.get_index()), result);
+}
+
+ConceptDenotation PrimitiveConcept::evaluate_impl(const State& state, DenotationsCaches& caches) const {
+    const auto& instance_info = *state.get_instance_info();
+    ConceptDenotation denotation(instance_info.get_objects().size());
+    insert_static_objects(instance_info, denotation, caches);
+    insert_objects(instance_info.get_atoms(), state.get_atom_indices_of_predicate(m_predicate.get_index()), denotation);
     return denotation;
 }
 
 ConceptDenotations PrimitiveConcept::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    ConceptDenotations denotations;
-    denotations.reserve(states.size());
-    for (size_t i = 0; i < states.size(); ++i) {
-        ConceptDenotation denotation(states[i].get_instance_info()->get_objects().size());
-        compute_result(
-            states[i],
-            denotation);
-        denotations.push_back(caches.data.insert_unique(std::move(denotation)));
-    }
+    ConceptDenotations denotations(states);
+    utils::for_each_state_range(states, caches, [&](size_t begin, size_t end) {
+        ConceptDenotation denotation(0);
+        for (size_t i = begin; i < end; ++i) {
+            const auto& instance_info = *states[i].get_instance_info();
+            denotations.reset_denotation(i, denotation);
+            insert_static_objects(instance_info, denotation, caches);
+            insert_objects(instance_info.get_atoms(), states[i].get_atom_indices_of_predicate(m_predicate.get_index()), denotation);
+            denotations.store_row(i, denotation);
+        }
+    });
     return denotations;
 }
 
+ObjectHandle PrimitiveConcept::evaluate_delta_impl(const StateDelta& delta, ObjectHandle parent_handle, DenotationsCaches& caches) const {
+    const auto& atoms = delta.get_state().get_instance_info()->get_atoms();
+    auto has_predicate = [&](int atom_idx) { return atoms[atom_idx].get_predicate_index() == m_predicate.get_index(); };
+    const auto& added_atoms = delta.get_added_atoms();
+    const auto& deleted_atoms = delta.get_deleted_atoms();
+    bool is_added = std::any_of(added_atoms.begin(), added_atoms.end(), has_predicate);
+    bool is_deleted = std::any_of(deleted_atoms.begin(), deleted_atoms.end(), has_predicate);
+    if (!is_added && !is_deleted) {
+        return parent_handle;
+    }
+    if (is_deleted && m_predicate.get_arity() > 1) {
+        // another atom might still contain the object at m_pos
+        return caches.data.insert(evaluate_impl(delta.get_state(), caches));
+    }
+    ConceptDenotation denotation(caches.data.get_object<ConceptDenotation>(parent_handle));
+    for (int atom_idx : deleted_atoms) {
+        if (has_predicate(atom_idx)) {
+            denotation.erase(atoms[atom_idx].get_object_indices()[m_pos]);
+        }
+    }
+    for (int atom_idx : added_atoms) {
+        if (has_predicate(atom_idx)) {
+            denotation.insert(atoms[atom_idx].get_object_indices()[m_pos]);
+        }
+    }
+    return caches.data.insert(std::move(denotation));
+}
+
+int PrimitiveConcept::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &PrimitiveConcept::execute);
+}
+
+void PrimitiveConcept::execute(const EvaluationInstruction& instruction, const State& state, EvaluationFrame& frame) {
+    auto& result = frame.get_concept_denotation(instruction.result);
+    result.clear();
+    static_cast<const PrimitiveConcept*>(instruction.element)->compute_result(state, result);
+}
+
 PrimitiveConcept::PrimitiveConcept(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, const Predicate& predicate, int pos)
     : Concept(index, vocabulary_info, predicate.is_static()), m_predicate(predicate), m_pos(pos) {
     if (m_pos >= m_predicate.get_arity()) {
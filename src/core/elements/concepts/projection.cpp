@@ -3,34 +3,53 @@
 
 namespace dlplan::core {
 void ProjectionConcept::compute_result(const RoleDenotation& denot, ConceptDenotation& result) const {
-    for (const auto& pair : denot.to_vector()) {
-        if (m_pos == 0) result.insert(pair.first);
-        else if (m_pos == 1) result.insert(pair.second);
+    for (int i = 0; i < denot.get_num_objects(); ++i) {
+        if (m_pos == 0) {
+            if (!denot.get_row(i).empty()) result.insert(i);
+        } else if (m_pos == 1) {
+            result |= denot.get_row(i);
+        }
     }
 }
 
 ConceptDenotation ProjectionConcept::evaluate_impl(const State& state, DenotationsCaches& caches) const {
     ConceptDenotation denotation(state.get_instance_info()->get_objects().size());
     compute_result(
-        *m_role->evaluate(state, caches),
+        m_role->evaluate_ref(state, caches),
         denotation);
     return denotation;
 }
 
 ConceptDenotations ProjectionConcept::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    ConceptDenotations denotations;
-    denotations.reserve(states.size());
+    ConceptDenotations denotations(states);
     auto role_denotations = m_role->evaluate(states, caches);
-    for (size_t i = 0; i < states.size(); ++i) {
-        ConceptDenotation denotation(states[i].get_instance_info()->get_objects().size());
-        compute_result(
-            *(*role_denotations)[i],
-            denotation);
-        denotations.push_back(caches.data.insert_unique(std::move(denotation)));
-    }
+    utils::for_each_state_range(states, caches, [&](size_t begin, size_t end) {
+        RoleDenotation role_denotation(0);
+        ConceptDenotation denotation(0);
+        for (size_t i = begin; i < end; ++i) {
+            role_denotations->load_row(i, role_denotation);
+            denotations.reset_denotation(i, denotation);
+            compute_result(
+                role_denotation,
+                denotation);
+            denotations.store_row(i, denotation);
+        }
+    });
     return denotations;
 }
 
+int ProjectionConcept::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &ProjectionConcept::execute, {builder.compile(*m_role)});
+}
+
+void ProjectionConcept::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+    auto& result = frame.get_concept_denotation(instruction.result);
+    result.clear();
+    static_cast<const ProjectionConcept*>(instruction.element)->compute_result(
+        frame.get_role_denotation(instruction.arguments[0]),
+        result);
+}
+
 ProjectionConcept::ProjectionConcept(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, const std::shared_ptr<const Role>& role, int pos)
 : Concept(index, vocabulary_info, role->is_static()), m_role(role), m_pos(pos) {
     if (pos < 0 || pos > 1) {
@@ -3,39 +3,58 @@
 
 namespace dlplan::core {
 void SubsetConcept::compute_result(const RoleDenotation& left_denot, const RoleDenotation& right_denot, ConceptDenotation& result) const {
-    // find counterexamples a : exists b . (a,b) in R and (a,b) notin S
-    result.set();
-    for (const auto& pair : left_denot.to_vector()) {
-        if (!right_denot.contains(pair)) result.erase(pair.first);
+    // find examples a : the successors of a in R are successors of a in S
+    for (int i = 0; i < left_denot.get_num_objects(); ++i) {
+        if (left_denot.get_row(i).is_subset_of(right_denot.get_row(i))) {
+            result.insert(i);
+        }
     }
 }
 
 ConceptDenotation SubsetConcept::evaluate_impl(const State& state, DenotationsCaches& caches) const {
     ConceptDenotation denotation(state.get_instance_info()->get_objects().size());
     compute_result(
-        *m_role_left->evaluate(state, caches),
-        *m_role_right->evaluate(state, caches),
+        m_role_left->evaluate_ref(state, caches),
+        m_role_right->evaluate_ref(state, caches),
         denotation);
     return denotation;
 }
 
 ConceptDenotations SubsetConcept::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    ConceptDenotations denotations;
-    denotations.reserve(states.size());
+    ConceptDenotations denotations(states);
     auto role_left_denotations = m_role_left->evaluate(states, caches);
     auto role_right_denotations = m_role_right->evaluate(states, caches);
-    for (size_t i = 0; i < states.size(); ++i) {
-        ConceptDenotation denotation(states[i].get_instance_info()->get_objects().size());
-        compute_result(
-            *(*role_left_denotations)[i],
-            *(*role_right_denotations)[i],
-            denotation);
-        // register denotation and append it to denotations.
-        denotations.push_back(caches.data.insert_unique(std::move(denotation)));
-    }
+    utils::for_each_state_range(states, caches, [&](size_t begin, size_t end) {
+        RoleDenotation role_left_denotation(0);
+        RoleDenotation role_right_denotation(0);
+        ConceptDenotation denotation(0);
+        for (size_t i = begin; i < end; ++i) {
+            role_left_denotations->load_row(i, role_left_denotation);
+            role_right_denotations->load_row(i, role_right_denotation);
+            denotations.reset_denotation(i, denotation);
+            compute_result(
+                role_left_denotation,
+                role_right_denotation,
+                denotation);
+            denotations.store_row(i, denotation);
+        }
+    });
     return denotations;
 }
 
+int SubsetConcept::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &SubsetConcept::execute, {builder.compile(*m_role_left), builder.compile(*m_role_right)});
+}
+
+void SubsetConcept::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+    auto& result = frame.get_concept_denotation(instruction.result);
+    result.clear();
+    static_cast<const SubsetConcept*>(instruction.element)->compute_result(
+        frame.get_role_denotation(instruction.arguments[0]),
+        frame.get_role_denotation(instruction.arguments[1]),
+        result);
+}
+
 SubsetConcept::SubsetConcept(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Role> role_left, std::shared_ptr<const Role> role_right)
     : Concept(index, vocabulary_info, role_left->is_static() && role_right->is_static()), m_role_left(role_left), m_role_right(role_right) { }
 
@@ -8,17 +8,25 @@ ConceptDenotation TopConcept::evaluate_impl(const State& state, DenotationsCache
     return denotation;
 }
 
-ConceptDenotations TopConcept::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    ConceptDenotations denotations;
-    denotations.reserve(states.size());
+ConceptDenotations TopConcept::evaluate_impl(const States& states, DenotationsCaches&) const {
+    ConceptDenotations denotations(states);
+    ConceptDenotation denotation(0);
     for (size_t i = 0; i < states.size(); ++i) {
-        ConceptDenotation denotation(states[i].get_instance_info()->get_objects().size());
+        denotations.reset_denotation(i, denotation);
         denotation.set();
-        denotations.push_back(caches.data.insert_unique(std::move(denotation)));
+        denotations.store_row(i, denotation);
     }
     return denotations;
 }
 
+int TopConcept::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &TopConcept::execute);
+}
+
+void TopConcept::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+    frame.get_concept_denotation(instruction.result).set();
+}
+
 TopConcept::TopConcept(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info)
     : Concept(index, vocabulary_info, true) {
 }
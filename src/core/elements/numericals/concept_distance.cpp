@@ -7,56 +7,81 @@ void ConceptDistanceNumerical::compute_result(const ConceptDenotation& concept_f
 }
 
 int ConceptDistanceNumerical::evaluate_impl(const State& state, DenotationsCaches& caches) const {
-    auto concept_from_denot = m_concept_from->evaluate(state, caches);
-    if (concept_from_denot->empty()) {
+    const auto& concept_from_denot = m_concept_from->evaluate_ref(state, caches);
+    if (concept_from_denot.empty()) {
         return INF;
     }
-    auto concept_to_denot = m_concept_to->evaluate(state, caches);
-    if (concept_to_denot->empty()) {
+    const auto& concept_to_denot = m_concept_to->evaluate_ref(state, caches);
+    if (concept_to_denot.empty()) {
         return INF;
     }
-    if (concept_from_denot->intersects(*concept_to_denot)) {
+    if (concept_from_denot.intersects(concept_to_denot)) {
         return 0;
     }
-    auto role_denot = m_role->evaluate(state, caches);
+    const auto& role_denot = m_role->evaluate_ref(state, caches);
     int denotation;
     compute_result(
-        *concept_from_denot,
-        *role_denot,
-        *concept_to_denot, denotation);
+        concept_from_denot,
+        role_denot,
+        concept_to_denot, denotation);
     return denotation;
 }
 
 NumericalDenotations ConceptDistanceNumerical::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    NumericalDenotations denotations;
-    denotations.reserve(states.size());
+    NumericalDenotations denotations(states.size());
     auto concept_from_denots = m_concept_from->evaluate(states, caches);
     auto role_denots = m_role->evaluate(states, caches);
     auto concept_to_denots = m_concept_to->evaluate(states, caches);
-    for (size_t i = 0; i < states.size(); ++i) {
-        if ((*concept_from_denots)[i]->empty()) {
-            denotations.push_back(INF);
-            continue;
+    utils::for_each_state_range(states, caches, [&](size_t begin, size_t end) {
+        ConceptDenotation concept_from_denot(0);
+        RoleDenotation role_denot(0);
+        ConceptDenotation concept_to_denot(0);
+        for (size_t i = begin; i < end; ++i) {
+            if (concept_from_denots->empty(i)) {
+                denotations[i] = INF;
+                continue;
+            }
+            if (concept_to_denots->empty(i)) {
+                denotations[i] = INF;
+                continue;
+            }
+            concept_from_denots->load_row(i, concept_from_denot);
+            concept_to_denots->load_row(i, concept_to_denot);
+            if (concept_from_denot.intersects(concept_to_denot)) {
+                denotations[i] = 0;
+                continue;
+            }
+            role_denots->load_row(i, role_denot);
+            int denotation;
+            compute_result(
+                concept_from_denot,
+                role_denot,
+                concept_to_denot,
+                denotation);
+            denotations[i] = denotation;
         }
-        if ((*concept_to_denots)[i]->empty()) {
-            denotations.push_back(INF);
-            continue;
-        }
-        if ((*concept_from_denots)[i]->intersects(*(*concept_to_denots)[i])) {
-            denotations.push_back(0);
-            continue;
-        }
-        int denotation;
-        compute_result(
-            *(*concept_from_denots)[i],
-            *(*role_denots)[i],
-            *(*concept_to_denots)[i],
-            denotation);
-        denotations.push_back(denotation);
-    }
+    });
     return denotations;
 }
 
+int ConceptDistanceNumerical::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &ConceptDistanceNumerical::execute, {builder.compile(*m_concept_from), builder.compile(*m_role), builder.compile(*m_concept_to)});
+}
+
+void ConceptDistanceNumerical::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+    const auto& concept_from_denot = frame.get_concept_denotation(instruction.arguments[0]);
+    const auto& concept_to_denot = frame.get_concept_denotation(instruction.arguments[2]);
+    int denotation;
+    if (concept_from_denot.empty() || concept_to_denot.empty()) {
+        denotation = INF;
+    } else if (concept_from_denot.intersects(concept_to_denot)) {
+        denotation = 0;
+    } else {
+        static_cast<const ConceptDistanceNumerical*>(instruction.element)->compute_result(concept_from_denot, frame.get_role_denotation(instruction.arguments[1]), concept_to_denot, denotation);
+    }
+    frame.set_numerical_denotation(instruction.result, denotation);
+}
+
 ConceptDistanceNumerical::ConceptDistanceNumerical(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Concept> concept_from, std::shared_ptr<const Role> role, std::shared_ptr<const Concept> concept_to)
     : Numerical(index, vocabulary_info, concept_from->is_static() && role->is_static() && concept_to->is_static()),
         m_concept_from(concept_from), m_role(role), m_concept_to(concept_to) { }
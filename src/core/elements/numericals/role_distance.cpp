@@ -2,64 +2,86 @@
 
 
 namespace dlplan::core {
-void RoleDistanceNumerical::compute_result(const RoleDenotation& role_from_denot, const RoleDenotation& role_denot, const RoleDenotation& role_to_denot, int& result) const {
-    utils::PairwiseDistances pairwise_distances = utils::compute_floyd_warshall(role_denot);
+void RoleDistanceNumerical::compute_result(const RoleDenotation& role_from_denot, PairwiseDistances& pairwise_distances, const RoleDenotation& role_to_denot, int& result) const {
     result = INF;
-    int num_objects = role_denot.get_num_objects();
+    int num_objects = role_from_denot.get_num_objects();
     for (int k = 0; k < num_objects; ++k) {  // property
-        for (int i = 0; i < num_objects; ++i) {  // source
-            if (role_from_denot.contains(std::make_pair(k, i))) {
-                for (int j = 0; j < num_objects; ++j) {  // target
-                    if (role_to_denot.contains(std::make_pair(k, j))) {
-                        result = std::min<int>(result, pairwise_distances[i][j]);
-                    }
-                }
+        const auto targets = role_to_denot.get_row(k);
+        if (targets.empty()) {
+            continue;
+        }
+        for (int i : role_from_denot.get_row(k)) {  // source
+            const int* distances = pairwise_distances.get_distances_from(i);
+            for (int j : targets) {  // target
+                result = std::min<int>(result, distances[j]);
             }
         }
     }
 }
 
 int RoleDistanceNumerical::evaluate_impl(const State& state, DenotationsCaches& caches) const {
-    auto role_from_denot = m_role_from->evaluate(state, caches);
-    if (role_from_denot->empty()) {
+    const auto& role_from_denot = m_role_from->evaluate_ref(state, caches);
+    if (role_from_denot.empty()) {
         return INF;
     }
-    auto role_to_denot = m_role_to->evaluate(state, caches);
-    if (role_to_denot->empty()) {
+    const auto& role_to_denot = m_role_to->evaluate_ref(state, caches);
+    if (role_to_denot.empty()) {
         return INF;
     }
     auto role_denot = m_role->evaluate(state, caches);
     int denotation;
-    compute_result(*role_from_denot, *role_denot, *role_to_denot, denotation);
+    compute_result(role_from_denot, utils::get_pairwise_distances(role_denot, caches), role_to_denot, denotation);
     return denotation;
 }
 
 NumericalDenotations RoleDistanceNumerical::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    NumericalDenotations denotations;
-    denotations.reserve(states.size());
+    NumericalDenotations denotations(states.size());
     auto role_from_denots = m_role_from->evaluate(states, caches);
     auto role_denots = m_role->evaluate(states, caches);
     auto role_to_denots = m_role_to->evaluate(states, caches);
-    for (size_t i = 0; i < states.size(); ++i) {
-        if ((*role_from_denots)[i]->empty()) {
-            denotations.push_back(INF);
-            continue;
-        }
-        if ((*role_to_denots)[i]->empty()) {
-            denotations.push_back(INF);
-            continue;
+    utils::for_each_state_range(states, caches, [&](size_t begin, size_t end) {
+        RoleDenotation role_from_denot(0);
+        RoleDenotation role_to_denot(0);
+        for (size_t i = begin; i < end; ++i) {
+            if (role_from_denots->empty(i)) {
+                denotations[i] = INF;
+                continue;
+            }
+            if (role_to_denots->empty(i)) {
+                denotations[i] = INF;
+                continue;
+            }
+            role_from_denots->load_row(i, role_from_denot);
+            role_to_denots->load_row(i, role_to_denot);
+            int denotation;
+            compute_result(
+                role_from_denot,
+                utils::get_pairwise_distances(caches.data.insert_unique(role_denots->get_denotation(i)), caches),
+                role_to_denot,
+                denotation);
+            denotations[i] = denotation;
         }
-        int denotation;
-        compute_result(
-            *(*role_from_denots)[i],
-            *(*role_denots)[i],
-            *(*role_to_denots)[i],
-            denotation);
-        denotations.push_back(denotation);
-    }
+    });
     return denotations;
 }
 
+int RoleDistanceNumerical::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &RoleDistanceNumerical::execute, {builder.compile(*m_role_from), builder.compile(*m_role), builder.compile(*m_role_to)});
+}
+
+void RoleDistanceNumerical::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+    const auto& role_from_denot = frame.get_role_denotation(instruction.arguments[0]);
+    const auto& role_to_denot = frame.get_role_denotation(instruction.arguments[2]);
+    int denotation;
+    if (role_from_denot.empty() || role_to_denot.empty()) {
+        denotation = INF;
+    } else {
+        auto& pairwise_distances = frame.get_pairwise_distances(instruction.result, frame.get_role_denotation(instruction.arguments[1]));
+        static_cast<const RoleDistanceNumerical*>(instruction.element)->compute_result(role_from_denot, pairwise_distances, role_to_denot, denotation);
+    }
+    frame.set_numerical_denotation(instruction.result, denotation);
+}
+
 RoleDistanceNumerical::RoleDistanceNumerical(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Role> role_from, std::shared_ptr<const Role> role, std::shared_ptr<const Role> role_to)
     : Numerical(index, vocabulary_info, role_from->is_static() && role->is_static() && role_to->is_static()),
         m_role_from(role_from), m_role(role), m_role_to(role_to) { }
@@ -89,8 +111,9 @@ int RoleDistanceNumerical::evaluate(const State& state) const {
         return INF;
     }
     auto role_denot = m_role->evaluate(state);
+    PairwiseDistances pairwise_distances(role_denot);
     int denotation;
-    compute_result(role_from_denot, role_denot, role_to_denot, denotation);
+    compute_result(role_from_denot, pairwise_distances, role_to_denot, denotation);
     return denotation;
 }
 
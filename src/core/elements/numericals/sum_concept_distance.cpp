@@ -5,58 +5,81 @@ namespace dlplan::core {
 void SumConceptDistanceNumerical::compute_result(const ConceptDenotation& concept_from_denot, const RoleDenotation& role_denot, const ConceptDenotation& concept_to_denot, int& result) const {
     result = 0;
     utils::Distances source_distances = utils::compute_multi_source_multi_target_shortest_distances(concept_from_denot, role_denot, concept_to_denot);
-    for (const auto target : concept_to_denot.to_vector()) {
+    for (const auto target : concept_to_denot) {
         result = utils::path_addition(result, source_distances[target]);
     }
 }
 
 int SumConceptDistanceNumerical::evaluate_impl(const State& state, DenotationsCaches& caches) const {
-    auto concept_from_denot = m_concept_from->evaluate(state, caches);
-    if (concept_from_denot->empty()) {
+    const auto& concept_from_denot = m_concept_from->evaluate_ref(state, caches);
+    if (concept_from_denot.empty()) {
         return INF;
     }
-    auto concept_to_denot = m_concept_to->evaluate(state, caches);
-    if (concept_to_denot->empty()) {
+    const auto& concept_to_denot = m_concept_to->evaluate_ref(state, caches);
+    if (concept_to_denot.empty()) {
         return INF;
     }
-    if (concept_from_denot->intersects(*concept_to_denot)) {
+    if (concept_from_denot.intersects(concept_to_denot)) {
         return 0;
     }
-    auto role_denot = m_role->evaluate(state, caches);
+    const auto& role_denot = m_role->evaluate_ref(state, caches);
     int denotation;
     compute_result(
-        *concept_from_denot,
-        *role_denot,
-        *concept_to_denot, denotation);
+        concept_from_denot,
+        role_denot,
+        concept_to_denot, denotation);
     return denotation;
 }
 
 NumericalDenotations SumConceptDistanceNumerical::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    NumericalDenotations denotations;
-    denotations.reserve(states.size());
+    NumericalDenotations denotations(states.size());
     auto concept_from_denots = m_concept_from->evaluate(states, caches);
     auto role_denots = m_role->evaluate(states, caches);
     auto concept_to_denots = m_concept_to->evaluate(states, caches);
-    for (size_t i = 0; i < states.size(); ++i) {
-        if ((*concept_from_denots)[i]->empty()) {
-            denotations.push_back(INF);
-            continue;
-        }
-        if ((*concept_to_denots)[i]->empty()) {
-            denotations.push_back(INF);
-            continue;
+    utils::for_each_state_range(states, caches, [&](size_t begin, size_t end) {
+        ConceptDenotation concept_from_denot(0);
+        RoleDenotation role_denot(0);
+        ConceptDenotation concept_to_denot(0);
+        for (size_t i = begin; i < end; ++i) {
+            if (concept_from_denots->empty(i)) {
+                denotations[i] = INF;
+                continue;
+            }
+            if (concept_to_denots->empty(i)) {
+                denotations[i] = INF;
+                continue;
+            }
+            concept_from_denots->load_row(i, concept_from_denot);
+            concept_to_denots->load_row(i, concept_to_denot);
+            role_denots->load_row(i, role_denot);
+            int denotation;
+            compute_result(
+                concept_from_denot,
+                role_denot,
+                concept_to_denot,
+                denotation);
+            denotations[i] = denotation;
         }
-        int denotation;
-        compute_result(
-            *(*concept_from_denots)[i],
-            *(*role_denots)[i],
-            *(*concept_to_denots)[i],
-            denotation);
-        denotations.push_back(denotation);
-    }
+    });
     return denotations;
 }
 
+int SumConceptDistanceNumerical::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &SumConceptDistanceNumerical::execute, {builder.compile(*m_concept_from), builder.compile(*m_role), builder.compile(*m_concept_to)});
+}
+
+void SumConceptDistanceNumerical::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+    const auto& concept_from_denot = frame.get_concept_denotation(instruction.arguments[0]);
+    const auto& concept_to_denot = frame.get_concept_denotation(instruction.arguments[2]);
+    int denotation;
+    if (concept_from_denot.empty() || concept_to_denot.empty()) {
+        denotation = INF;
+    } else {
+        static_cast<const SumConceptDistanceNumerical*>(instruction.element)->compute_result(concept_from_denot, frame.get_role_denotation(instruction.arguments[1]), concept_to_denot, denotation);
+    }
+    frame.set_numerical_denotation(instruction.result, denotation);
+}
+
 SumConceptDistanceNumerical::SumConceptDistanceNumerical(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Concept> concept_from, std::shared_ptr<const Role> role, std::shared_ptr<const Concept> concept_to)
     : Numerical(index, vocabulary_info, concept_from->is_static() && role->is_static() && concept_to->is_static()),
         m_concept_from(concept_from), m_role(role), m_concept_to(concept_to) { }
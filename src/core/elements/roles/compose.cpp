@@ -3,43 +3,53 @@
 
 namespace dlplan::core {
 void ComposeRole::compute_result(const RoleDenotation& left_denot, const RoleDenotation& right_denot, RoleDenotation& result) const {
-    // Compute sparse representation.
-    PairsOfObjectIndices left_pairs = left_denot.to_vector();
-    PairsOfObjectIndices right_pairs = right_denot.to_vector();
-    for (const auto& left_pair : left_pairs) {  // source
-        for (const auto& right_pair : right_pairs) {  // target
-            if (left_pair.second == right_pair.first) {
-                result.insert(std::make_pair(left_pair.first, right_pair.second));
-            }
-        }
-    }
+    utils::compute_composition(left_denot, right_denot, result);
 }
 
 RoleDenotation ComposeRole::evaluate_impl(const State& state, DenotationsCaches& caches) const {
     RoleDenotation denotation(state.get_instance_info()->get_objects().size());
     compute_result(
-        *m_role_left->evaluate(state, caches),
-        *m_role_right->evaluate(state, caches),
+        m_role_left->evaluate_ref(state, caches),
+        m_role_right->evaluate_ref(state, caches),
         denotation);
     return denotation;
 }
 
 RoleDenotations ComposeRole::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    RoleDenotations denotations;
-    denotations.reserve(states.size());
+    RoleDenotations denotations(states);
     auto role_left_denotations = m_role_left->evaluate(states, caches);
     auto role_right_denotations = m_role_right->evaluate(states, caches);
-    for (size_t i = 0; i < states.size(); ++i) {
-        RoleDenotation denotation(states[i].get_instance_info()->get_objects().size());
-        compute_result(
-            *(*role_left_denotations)[i],
-            *(*role_right_denotations)[i],
-            denotation);
-        denotations.push_back(caches.data.insert_unique(std::move(denotation)));
-    }
+    utils::for_each_state_range(states, caches, [&](size_t begin, size_t end) {
+        RoleDenotation role_left_denotation(0);
+        RoleDenotation role_right_denotation(0);
+        RoleDenotation denotation(0);
+        for (size_t i = begin; i < end; ++i) {
+            role_left_denotations->load_row(i, role_left_denotation);
+            role_right_denotations->load_row(i, role_right_denotation);
+            denotations.reset_denotation(i, denotation);
+            compute_result(
+                role_left_denotation,
+                role_right_denotation,
+                denotation);
+            denotations.store_row(i, denotation);
+        }
+    });
     return denotations;
 }
 
+int ComposeRole::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &ComposeRole::execute, {builder.compile(*m_role_left), builder.compile(*m_role_right)});
+}
+
+void ComposeRole::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+    auto& result = frame.get_role_denotation(instruction.result);
+    result.clear();
+    static_cast<const ComposeRole*>(instruction.element)->compute_result(
+        frame.get_role_denotation(instruction.arguments[0]),
+        frame.get_role_denotation(instruction.arguments[1]),
+        result);
+}
+
 ComposeRole::ComposeRole(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Role> role_left, std::shared_ptr<const Role> role_right)
     : Role(index, vocabulary_info, role_left->is_static() && role_right->is_static()), m_role_left(role_left), m_role_right(role_right)  { }
 
@@ -10,28 +10,40 @@ void DiffRole::compute_result(const RoleDenotation& left_denot, const RoleDenota
 RoleDenotation DiffRole::evaluate_impl(const State& state, DenotationsCaches& caches) const {
     RoleDenotation denotation(state.get_instance_info()->get_objects().size());
     compute_result(
-        *m_role_left->evaluate(state, caches),
-        *m_role_right->evaluate(state, caches),
+        m_role_left->evaluate_ref(state, caches),
+        m_role_right->evaluate_ref(state, caches),
         denotation);
     return denotation;
 }
 
 RoleDenotations DiffRole::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    RoleDenotations denotations;
-    denotations.reserve(states.size());
     auto role_left_denotations = m_role_left->evaluate(states, caches);
     auto role_right_denotations = m_role_right->evaluate(states, caches);
-    for (size_t i = 0; i < states.size(); ++i) {
-        RoleDenotation denotation(states[i].get_instance_info()->get_objects().size());
-        compute_result(
-            *(*role_left_denotations)[i],
-            *(*role_right_denotations)[i],
-            denotation);
-        denotations.push_back(caches.data.insert_unique(std::move(denotation)));
-    }
+    RoleDenotations denotations(*role_left_denotations);
+    denotations -= *role_right_denotations;
     return denotations;
 }
 
+ObjectHandle DiffRole::evaluate_delta_impl(const StateDelta& delta, ObjectHandle parent_handle, DenotationsCaches& caches) const {
+    if (utils::is_unchanged(*m_role_left, delta, caches)
+        && utils::is_unchanged(*m_role_right, delta, caches)) {
+        return parent_handle;
+    }
+    return caches.data.insert(evaluate_impl(delta.get_state(), caches));
+}
+
+int DiffRole::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &DiffRole::execute, {builder.compile(*m_role_left), builder.compile(*m_role_right)});
+}
+
+void DiffRole::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+    auto& result = frame.get_role_denotation(instruction.result);
+    static_cast<const DiffRole*>(instruction.element)->compute_result(
+        frame.get_role_denotation(instruction.arguments[0]),
+        frame.get_role_denotation(instruction.arguments[1]),
+        result);
+}
+
 DiffRole::DiffRole(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Role> role_left, std::shared_ptr<const Role> role_right)
     : Role(index, vocabulary_info, (role_left->is_static() && role_right->is_static())), m_role_left(role_left), m_role_right(role_right)  { }
 
@@ -3,7 +3,7 @@
 
 namespace dlplan::core {
 void IdentityRole::compute_result(const ConceptDenotation& denot, RoleDenotation& result) const {
-    for (const auto& single : denot.to_vector()) {
+    for (const auto& single : denot) {
         result.insert(std::make_pair(single, single));
     }
 }
@@ -11,25 +11,41 @@ void IdentityRole::compute_result(const ConceptDenotation& denot, RoleDenotation
 RoleDenotation IdentityRole::evaluate_impl(const State& state, DenotationsCaches& caches) const {
     RoleDenotation denotation(state.get_instance_info()->get_objects().size());
     compute_result(
-        *m_concept->evaluate(state, caches),
+        m_concept->evaluate_ref(state, caches),
         denotation);
     return denotation;
 }
 
 RoleDenotations IdentityRole::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    RoleDenotations denotations;
-    denotations.reserve(states.size());
+    RoleDenotations denotations(states);
     auto concept_denotations = m_concept->evaluate(states, caches);
-    for (size_t i = 0; i < states.size(); ++i) {
-        RoleDenotation denotation(states[i].get_instance_info()->get_objects().size());
-        compute_result(
-            *(*concept_denotations)[i],
-            denotation);
-        denotations.push_back(caches.data.insert_unique(std::move(denotation)));
-    }
+    utils::for_each_state_range(states, caches, [&](size_t begin, size_t end) {
+        ConceptDenotation concept_denotation(0);
+        RoleDenotation denotation(0);
+        for (size_t i = begin; i < end; ++i) {
+            concept_denotations->load_row(i, concept_denotation);
+            denotations.reset_denotation(i, denotation);
+            compute_result(
+                concept_denotation,
+                denotation);
+            denotations.store_row(i, denotation);
+        }
+    });
     return denotations;
 }
 
+int IdentityRole::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &IdentityRole::execute, {builder.compile(*m_concept)});
+}
+
+void IdentityRole::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+    auto& result = frame.get_role_denotation(instruction.result);
+    result.clear();
+    static_cast<const IdentityRole*>(instruction.element)->compute_result(
+        frame.get_concept_denotation(instruction.arguments[0]),
+        result);
+}
+
 IdentityRole::IdentityRole(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Concept> concept_)
     : Role(index, vocabulary_info, concept_->is_static()), m_concept(concept_) { }
 
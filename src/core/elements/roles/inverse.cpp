@@ -3,33 +3,46 @@
 
 namespace dlplan::core {
 void InverseRole::compute_result(const RoleDenotation& denot, RoleDenotation& result) const {
-    for (const auto& pair : denot.to_vector()) {
-        result.insert(std::make_pair(pair.second, pair.first));
-    }
+    result = denot.transpose();
 }
 
 RoleDenotation InverseRole::evaluate_impl(const State& state, DenotationsCaches& caches) const {
     RoleDenotation denotation(state.get_instance_info()->get_objects().size());
     compute_result(
-        *m_role->evaluate(state, caches),
+        m_role->evaluate_ref(state, caches),
         denotation);
     return denotation;
 }
 
 RoleDenotations InverseRole::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    RoleDenotations denotations;
-    denotations.reserve(states.size());
+    RoleDenotations denotations(states);
     auto role_denotations = m_role->evaluate(states, caches);
-    for (size_t i = 0; i < states.size(); ++i) {
-        RoleDenotation denotation(states[i].get_instance_info()->get_objects().size());
-        compute_result(
-            *(*role_denotations)[i],
-            denotation);
-        denotations.push_back(caches.data.insert_unique(std::move(denotation)));
-    }
+    utils::for_each_state_range(states, caches, [&](size_t begin, size_t end) {
+        RoleDenotation role_denotation(0);
+        RoleDenotation denotation(0);
+        for (size_t i = begin; i < end; ++i) {
+            role_denotations->load_row(i, role_denotation);
+            denotations.reset_denotation(i, denotation);
+            compute_result(
+                role_denotation,
+                denotation);
+            denotations.store_row(i, denotation);
+        }
+    });
     return denotations;
 }
 
+int InverseRole::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &InverseRole::execute, {builder.compile(*m_role)});
+}
+
+void InverseRole::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+    auto& result = frame.get_role_denotation(instruction.result);
+    static_cast<const InverseRole*>(instruction.element)->compute_result(
+        frame.get_role_denotation(instruction.arguments[0]),
+        result);
+}
+
 InverseRole::InverseRole(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Role> role)
     : Role(index, vocabulary_info, role->is_static()), m_role(role) { }
 
@@ -10,25 +10,47 @@ void NotRole::compute_result(const RoleDenotation& denot, RoleDenotation& result
 RoleDenotation NotRole::evaluate_impl(const State& state, DenotationsCaches& caches) const {
     RoleDenotation denotation(state.get_instance_info()->get_objects().size());
     compute_result(
-        *m_role->evaluate(state, caches),
+        m_role->evaluate_ref(state, caches),
         denotation);
     return denotation;
 }
 
 RoleDenotations NotRole::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    RoleDenotations denotations;
-    denotations.reserve(states.size());
+    RoleDenotations denotations(states);
     auto role_denotations = m_role->evaluate(states, caches);
-    for (size_t i = 0; i < states.size(); ++i) {
-        RoleDenotation denotation(states[i].get_instance_info()->get_objects().size());
-        compute_result(
-            *(*role_denotations)[i],
-            denotation);
-        denotations.push_back(caches.data.insert_unique(std::move(denotation)));
-    }
+    utils::for_each_state_range(states, caches, [&](size_t begin, size_t end) {
+        RoleDenotation role_denotation(0);
+        RoleDenotation denotation(0);
+        for (size_t i = begin; i < end; ++i) {
+            role_denotations->load_row(i, role_denotation);
+            denotations.reset_denotation(i, denotation);
+            compute_result(
+                role_denotation,
+                denotation);
+            denotations.store_row(i, denotation);
+        }
+    });
     return denotations;
 }
 
+ObjectHandle NotRole::evaluate_delta_impl(const StateDelta& delta, ObjectHandle parent_handle, DenotationsCaches& caches) const {
+    if (utils::is_unchanged(*m_role, delta, caches)) {
+        return parent_handle;
+    }
+    return caches.data.insert(evaluate_impl(delta.get_state(), caches));
+}
+
+int NotRole::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &NotRole::execute, {builder.compile(*m_role)});
+}
+
+void NotRole::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+    auto& result = frame.get_role_denotation(instruction.result);
+    static_cast<const NotRole*>(instruction.element)->compute_result(
+        frame.get_role_denotation(instruction.arguments[0]),
+        result);
+}
+
 NotRole::NotRole(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Role> role)
     : Role(index, vocabulary_info, role->is_static()), m_role(role) { }
 
@@ -2,52 +2,110 @@
 
 #include "../../../utils/collections.h"
 
+#include <algorithm>
+
 
 using namespace std::string_literals;
 
 
 namespace dlplan::core {
-void PrimitiveRole::compute_result(const State& state, RoleDenotation& result) const {
-    const auto& instance_info = *state.get_instance_info();
-    const auto& atoms = instance_info.get_atoms();
-    for (int atom_idx : state.get_atom_indices()) {
+void PrimitiveRole::insert_pairs(const std::vector<Atom>& atoms, std::span<const AtomIndex> atom_indices, RoleDenotation& result) const {
+    for (int atom_idx : atom_indices) {
         const auto& atom = atoms[atom_idx];
-        if (atom.get_predicate_index() == m_predicate.get_index()) {
-            assert(dlplan::utils::in_bounds(m_pos_1, atom.get_object_indices()));
-            assert(dlplan::utils::in_bounds(m_pos_2, atom.get_object_indices()));
-            result.insert(std::make_pair(atom.get_object_indices()[m_pos_1], atom.get_object_indices()[m_pos_2]));
-        }
+        assert(atom.get_predicate_index() == m_predicate.get_index());
+        assert(dlplan::utils::in_bounds(m_pos_1, atom.get_object_indices()));
+        assert(dlplan::utils::in_bounds(m_pos_2, atom.get_object_indices()));
+        result.insert(std::make_pair(atom.get_object_indices()[m_pos_1], atom.get_object_indices()[m_pos_2]));
     }
-    for (const auto& atom : state.get_instance_info()->get_static_atoms()) {
-        if (atom.get_predicate_index() == m_predicate.get_index()) {
-            assert(dlplan::utils::in_bounds(m_pos_1, atom.get_object_indices()));
-            assert(dlplan::utils::in_bounds(m_pos_2, atom.get_object_indices()));
-            result.insert(std::make_pair(atom.get_object_indices()[m_pos_1], atom.get_object_indices()[m_pos_2]));
-        }
+}
+
+void PrimitiveRole::insert_static_pairs(const InstanceInfo& instance_info, RoleDenotation& result, DenotationsCaches& caches) const {
+    const auto& static_atom_indices = instance_info.get_static_atom_indices_of_predicate(m_predicate.get_index());
+    if (static_atom_indices.empty()) {
+        return;
     }
+    if (m_is_static) {
+        insert_pairs(instance_info.get_static_atoms(), static_atom_indices, result);
+        return;
+    }
+    auto key = DenotationsCacheKey{ get_index(), instance_info.get_index(), -1 };
+    auto handle = caches.static_atom_denotations.get_handle<RoleDenotation>(key);
+    if (handle == UNDEFINED_HANDLE) {
+        RoleDenotation denotation(instance_info.get_objects().size());
+        insert_pairs(instance_info.get_static_atoms(), static_atom_indices, denotation);
+        handle = caches.static_atom_denotations.insert_mapping<RoleDenotation>(key, caches.static_atom_denotations.insert(std::move(denotation)));
+    }
+    result |= caches.static_atom_denotations.get_object<RoleDenotation>(handle);
 }
 
-RoleDenotation PrimitiveRole::evaluate_impl(const State& state, DenotationsCaches&) const {
-    RoleDenotation denotation(state.get_instance_info()->get_objects().size());
-    compute_result(
-        state,
-        denotation);
+void PrimitiveRole::compute_result(const State& state, RoleDenotation& result) const {
+    const auto& instance_info = *state.get_instance_info();
+    insert_pairs(instance_info.get_atoms(), state.get_atom_indices_of_predicate(m_predicate.get_index()), result);
+    insert_pairs(instance_info.get_static_atoms(), instance_info.get_static_atom_indices_of_predicate(m_predicate.get_index()), result);
+}
+
+RoleDenotation PrimitiveRole::evaluate_impl(const State& state, DenotationsCaches& caches) const {
+    const auto& instance_info = *state.get_instance_info();
+    RoleDenotation denotation(instance_info.get_objects().size());
+    insert_static_pairs(instance_info, denotation, caches);
+    insert_pairs(instance_info.get_atoms(), state.get_atom_indices_of_predicate(m_predicate.get_index()), denotation);
     return denotation;
 }
 
 RoleDenotations PrimitiveRole::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    RoleDenotations denotations;
-    denotations.reserve(states.size());
-    for (size_t i = 0; i < states.size(); ++i) {
-        RoleDenotation denotation(states[i].get_instance_info()->get_objects().size());
-        compute_result(
-            states[i],
-            denotation);
-        denotations.push_back(caches.data.insert_unique(std::move(denotation)));
-    }
+    RoleDenotations denotations(states);
+    utils::for_each_state_range(states, caches, [&](size_t begin, size_t end) {
+        RoleDenotation denotation(0);
+        for (size_t i = begin; i < end; ++i) {
+            const auto& instance_info = *states[i].get_instance_info();
+            denotations.reset_denotation(i, denotation);
+            insert_static_pairs(instance_info, denotation, caches);
+            insert_pairs(instance_info.get_atoms(), states[i].get_atom_indices_of_predicate(m_predicate.get_index()), denotation);
+            denotations.store_row(i, denotation);
+        }
+    });
     return denotations;
 }
 
+ObjectHandle PrimitiveRole::evaluate_delta_impl(const StateDelta& delta, ObjectHandle parent_handle, DenotationsCaches& caches) const {
+    const auto& atoms = delta.get_state().get_instance_info()->get_atoms();
+    auto has_predicate = [&](int atom_idx) { return atoms[atom_idx].get_predicate_index() == m_predicate.get_index(); };
+    const auto& added_atoms = delta.get_added_atoms();
+    const auto& deleted_atoms = delta.get_deleted_atoms();
+    bool is_added = std::any_of(added_atoms.begin(), added_atoms.end(), has_predicate);
+    bool is_deleted = std::any_of(deleted_atoms.begin(), deleted_atoms.end(), has_predicate);
+    if (!is_added && !is_deleted) {
+        return parent_handle;
+    }
+    if (is_deleted && (m_predicate.get_arity() > 2 || m_pos_1 == m_pos_2)) {
+        // another atom might still contain the pair at m_pos_1 and m_pos_2
+        return caches.data.insert(evaluate_impl(delta.get_state(), caches));
+    }
+    RoleDenotation denotation(caches.data.get_object<RoleDenotation>(parent_handle));
+    for (int atom_idx : deleted_atoms) {
+        if (has_predicate(atom_idx)) {
+            const auto& object_indices = atoms[atom_idx].get_object_indices();
+            denotation.erase(std::make_pair(object_indices[m_pos_1], object_indices[m_pos_2]));
+        }
+    }
+    for (int atom_idx : added_atoms) {
+        if (has_predicate(atom_idx)) {
+            const auto& object_indices = atoms[atom_idx].get_object_indices();
+            denotation.insert(std::make_pair(object_indices[m_pos_1], object_indices[m_pos_2]));
+        }
+    }
+    return caches.data.insert(std::move(denotation));
+}
+
+int PrimitiveRole::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &PrimitiveRole::execute);
+}
+
+void PrimitiveRole::execute(const EvaluationInstruction& instruction, const State& state, EvaluationFrame& frame) {
+    auto& result = frame.get_role_denotation(instruction.result);
+    result.clear();
+    static_cast<const PrimitiveRole*>(instruction.element)->compute_result(state, result);
+}
 
 PrimitiveRole::PrimitiveRole(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, const Predicate& predicate, int pos_1, int pos_2)
 : Role(index, vocabulary_info, predicate.is_static()), m_predicate(predicate), m_pos_1(pos_1), m_pos_2(pos_2) {
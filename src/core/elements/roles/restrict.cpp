@@ -4,38 +4,54 @@
 namespace dlplan::core {
 void RestrictRole::compute_result(const RoleDenotation& role_denot, const ConceptDenotation& concept_denot, RoleDenotation& result) const {
     result = role_denot;
-    for (const auto& pair : role_denot.to_vector()) {
-        if (!concept_denot.contains(pair.second)) {
-            result.erase(pair);
-        }
+    for (int i = 0; i < role_denot.get_num_objects(); ++i) {
+        result.intersect_row(i, concept_denot);
     }
 }
 
 RoleDenotation RestrictRole::evaluate_impl(const State& state, DenotationsCaches& caches) const {
     RoleDenotation denotation(state.get_instance_info()->get_objects().size());
     compute_result(
-        *m_role->evaluate(state, caches),
-        *m_concept->evaluate(state, caches),
+        m_role->evaluate_ref(state, caches),
+        m_concept->evaluate_ref(state, caches),
         denotation);
     return denotation;
 }
 
 RoleDenotations RestrictRole::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    RoleDenotations denotations;
-    denotations.reserve(states.size());
+    RoleDenotations denotations(states);
     auto role_denotations = m_role->evaluate(states, caches);
     auto concept_denotations = m_concept->evaluate(states, caches);
-    for (size_t i = 0; i < states.size(); ++i) {
-        RoleDenotation denotation(states[i].get_instance_info()->get_objects().size());
-        compute_result(
-            *(*role_denotations)[i],
-            *(*concept_denotations)[i],
-            denotation);
-        denotations.push_back(caches.data.insert_unique(std::move(denotation)));
-    }
+    utils::for_each_state_range(states, caches, [&](size_t begin, size_t end) {
+        RoleDenotation role_denotation(0);
+        ConceptDenotation concept_denotation(0);
+        RoleDenotation denotation(0);
+        for (size_t i = begin; i < end; ++i) {
+            role_denotations->load_row(i, role_denotation);
+            concept_denotations->load_row(i, concept_denotation);
+            denotations.reset_denotation(i, denotation);
+            compute_result(
+                role_denotation,
+                concept_denotation,
+                denotation);
+            denotations.store_row(i, denotation);
+        }
+    });
     return denotations;
 }
 
+int RestrictRole::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &RestrictRole::execute, {builder.compile(*m_role), builder.compile(*m_concept)});
+}
+
+void RestrictRole::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+    auto& result = frame.get_role_denotation(instruction.result);
+    static_cast<const RestrictRole*>(instruction.element)->compute_result(
+        frame.get_role_denotation(instruction.arguments[0]),
+        frame.get_concept_denotation(instruction.arguments[1]),
+        result);
+}
+
 RestrictRole::RestrictRole(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Role> role, std::shared_ptr<const Concept> concept_)
 : Role(index, vocabulary_info, role->is_static() && concept_->is_static()), m_role(role), m_concept(concept_) { }
 
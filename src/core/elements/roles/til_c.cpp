@@ -5,15 +5,13 @@ namespace dlplan::core
 
     void TilCRole::compute_result(const RoleDenotation &role_denot, const ConceptDenotation &concept_denot, RoleDenotation &result) const
     {
-        auto concept_object_indicies = concept_denot.to_vector();
-
-        std::unordered_set<ObjectIndex> current(concept_object_indicies.begin(), concept_object_indicies.end()), next;
-        std::unordered_set<ObjectIndex> visited(concept_object_indicies.begin(), concept_object_indicies.end());
+        std::unordered_set<ObjectIndex> current(concept_denot.begin(), concept_denot.end()), next;
+        std::unordered_set<ObjectIndex> visited(concept_denot.begin(), concept_denot.end());
 
         std::unordered_map<ObjectIndex, std::unordered_set<ObjectIndex>> inv_edges;
 
-        for(auto& pair : role_denot.to_vector()) {
-            auto& [from, to] = pair;
+        for(const auto& pair : role_denot) {
+            const auto& [from, to] = pair;
             inv_edges[to].insert(from);
         }
 
@@ -36,30 +34,52 @@ namespace dlplan::core
     {
         RoleDenotation denotation(state.get_instance_info()->get_objects().size());
         compute_result(
-            *m_role->evaluate(state, caches),
-            *m_concept->evaluate(state, caches),
+            m_role->evaluate_ref(state, caches),
+            m_concept->evaluate_ref(state, caches),
             denotation);
         return denotation;
     }
 
     RoleDenotations TilCRole::evaluate_impl(const States &states, DenotationsCaches &caches) const
     {
-        RoleDenotations denotations;
-        denotations.reserve(states.size());
+        RoleDenotations denotations(states);
         auto role_denotations = m_role->evaluate(states, caches);
         auto concept_denotations = m_concept->evaluate(states, caches);
-        for (size_t i = 0; i < states.size(); ++i)
+        utils::for_each_state_range(states, caches, [&](size_t begin, size_t end)
         {
-            RoleDenotation denotation(states[i].get_instance_info()->get_objects().size());
-            compute_result(
-                *(*role_denotations)[i],
-                *(*concept_denotations)[i],
-                denotation);
-            denotations.push_back(caches.data.insert_unique(std::move(denotation)));
-        }
+            RoleDenotation role_denotation(0);
+            ConceptDenotation concept_denotation(0);
+            RoleDenotation denotation(0);
+            for (size_t i = begin; i < end; ++i)
+            {
+                role_denotations->load_row(i, role_denotation);
+                concept_denotations->load_row(i, concept_denotation);
+                denotations.reset_denotation(i, denotation);
+                compute_result(
+                    role_denotation,
+                    concept_denotation,
+                    denotation);
+                denotations.store_row(i, denotation);
+            }
+        });
         return denotations;
     }
 
+    int TilCRole::compile_impl(EvaluationPlanBuilder& builder) const
+    {
+        return builder.add_instruction(*this, &TilCRole::execute, {builder.compile(*m_role), builder.compile(*m_concept)});
+    }
+
+    void TilCRole::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame)
+    {
+        auto& result = frame.get_role_denotation(instruction.result);
+        result.clear();
+        static_cast<const TilCRole*>(instruction.element)->compute_result(
+            frame.get_role_denotation(instruction.arguments[0]),
+            frame.get_concept_denotation(instruction.arguments[1]),
+            result);
+    }
+
     TilCRole::TilCRole(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Role> role, std::shared_ptr<const Concept> concept_)
         : Role(index, vocabulary_info, role->is_static() && concept_->is_static()),
           m_role(role), m_concept(concept_) {}
@@ -8,17 +8,25 @@ RoleDenotation TopRole::evaluate_impl(const State& state, DenotationsCaches&) co
     return denotation;
 }
 
-RoleDenotations TopRole::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    RoleDenotations denotations;
-    denotations.reserve(states.size());
+RoleDenotations TopRole::evaluate_impl(const States& states, DenotationsCaches&) const {
+    RoleDenotations denotations(states);
+    RoleDenotation denotation(0);
     for (size_t i = 0; i < states.size(); ++i) {
-        RoleDenotation denotation(states[i].get_instance_info()->get_objects().size());
+        denotations.reset_denotation(i, denotation);
         denotation.set();
-        denotations.push_back(caches.data.insert_unique(std::move(denotation)));
+        denotations.store_row(i, denotation);
     }
     return denotations;
 }
 
+int TopRole::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &TopRole::execute);
+}
+
+void TopRole::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+    frame.get_role_denotation(instruction.result).set();
+}
+
 TopRole::TopRole(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info)
     : Role(index, vocabulary_info, true) { }
 
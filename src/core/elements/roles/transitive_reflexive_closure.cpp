@@ -4,19 +4,7 @@
 namespace dlplan::core {
 void TransitiveReflexiveClosureRole::compute_result(const RoleDenotation& denot, int num_objects, RoleDenotation& result) const {
     result = denot;
-    bool changed = false;
-    do {
-        RoleDenotation tmp_result = result;
-        PairsOfObjectIndices pairs = tmp_result.to_vector();
-        for (const auto& pair_1 : pairs) {
-            for (const auto& pair_2 : pairs) {
-                if (pair_1.second == pair_2.first) {
-                    result.insert(std::make_pair(pair_1.first, pair_2.second));
-                }
-            }
-        }
-        changed = (result.size() != tmp_result.size());
-    } while (changed);
+    utils::compute_transitive_closure(result);
     // add reflexive part
     for (int i = 0; i < num_objects; ++i) {
         result.insert(std::make_pair(i, i));
@@ -26,27 +14,43 @@ void TransitiveReflexiveClosureRole::compute_result(const RoleDenotation& denot,
 RoleDenotation TransitiveReflexiveClosureRole::evaluate_impl(const State& state, DenotationsCaches& caches) const {
     RoleDenotation denotation(state.get_instance_info()->get_objects().size());
     compute_result(
-        *m_role->evaluate(state, caches),
+        m_role->evaluate_ref(state, caches),
         state.get_instance_info()->get_objects().size(),
         denotation);
     return denotation;
 }
 
 RoleDenotations TransitiveReflexiveClosureRole::evaluate_impl(const States& states, DenotationsCaches& caches) const {
-    RoleDenotations denotations;
-    denotations.reserve(states.size());
+    RoleDenotations denotations(states);
     auto role_denotations = m_role->evaluate(states, caches);
-    for (size_t i = 0; i < states.size(); ++i) {
-        RoleDenotation denotation(states[i].get_instance_info()->get_objects().size());
-        compute_result(
-            *(*role_denotations)[i],
-            states[i].get_instance_info()->get_objects().size(),
-            denotation);
-        denotations.push_back(caches.data.insert_unique(std::move(denotation)));
-    }
+    utils::for_each_state_range(states, caches, [&](size_t begin, size_t end) {
+        RoleDenotation role_denotation(0);
+        RoleDenotation denotation(0);
+        for (size_t i = begin; i < end; ++i) {
+            role_denotations->load_row(i, role_denotation);
+            denotations.reset_denotation(i, denotation);
+            compute_result(
+                role_denotation,
+                states[i].get_instance_info()->get_objects().size(),
+                denotation);
+            denotations.store_row(i, denotation);
+        }
+    });
     return denotations;
 }
 
+int TransitiveReflexiveClosureRole::compile_impl(EvaluationPlanBuilder& builder) const {
+    return builder.add_instruction(*this, &TransitiveReflexiveClosureRole::execute, {builder.compile(*m_role)});
+}
+
+void TransitiveReflexiveClosureRole::execute(const EvaluationInstruction& instruction, const State&, EvaluationFrame& frame) {
+    auto& result = frame.get_role_denotation(instruction.result);
+    static_cast<const TransitiveReflexiveClosureRole*>(instruction.element)->compute_result(
+        frame.get_role_denotation(instruction.arguments[0]),
+        result.get_num_objects(),
+        result);
+}
+
 TransitiveReflexiveClosureRole::TransitiveReflexiveClosureRole(ElementIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info, std::shared_ptr<const Role> role)
     : Role(index, vocabulary_info, role->is_static()), m_role(role) { }
 
@@ -1,12 +1,80 @@
 #include "../../../include/dlplan/core/elements/utils.h"
 
-#include <deque>
+#include "../../utils/threadpool.h"
+
+#include <algorithm>
+#include <bit>
 #include <iostream>
+#include <utility>
 
 
-namespace dlplan::core::utils {
+namespace dlplan::core {
+PairwiseDistances::PairwiseDistances(const RoleDenotation& edges, bool thread_safe)
+    : m_edges(&edges),
+      m_num_objects(edges.get_num_objects()),
+      m_distances(static_cast<std::size_t>(m_num_objects) * m_num_objects, INF),
+      m_computed_sources(m_num_objects),
+      m_visited(m_num_objects),
+      m_frontier(m_num_objects),
+      m_next(m_num_objects),
+      m_thread_safe(thread_safe) { }
+
+void PairwiseDistances::reset(const RoleDenotation& edges) {
+    m_edges = &edges;
+    int num_objects = edges.get_num_objects();
+    if (num_objects != m_num_objects) {
+        m_num_objects = num_objects;
+        m_distances.assign(static_cast<std::size_t>(m_num_objects) * m_num_objects, INF);
+        m_computed_sources = ConceptDenotation(m_num_objects);
+        m_visited = ConceptDenotation(m_num_objects);
+        m_frontier = ConceptDenotation(m_num_objects);
+        m_next = ConceptDenotation(m_num_objects);
+        return;
+    }
+    for (int source : m_computed_sources) {
+        auto row = m_distances.begin() + static_cast<std::size_t>(source) * m_num_objects;
+        std::fill(row, row + m_num_objects, INF);
+    }
+    m_computed_sources.clear();
+}
+
+
+const int* PairwiseDistances::get_distances_from(ObjectIndex source) {
+    int* distances = m_distances.data() + static_cast<std::size_t>(source) * m_num_objects;
+    // rows never move, hence the lock only needs to cover their computation
+    std::unique_lock lock(m_mutex, std::defer_lock);
+    if (m_thread_safe) lock.lock();
+    if (m_computed_sources.contains(source)) {
+        return distances;
+    }
+    m_computed_sources.insert(source);
+    distances[source] = 0;
+    m_visited.clear();
+    m_visited.insert(source);
+    m_frontier.clear();
+    m_frontier.insert(source);
+    for (int distance = 1; ; ++distance) {
+        m_next.clear();
+        for (int object : m_frontier) {
+            m_next |= m_edges->get_row(object);
+        }
+        m_next -= m_visited;
+        if (m_next.empty()) {
+            break;
+        }
+        for (int target : m_next) {
+            distances[target] = distance;
+        }
+        m_visited |= m_next;
+        std::swap(m_frontier, m_next);
+    }
+    return distances;
+}
+
+}
+
 
-using AdjList = std::vector<std::vector<int>>;
+namespace dlplan::core::utils {
 
 int path_addition(int a, int b) {
     if (a == INF || b == INF) {
@@ -21,115 +89,168 @@ int path_addition(int a, int b) {
 }
 
 
-AdjList compute_adjacency_list(const RoleDenotation& role_denot, bool forward=true) {
-    int num_objects = role_denot.get_num_objects();
-    AdjList adjacency_list(num_objects);
-    for (const auto& pair : role_denot.to_vector()) {
-        if (forward) adjacency_list[pair.first].push_back(pair.second);
-        else adjacency_list[pair.second].push_back(pair.first);
+int compute_multi_source_multi_target_shortest_distance(const ConceptDenotation& sources, const RoleDenotation& edges, const ConceptDenotation& targets) {
+    if (sources.intersects(targets)) {
+        return 0;
     }
-    return adjacency_list;
-}
-
-
-Distances compute_distances_from_state(const AdjList& adj_list, int source) {
-    Distances distances(adj_list.size(), INF);
-    distances[source] = 0;
-    std::deque<int> queue;
-    queue.push_back(source);
-    while (!queue.empty()) {
-        int s = queue.front();
-        queue.pop_front();
-        for (int t : adj_list[s]) {
-            int alt = distances[s] + 1;
-            if (distances[t] > alt) {
-                queue.push_back(t);
-                distances[t] = alt;
-            }
+    int num_objects = targets.get_num_objects();
+    ConceptDenotation visited = sources;
+    ConceptDenotation frontier = sources;
+    ConceptDenotation next(num_objects);
+    for (int distance = 1; ; ++distance) {
+        // next frontier: successors of the frontier that were not visited before
+        next.clear();
+        for (int source : frontier) {
+            next |= edges.get_row(source);
+        }
+        next -= visited;
+        if (next.empty()) {
+            return INF;
         }
+        if (next.intersects(targets)) {
+            return distance;
+        }
+        visited |= next;
+        std::swap(frontier, next);
     }
-    return distances;
 }
 
 
-int compute_multi_source_multi_target_shortest_distance(const ConceptDenotation& sources, const RoleDenotation& edges, const ConceptDenotation& targets) {
+Distances compute_multi_source_multi_target_shortest_distances(const ConceptDenotation& sources, const RoleDenotation& edges, const ConceptDenotation& targets) {
     int num_objects = targets.get_num_objects();
     Distances distances(num_objects, INF);
-    std::deque<int> queue;
-    for (int source : sources.to_vector()) {
+    for (int source : sources) {
         distances[source] = 0;
-        queue.push_back(source);
-        if (targets.contains(source)) {
-            return 0;
+    }
+    ConceptDenotation visited = sources;
+    ConceptDenotation frontier = sources;
+    ConceptDenotation next(num_objects);
+    for (int distance = 1; !targets.is_subset_of(visited); ++distance) {
+        next.clear();
+        for (int source : frontier) {
+            next |= edges.get_row(source);
+        }
+        next -= visited;
+        if (next.empty()) {
+            break;
         }
+        for (int target : next) {
+            distances[target] = distance;
+        }
+        visited |= next;
+        std::swap(frontier, next);
     }
-    while (!queue.empty()) {
-        int source = queue.front();
-        queue.pop_front();
-        for (int target = 0; target < num_objects; ++target) {
-            if (edges.contains(std::make_pair(source,target))) {
-                int alt = distances[source] + 1;
-                if (distances[target] > alt) {
-                    if (targets.contains(target)) {
-                        return alt;
-                    }
-                    queue.push_back(target);
-                    distances[target] = alt;
-                }
+    return distances;
+}
+
+
+PairwiseDistances& get_pairwise_distances(const std::shared_ptr<const RoleDenotation>& edges, DenotationsCaches& caches) {
+    bool thread_safe = caches.data.is_thread_safe();
+    std::unique_lock lock(*caches.pairwise_distances_mutex, std::defer_lock);
+    if (thread_safe) lock.lock();
+    auto& result = caches.pairwise_distances[edges];
+    if (!result) {
+        result = std::make_unique<PairwiseDistances>(*edges, thread_safe);
+        caches.pairwise_distances_num_bytes += sizeof(PairwiseDistances) + static_cast<std::size_t>(edges->get_num_objects()) * edges->get_num_objects() * sizeof(int);
+    }
+    return *result;
+}
+
+
+void for_each_state_range(const States& states, const DenotationsCaches& caches, const std::function<void(std::size_t, std::size_t)>& body) {
+    int num_threads = caches.get_num_threads();
+    if (num_threads == 1) {
+        body(0, states.size());
+        return;
+    }
+    // several ranges per thread balance states of different sizes
+    std::size_t range_size = std::max<std::size_t>(1, states.size() / (4 * num_threads));
+    dlplan::utils::threadpool::parallel_for(states.size(), range_size, num_threads, body);
+}
+
+
+void compute_transitive_closure(RoleDenotation& relation) {
+    int num_objects = relation.get_num_objects();
+    // after iteration k, (i,j) is in the relation iff there is a path
+    // from i to j whose intermediate objects are all smaller or equal than k.
+    for (int k = 0; k < num_objects; ++k) {
+        const auto row_k = relation.get_row(k);
+        if (row_k.empty()) {
+            continue;
+        }
+        for (int i = 0; i < num_objects; ++i) {
+            if (relation.contains(std::make_pair(i, k))) {
+                relation.unite_row(i, row_k);
             }
         }
     }
-    return INF;
 }
 
 
-Distances compute_multi_source_multi_target_shortest_distances(const ConceptDenotation& sources, const RoleDenotation& edges, const ConceptDenotation& targets) {
-    int num_objects = targets.get_num_objects();
-    Distances distances(num_objects, INF);
-    std::deque<int> queue;
-    for (int source : sources.to_vector()) {
-        distances[source] = 0;
-        queue.push_back(source);
-    }
-    while (!queue.empty()) {
-        int source = queue.front();
-        queue.pop_front();
-        for (int target = 0; target < num_objects; ++target) {
-            if (edges.contains(std::make_pair(source, target))) {
-                int alt = distances[source] + 1;
-                if (distances[target] > alt) {
-                    queue.push_back(target);
-                    distances[target] = alt;
+// Number of blocks of a row of left, i.e., 512 rows of right, that form a tile.
+static const int COMPOSITION_TILE_NUM_BLOCKS = 8;
+
+void compute_composition_by_rows(const RoleDenotation& left, const RoleDenotation& right, RoleDenotation& result) {
+    int num_objects = left.get_num_objects();
+    int num_blocks_per_row = left.get_num_blocks_per_row();
+    // The rows of right selected within a tile remain in cache across all rows of left.
+    for (int tile_begin = 0; tile_begin < num_blocks_per_row; tile_begin += COMPOSITION_TILE_NUM_BLOCKS) {
+        int tile_end = std::min(num_blocks_per_row, tile_begin + COMPOSITION_TILE_NUM_BLOCKS);
+        for (int i = 0; i < num_objects; ++i) {
+            const std::uint64_t* left_row = left.get_row(i).data();
+            for (int block_index = tile_begin; block_index < tile_end; ++block_index) {
+                std::uint64_t block = left_row[block_index];
+                while (block) {
+                    int k = block_index * 64 + std::countr_zero(block);
+                    block &= block - 1;
+                    result.unite_row(i, right.get_row(k));
                 }
             }
         }
     }
-    return distances;
 }
 
 
-PairwiseDistances compute_floyd_warshall(const RoleDenotation& edges) {
-    int num_objects = edges.get_num_objects();
-    AdjList adj_list = compute_adjacency_list(edges);
-    PairwiseDistances dist(num_objects, Distances(num_objects, INF));
-    // initialize edge costs
-    for (int source = 0; source < num_objects; ++source) {
-        for (int target : adj_list[source]) {
-            dist[source][target] = 1;
+void compute_composition_four_russians(const RoleDenotation& left, const RoleDenotation& right, RoleDenotation& result) {
+    int num_objects = left.get_num_objects();
+    int num_blocks_per_row = left.get_num_blocks_per_row();
+    // table[mask] is the union of the rows of right selected by mask within the current group.
+    std::vector<std::uint64_t> table(256 * num_blocks_per_row, 0);
+    for (int group_begin = 0; group_begin < num_objects; group_begin += 8) {
+        for (int mask = 1; mask < 256; ++mask) {
+            int k = group_begin + std::countr_zero(static_cast<unsigned>(mask));
+            const std::uint64_t* prev = table.data() + (mask & (mask - 1)) * num_blocks_per_row;
+            std::uint64_t* dst = table.data() + mask * num_blocks_per_row;
+            if (k < num_objects) {
+                const std::uint64_t* right_row = right.get_row(k).data();
+                for (int block_index = 0; block_index < num_blocks_per_row; ++block_index) {
+                    dst[block_index] = prev[block_index] | right_row[block_index];
+                }
+            } else {
+                std::copy(prev, prev + num_blocks_per_row, dst);
+            }
         }
-        dist[source][source] = 0;
-    }
-    // main loop
-    for (int k = 0; k < num_objects; ++k) {
+        int block_index = group_begin / 64;
+        int shift = group_begin % 64;
         for (int i = 0; i < num_objects; ++i) {
-            for (int j = 0; j < num_objects; ++j) {
-                if (dist[i][j] > path_addition(dist[i][k], dist[k][j])) {
-                    dist[i][j] = path_addition(dist[i][k], dist[k][j]);
-                }
+            int mask = (left.get_row(i).data()[block_index] >> shift) & 0xFF;
+            if (mask) {
+                result.unite_row(i, ConceptDenotationView(table.data() + mask * num_blocks_per_row, num_objects));
             }
         }
     }
-    return dist;
+}
+
+
+void compute_composition(const RoleDenotation& left, const RoleDenotation& right, RoleDenotation& result) {
+    // Four Russians pays off if left has more than (256 + n) * n / 8 pairs,
+    // which requires large n because left has at most n^2 pairs.
+    long num_objects = left.get_num_objects();
+    if (8L * left.size() > (256L + num_objects) * num_objects) {
+        compute_composition_four_russians(left, right, result);
+    } else {
+        compute_composition_by_rows(left, right, result);
+    }
 }
 
 }
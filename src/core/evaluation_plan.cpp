@@ -0,0 +1,142 @@
+#include "../../include/dlplan/core.h"
+#include "../../include/dlplan/core/elements/utils.h"
+
+#include <stdexcept>
+
+
+namespace dlplan::core {
+
+EvaluationPlan::EvaluationPlan(
+    const std::vector<std::shared_ptr<const Boolean>>& booleans,
+    const std::vector<std::shared_ptr<const Numerical>>& numericals,
+    const std::vector<std::shared_ptr<const Concept>>& concepts,
+    const std::vector<std::shared_ptr<const Role>>& roles)
+    : m_booleans(booleans),
+      m_numericals(numericals),
+      m_concepts(concepts),
+      m_roles(roles),
+      m_num_concept_slots(0),
+      m_num_role_slots(0),
+      m_num_numerical_slots(0),
+      m_num_boolean_slots(0) {
+    EvaluationPlanBuilder builder(*this);
+    for (const auto& boolean : m_booleans) {
+        builder.compile(*boolean);
+    }
+    for (const auto& numerical : m_numericals) {
+        builder.compile(*numerical);
+    }
+    for (const auto& concept_ : m_concepts) {
+        builder.compile(*concept_);
+    }
+    for (const auto& role : m_roles) {
+        builder.compile(*role);
+    }
+}
+
+int EvaluationPlan::get_slot(const void* element) const {
+    auto result = m_slots.find(element);
+    if (result == m_slots.end()) {
+        throw std::runtime_error("EvaluationPlan::get_slot - element was not compiled into the plan.");
+    }
+    return result->second;
+}
+
+int EvaluationPlan::get_slot(const Boolean& boolean) const {
+    return get_slot(static_cast<const void*>(&boolean));
+}
+
+int EvaluationPlan::get_slot(const Numerical& numerical) const {
+    return get_slot(static_cast<const void*>(&numerical));
+}
+
+int EvaluationPlan::get_slot(const Concept& concept_) const {
+    return get_slot(static_cast<const void*>(&concept_));
+}
+
+int EvaluationPlan::get_slot(const Role& role) const {
+    return get_slot(static_cast<const void*>(&role));
+}
+
+int EvaluationPlan::get_num_instructions() const {
+    return m_static_instructions.size() + m_instructions.size();
+}
+
+int EvaluationPlan::get_num_static_instructions() const {
+    return m_static_instructions.size();
+}
+
+
+EvaluationPlanBuilder::EvaluationPlanBuilder(EvaluationPlan& plan) : m_plan(plan) { }
+
+
+EvaluationFrame::EvaluationFrame(std::shared_ptr<const EvaluationPlan> plan)
+    : m_plan(plan),
+      m_instance_info(nullptr),
+      m_num_objects(0),
+      m_concept_denotations(plan->m_num_concept_slots, ConceptDenotation(0)),
+      m_role_denotations(plan->m_num_role_slots, RoleDenotation(0)),
+      m_numerical_denotations(plan->m_num_numerical_slots, 0),
+      m_boolean_denotations(plan->m_num_boolean_slots, false),
+      m_pairwise_distances(plan->m_num_numerical_slots) { }
+
+EvaluationFrame::EvaluationFrame(EvaluationFrame&& other) = default;
+
+EvaluationFrame& EvaluationFrame::operator=(EvaluationFrame&& other) = default;
+
+EvaluationFrame::~EvaluationFrame() = default;
+
+void EvaluationFrame::evaluate(const State& state) {
+    auto instance_info = state.get_instance_info();
+    int num_objects = instance_info->get_objects().size();
+    if (instance_info != m_instance_info || num_objects != m_num_objects) {
+        if (num_objects != m_num_objects) {
+            for (auto& denotation : m_concept_denotations) {
+                denotation = ConceptDenotation(num_objects);
+            }
+            for (auto& denotation : m_role_denotations) {
+                denotation = RoleDenotation(num_objects);
+            }
+            m_num_objects = num_objects;
+        }
+        m_instance_info = std::move(instance_info);
+        for (const auto& instruction : m_plan->m_static_instructions) {
+            instruction.function(instruction, state, *this);
+        }
+    }
+    for (const auto& instruction : m_plan->m_instructions) {
+        instruction.function(instruction, state, *this);
+    }
+}
+
+PairwiseDistances& EvaluationFrame::get_pairwise_distances(int slot, const RoleDenotation& edges) {
+    auto& result = m_pairwise_distances[slot];
+    if (!result) {
+        result = std::make_unique<PairwiseDistances>(edges);
+    } else {
+        result->reset(edges);
+    }
+    return *result;
+}
+
+bool EvaluationFrame::get_denotation(const Boolean& boolean) const {
+    return m_boolean_denotations[m_plan->get_slot(&boolean)];
+}
+
+int EvaluationFrame::get_denotation(const Numerical& numerical) const {
+    return m_numerical_denotations[m_plan->get_slot(&numerical)];
+}
+
+const ConceptDenotation& EvaluationFrame::get_denotation(const Concept& concept_) const {
+    return m_concept_denotations[m_plan->get_slot(&concept_)];
+}
+
+const RoleDenotation& EvaluationFrame::get_denotation(const Role& role) const {
+    return m_role_denotations[m_plan->get_slot(&role)];
+}
+
+std::shared_ptr<const EvaluationPlan> EvaluationFrame::get_plan() const {
+    return m_plan;
+}
+
+}
@@ -24,6 +24,13 @@ static std::string compute_atom_name(const Predicate& predicate, const std::vect
     return ss.str();
 }
 
+static void add_atom_index(std::vector<AtomIndices>& atom_indices_by_predicate, PredicateIndex predicate_index, AtomIndex atom_index) {
+    if (predicate_index >= static_cast<int>(atom_indices_by_predicate.size())) {
+        atom_indices_by_predicate.resize(predicate_index + 1);
+    }
+    atom_indices_by_predicate[predicate_index].push_back(atom_index);
+}
+
 InstanceInfo::InstanceInfo(InstanceIndex index, std::shared_ptr<VocabularyInfo> vocabulary_info)
     : Base<InstanceInfo>(index), m_vocabulary_info(vocabulary_info) {
 }
@@ -88,6 +95,7 @@ const Atom& InstanceInfo::add_atom(const Predicate& predicate, const std::vector
         if (!newly_inserted) {
             throw std::runtime_error("InstanceInfo::add_atom - atom with name ("s + atom.get_name() + ") already exists.");
         }
+        add_atom_index(m_static_atom_indices_by_predicate, predicate.get_index(), atom.get_index());
         m_static_atoms.push_back(std::move(atom));
         return m_static_atoms.back();
     } else {
@@ -97,6 +105,7 @@ const Atom& InstanceInfo::add_atom(const Predicate& predicate, const std::vector
         if (!newly_inserted) {
             return m_atoms[result.first->second];
         }
+        add_atom_index(m_atom_indices_by_predicate, predicate.get_index(), atom.get_index());
         m_atoms.push_back(std::move(atom));
         return m_atoms.back();
     }
@@ -164,6 +173,16 @@ const std::vector<Atom>& InstanceInfo::get_static_atoms() const {
     return m_static_atoms;
 }
 
+const AtomIndices& InstanceInfo::get_atom_indices_of_predicate(PredicateIndex predicate_index) const {
+    static const AtomIndices empty;
+    return utils::in_bounds(predicate_index, m_atom_indices_by_predicate) ? m_atom_indices_by_predicate[predicate_index] : empty;
+}
+
+const AtomIndices& InstanceInfo::get_static_atom_indices_of_predicate(PredicateIndex predicate_index) const {
+    static const AtomIndices empty;
+    return utils::in_bounds(predicate_index, m_static_atom_indices_by_predicate) ? m_static_atom_indices_by_predicate[predicate_index] : empty;
+}
+
 const std::vector<Object>& InstanceInfo::get_objects() const {
     return m_objects;
 }
@@ -189,11 +208,13 @@ const Atom& InstanceInfo::get_atom(const std::string& name) const {
 void InstanceInfo::clear_atoms() {
     m_atoms.clear();
     m_atom_name_to_index.clear();
+    m_atom_indices_by_predicate.clear();
 }
 
 void InstanceInfo::clear_static_atoms() {
     m_static_atoms.clear();
     m_static_atom_name_to_index.clear();
+    m_static_atom_indices_by_predicate.clear();
 }
 
 }
@@ -10,7 +10,10 @@
 namespace dlplan::core {
 // we assign index undefined since we do not care
 RoleDenotation::RoleDenotation(int num_objects)
-    : Base<RoleDenotation>(std::numeric_limits<int>::max()), m_num_objects(num_objects), m_data(DynamicBitset<unsigned>(num_objects * num_objects)) { }
+    : Base<RoleDenotation>(std::numeric_limits<int>::max()),
+      m_num_objects(num_objects),
+      m_num_blocks_per_row((num_objects + 63) / 64),
+      m_data(DynamicBitset<std::uint64_t, 16>(static_cast<std::size_t>(num_objects) * m_num_blocks_per_row * 64)) { }
 
 RoleDenotation::RoleDenotation(const RoleDenotation& other) = default;
 
@@ -22,6 +25,18 @@ RoleDenotation& RoleDenotation::operator=(RoleDenotation&& other) = default;
 
 RoleDenotation::~RoleDenotation() = default;
 
+void RoleDenotation::zero_padding_bits() {
+    int num_padding_bits = m_num_blocks_per_row * 64 - m_num_objects;
+    if (num_padding_bits == 0) {
+        return;
+    }
+    std::uint64_t mask = ~std::uint64_t(0) >> num_padding_bits;
+    std::uint64_t* blocks = m_data.data();
+    for (int i = 0; i < m_num_objects; ++i) {
+        blocks[(i + 1) * m_num_blocks_per_row - 1] &= mask;
+    }
+}
+
 bool RoleDenotation::are_equal_impl(const RoleDenotation& other) const {
     if (this != &other) {
         return this->m_data == other.m_data;
@@ -57,23 +72,32 @@ RoleDenotation& RoleDenotation::operator-=(const RoleDenotation& other) {
 
 RoleDenotation& RoleDenotation::operator~() {
     ~m_data;
+    zero_padding_bits();
     return *this;
 }
 
 void RoleDenotation::set() {
     m_data.set();
+    zero_padding_bits();
+}
+
+void RoleDenotation::clear() {
+    m_data.reset();
 }
 
 bool RoleDenotation::contains(const PairOfObjectIndices& value) const {
-    return m_data.test(value.first * m_num_objects + value.second);
+    assert(value.first >= 0 && value.first < m_num_objects && value.second >= 0 && value.second < m_num_objects);
+    return m_data.test(compute_position(value));
 }
 
 void RoleDenotation::insert(const PairOfObjectIndices& value) {
-    return m_data.set(value.first * m_num_objects + value.second);
+    assert(value.first >= 0 && value.first < m_num_objects && value.second >= 0 && value.second < m_num_objects);
+    m_data.set(compute_position(value));
 }
 
 void RoleDenotation::erase(const PairOfObjectIndices& value) {
-    return m_data.reset(value.first * m_num_objects + value.second);
+    assert(value.first >= 0 && value.first < m_num_objects && value.second >= 0 && value.second < m_num_objects);
+    m_data.reset(compute_position(value));
 }
 
 int RoleDenotation::size() const {
@@ -92,6 +116,37 @@ bool RoleDenotation::is_subset_of(const RoleDenotation& other) const {
     return m_data.is_subset_of(other.m_data);
 }
 
+ConceptDenotationView RoleDenotation::get_row(ObjectIndex source) const {
+    assert(source >= 0 && source < m_num_objects);
+    return ConceptDenotationView(m_data.data() + source * m_num_blocks_per_row, m_num_objects);
+}
+
+void RoleDenotation::unite_row(ObjectIndex source, const ConceptDenotationView& other) {
+    assert(source >= 0 && source < m_num_objects && other.get_num_objects() == m_num_objects);
+    std::uint64_t* row = m_data.data() + source * m_num_blocks_per_row;
+    const std::uint64_t* other_blocks = other.data();
+    for (int i = 0; i < m_num_blocks_per_row; ++i) {
+        row[i] |= other_blocks[i];
+    }
+}
+
+void RoleDenotation::intersect_row(ObjectIndex source, const ConceptDenotationView& other) {
+    assert(source >= 0 && source < m_num_objects && other.get_num_objects() == m_num_objects);
+    std::uint64_t* row = m_data.data() + source * m_num_blocks_per_row;
+    const std::uint64_t* other_blocks = other.data();
+    for (int i = 0; i < m_num_blocks_per_row; ++i) {
+        row[i] &= other_blocks[i];
+    }
+}
+
+RoleDenotation RoleDenotation::transpose() const {
+    RoleDenotation result(m_num_objects);
+    for (const auto& pair : *this) {
+        result.insert(PairOfObjectIndices(pair.second, pair.first));
+    }
+    return result;
+}
+
 PairsOfObjectIndices RoleDenotation::to_vector() const {
     // In the case of bitset, the to_sorted_vector has best runtime complexity.
     return to_sorted_vector();
@@ -99,16 +154,10 @@ PairsOfObjectIndices RoleDenotation::to_vector() const {
 
 PairsOfObjectIndices RoleDenotation::to_sorted_vector() const {
     PairsOfObjectIndices result;
-    result.reserve(m_num_objects * m_num_objects);
-    for (ObjectIndex i = 0; i < m_num_objects; ++i) {
-        int offset = m_num_objects * i;
-        for (ObjectIndex j = 0; j < m_num_objects; ++j) {
-            if (m_data.test(offset + j)) {
-                result.emplace_back(i, j);
-            }
-        }
+    result.reserve(size());
+    for (const auto& value : *this) {
+        result.push_back(value);
     }
-    result.shrink_to_fit();
     return result;
 }
 
@@ -116,4 +165,12 @@ int RoleDenotation::get_num_objects() const {
     return m_num_objects;
 }
 
+int RoleDenotation::get_num_blocks_per_row() const {
+    return m_num_blocks_per_row;
+}
+
+std::size_t RoleDenotation::get_dynamic_memory_usage() const {
+    return m_data.get_dynamic_memory_usage();
+}
+
 }
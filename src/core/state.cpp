@@ -29,6 +29,7 @@ State::State(StateIndex index, std::shared_ptr<InstanceInfo> instance_info, cons
     if (!std::is_sorted(m_atom_indices.begin(), m_atom_indices.end())) {
         std::sort(m_atom_indices.begin(), m_atom_indices.end());
     }
+    compute_atom_indices_by_predicate();
 }
 
 State::State(StateIndex index, std::shared_ptr<InstanceInfo> instance_info, const AtomIndices& atom_indices)
@@ -38,6 +39,7 @@ State::State(StateIndex index, std::shared_ptr<InstanceInfo> instance_info, cons
     if (!std::all_of(m_atom_indices.begin(), m_atom_indices.end(), [&](int atom_idx){ return utils::in_bounds(atom_idx, atoms); })) {
         throw std::runtime_error("State::State - atom index out of range.");
     }
+    compute_atom_indices_by_predicate();
 }
 
 State::State(StateIndex index, std::shared_ptr<InstanceInfo> instance_info, AtomIndices&& atom_indices)
@@ -47,9 +49,28 @@ State::State(StateIndex index, std::shared_ptr<InstanceInfo> instance_info, Atom
     if (!std::all_of(m_atom_indices.begin(), m_atom_indices.end(), [&](int atom_idx){ return utils::in_bounds(atom_idx, atoms); })) {
         throw std::runtime_error("State::State - atom index out of range.");
     }
+    compute_atom_indices_by_predicate();
 }
 
 
+void State::compute_atom_indices_by_predicate() {
+    // counting sort of the atoms by predicate
+    const auto& atoms = m_instance_info->get_atoms();
+    int num_predicates = m_instance_info->get_vocabulary_info()->get_predicates().size();
+    m_predicate_offsets.assign(num_predicates + 1, 0);
+    for (int atom_idx : m_atom_indices) {
+        ++m_predicate_offsets[atoms[atom_idx].get_predicate_index() + 1];
+    }
+    for (int predicate_idx = 0; predicate_idx < num_predicates; ++predicate_idx) {
+        m_predicate_offsets[predicate_idx + 1] += m_predicate_offsets[predicate_idx];
+    }
+    m_atom_indices_by_predicate.resize(m_atom_indices.size());
+    std::vector<int> positions(m_predicate_offsets.begin(), m_predicate_offsets.end() - 1);
+    for (int atom_idx : m_atom_indices) {
+        m_atom_indices_by_predicate[positions[atoms[atom_idx].get_predicate_index()]++] = atom_idx;
+    }
+}
+
 State::State(const State&) = default;
 
 State& State::operator=(const State&) = default;
@@ -93,4 +114,58 @@ const AtomIndices& State::get_atom_indices() const {
     return m_atom_indices;
 }
 
+std::span<const AtomIndex> State::get_atom_indices_of_predicate(PredicateIndex predicate_index) const {
+    if (!utils::in_bounds(predicate_index + 1, m_predicate_offsets)) {
+        return {};
+    }
+    return std::span<const AtomIndex>(m_atom_indices_by_predicate).subspan(
+        m_predicate_offsets[predicate_index],
+        m_predicate_offsets[predicate_index + 1] - m_predicate_offsets[predicate_index]);
+}
+
+
+// The delta that is active on the current thread.
+static thread_local const StateDelta* active_state_delta = nullptr;
+
+StateDelta::Scope::Scope(const StateDelta& delta) : m_previous(active_state_delta) {
+    active_state_delta = &delta;
+}
+
+StateDelta::Scope::~Scope() {
+    active_state_delta = m_previous;
+}
+
+StateDelta::StateDelta(const State& state, const State& parent_state, const AtomIndices& added_atoms, const AtomIndices& deleted_atoms)
+    : m_state(state), m_parent_state(parent_state), m_added_atoms(added_atoms), m_deleted_atoms(deleted_atoms) {
+    if (state.get_instance_info() != parent_state.get_instance_info()) {
+        throw std::runtime_error("StateDelta::StateDelta - state and parent state must belong to the same instance.");
+    }
+}
+
+const StateDelta* StateDelta::get_active() {
+    return active_state_delta;
+}
+
+bool StateDelta::is_delta_of(const State& state) const {
+    // Elements are usually evaluated on the same state object as the delta.
+    return &state == &m_state
+        || (state.get_index() == m_state.get_index() && state.get_instance_info() == m_state.get_instance_info());
+}
+
+const State& StateDelta::get_state() const {
+    return m_state;
+}
+
+const State& StateDelta::get_parent_state() const {
+    return m_parent_state;
+}
+
+const AtomIndices& StateDelta::get_added_atoms() const {
+    return m_added_atoms;
+}
+
+const AtomIndices& StateDelta::get_deleted_atoms() const {
+    return m_deleted_atoms;
+}
+
 }
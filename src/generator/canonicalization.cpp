@@ -0,0 +1,51 @@
+#include "canonicalization.h"
+
+#include "../../include/dlplan/core/elements/concepts/bot.h"
+#include "../../include/dlplan/core/elements/concepts/not.h"
+#include "../../include/dlplan/core/elements/concepts/top.h"
+#include "../../include/dlplan/core/elements/roles/inverse.h"
+#include "../../include/dlplan/core/elements/roles/not.h"
+#include "../../include/dlplan/core/elements/roles/top.h"
+
+
+namespace dlplan::generator::canonicalization {
+
+template<typename Derived, typename Base>
+static bool is(const Base& element) {
+    return dynamic_cast<const Derived*>(&element) != nullptr;
+}
+
+bool is_redundant_and(const core::Concept& left, const core::Concept& right) {
+    // The factory constructs each element once, hence equal elements are identical.
+    return &left == &right
+        || is<core::TopConcept>(left) || is<core::TopConcept>(right)
+        || is<core::BotConcept>(left) || is<core::BotConcept>(right);
+}
+
+bool is_redundant_or(const core::Concept& left, const core::Concept& right) {
+    return &left == &right
+        || is<core::TopConcept>(left) || is<core::TopConcept>(right)
+        || is<core::BotConcept>(left) || is<core::BotConcept>(right);
+}
+
+bool is_redundant_diff(const core::Concept& left, const core::Concept& right) {
+    return is<core::BotConcept>(left) || is<core::BotConcept>(right);
+}
+
+bool is_redundant_not(const core::Concept& concept_) {
+    return is<core::NotConcept>(concept_);
+}
+
+bool is_redundant_or(const core::Role& left, const core::Role& right) {
+    return &left == &right || is<core::TopRole>(left) || is<core::TopRole>(right);
+}
+
+bool is_redundant_not(const core::Role& role) {
+    return is<core::NotRole>(role);
+}
+
+bool is_redundant_inverse(const core::Role& role) {
+    return is<core::InverseRole>(role);
+}
+
+}
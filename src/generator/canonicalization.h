@@ -0,0 +1,31 @@
+#ifndef DLPLAN_SRC_GENERATOR_CANONICALIZATION_H_
+#define DLPLAN_SRC_GENERATOR_CANONICALIZATION_H_
+
+#include "../../include/dlplan/core.h"
+
+
+/// @brief Syntactic checks for candidates that are equivalent to one of
+///        their arguments. The arguments of a candidate were generated
+///        before, hence such candidates are never new and the rules skip
+///        them without evaluating them.
+namespace dlplan::generator::canonicalization {
+
+/// @brief c_and(C,C) = C, c_and(C,c_top) = C, and c_and(C,c_bot) = c_bot.
+extern bool is_redundant_and(const core::Concept& left, const core::Concept& right);
+/// @brief c_or(C,C) = C, c_or(C,c_bot) = C, and c_or(C,c_top) = c_top.
+extern bool is_redundant_or(const core::Concept& left, const core::Concept& right);
+/// @brief c_diff(C,c_bot) = C and c_diff(c_bot,C) = c_bot.
+extern bool is_redundant_diff(const core::Concept& left, const core::Concept& right);
+/// @brief c_not(c_not(C)) = C.
+extern bool is_redundant_not(const core::Concept& concept_);
+
+/// @brief r_or(R,R) = R and r_or(R,r_top) = r_top.
+extern bool is_redundant_or(const core::Role& left, const core::Role& right);
+/// @brief r_not(r_not(R)) = R.
+extern bool is_redundant_not(const core::Role& role);
+/// @brief r_inverse(r_inverse(R)) = R.
+extern bool is_redundant_inverse(const core::Role& role);
+
+}
+
+#endif
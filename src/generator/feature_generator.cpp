@@ -5,18 +5,61 @@
 #include "../../include/dlplan/core.h"
 
 #include <algorithm>
-#include <iostream>
 #include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_set>
+#include <variant>
 
 
 namespace dlplan::generator {
-void exit_sigint_handler(int signal) {
-    std::cout << "Caught signal " << signal << std::endl;
-    exit(signal);
+// The token of the running generation, which SIGINT cancels.
+static CancellationToken* g_sigint_cancellation_token = nullptr;
+
+static void cancel_sigint_handler(int) {
+    if (g_sigint_cancellation_token) {
+        g_sigint_cancellation_token->cancel();
+    }
 }
 
+/// @brief Lets SIGINT cancel the given token during its lifetime and
+///        restores the previous handler and token on any exit.
+struct SigintGuard {
+    CancellationToken* m_previous_token;
+    void (*m_previous_handler)(int);
+
+    explicit SigintGuard(CancellationToken& token)
+        : m_previous_token(g_sigint_cancellation_token) {
+        g_sigint_cancellation_token = &token;
+        m_previous_handler = std::signal(SIGINT, cancel_sigint_handler);
+    }
+
+    ~SigintGuard() {
+        std::signal(SIGINT, m_previous_handler);
+        g_sigint_cancellation_token = m_previous_token;
+    }
+
+    SigintGuard(const SigintGuard&) = delete;
+    SigintGuard& operator=(const SigintGuard&) = delete;
+};
+
+Generation::Generation(bool thread_safe) : m_caches(thread_safe) { }
+
+Generation::~Generation() = default;
+
 FeatureGeneratorImpl::FeatureGeneratorImpl()
-    : c_one_of(std::make_shared<rules::OneOfConcept>()),
+    : m_num_threads(1),
+      m_use_fingerprints(false),
+      m_num_probe_states(0),
+      m_incremental(false),
+      m_last_generation(nullptr),
+      m_cancellation_token(),
+      m_memory_limit(0),
+      m_peak_num_bytes(0),
+      m_checkpoint_file(),
+      c_one_of(std::make_shared<rules::OneOfConcept>()),
       c_top(std::make_shared<rules::TopConcept>()),
       c_bot(std::make_shared<rules::BotConcept>()),
       c_primitive(std::make_shared<rules::PrimitiveConcept>()),
@@ -105,99 +148,278 @@ GeneratedFeatures FeatureGeneratorImpl::generate(
     int time_limit,
     int feature_limit)
 {
-    // Allow termination with ctrl+c
-    auto pre_sigint_handler = std::signal(SIGINT, exit_sigint_handler);
+    return generate(factory, states, concept_complexity_limit, role_complexity_limit, boolean_complexity_limit, count_numerical_complexity_limit, distance_numerical_complexity_limit, time_limit, feature_limit, false);
+}
 
+GeneratedFeatures FeatureGeneratorImpl::resume(
+    core::SyntacticElementFactory& factory,
+    const core::States& states,
+    int concept_complexity_limit,
+    int role_complexity_limit,
+    int boolean_complexity_limit,
+    int count_numerical_complexity_limit,
+    int distance_numerical_complexity_limit,
+    int time_limit,
+    int feature_limit)
+{
+    if (m_checkpoint_file.empty()) {
+        throw std::runtime_error("FeatureGeneratorImpl::resume - no checkpoint file was set.");
+    }
+    return generate(factory, states, concept_complexity_limit, role_complexity_limit, boolean_complexity_limit, count_numerical_complexity_limit, distance_numerical_complexity_limit, time_limit, feature_limit, std::filesystem::exists(m_checkpoint_file));
+}
+
+GeneratedFeatures FeatureGeneratorImpl::generate(
+    core::SyntacticElementFactory& factory,
+    const core::States& states,
+    int concept_complexity_limit,
+    int role_complexity_limit,
+    int boolean_complexity_limit,
+    int count_numerical_complexity_limit,
+    int distance_numerical_complexity_limit,
+    int time_limit,
+    int feature_limit,
+    bool from_checkpoint)
+{
     // Initialize statistics in each rule.
     for (auto& r : m_primitive_rules) r->initialize();
     for (auto& r : m_concept_inductive_rules) r->initialize();
     for (auto& r : m_role_inductive_rules) r->initialize();
     for (auto& r : m_boolean_inductive_rules) r->initialize();
     for (auto& r : m_numerical_inductive_rules) r->initialize();
+    // Initialize cache, which tasks share if they run concurrently.
+    auto generation = std::make_shared<Generation>(m_num_threads > 1);
+    // An incremental generator extends a copy of the sample later.
+    if (m_incremental) {
+        generation->m_states = states;
+    }
+    const core::States& sample = m_incremental ? generation->m_states : states;
+    core::DenotationsCaches& caches = generation->m_caches;
     // Initialize memory to store intermediate results.
-    GeneratorData data(factory, std::max({concept_complexity_limit, role_complexity_limit, boolean_complexity_limit, count_numerical_complexity_limit, distance_numerical_complexity_limit}), time_limit, feature_limit);
-    // Initialize cache.
-    core::DenotationsCaches caches;
-    generate_base(states, data, caches);
+    generation->m_data = std::make_unique<GeneratorData>(factory, sample, caches, std::max({concept_complexity_limit, role_complexity_limit, boolean_complexity_limit, count_numerical_complexity_limit, distance_numerical_complexity_limit}), time_limit, feature_limit, m_num_threads, m_use_fingerprints);
+    GeneratorData& data = *generation->m_data;
+    data.m_boolean_callback = m_boolean_callback;
+    data.m_numerical_callback = m_numerical_callback;
+    data.m_concept_callback = m_concept_callback;
+    data.m_role_callback = m_role_callback;
+    data.m_keep_duplicates = m_incremental;
+    data.m_cancellation_token = m_cancellation_token;
+    data.m_memory_limit = m_memory_limit;
+    data.m_complexity_limits = {concept_complexity_limit, role_complexity_limit, boolean_complexity_limit, count_numerical_complexity_limit, distance_numerical_complexity_limit};
+    data.initialize_probes(m_num_probe_states);
+    // Allow stopping with ctrl+c, which returns the features generated so far.
+    // SIGINT cancels a token of this run only, hence later runs are not affected.
+    SigintGuard sigint_guard(data.m_sigint_token);
 
     try
     {
-        generate_inductively(states, concept_complexity_limit, role_complexity_limit, boolean_complexity_limit, count_numerical_complexity_limit, distance_numerical_complexity_limit, data, caches);
+        int start_complexity = 2;
+        bool converged = false;
+        if (from_checkpoint) {
+            std::tie(start_complexity, converged) = read_checkpoint(data);
+            ++start_complexity;
+        } else {
+            generate_base(sample, data);
+        }
+        if (!converged) {
+            generate_inductively(sample, start_complexity, concept_complexity_limit, role_complexity_limit, boolean_complexity_limit, count_numerical_complexity_limit, distance_numerical_complexity_limit, data);
+        }
         //auto x = new char[std::numeric_limits<std::size_t>::max() / 10];
         //x[1] = 1;
     }
     catch (const std::bad_alloc& e)
     {
         std::cout << "Feature generation stopped prematurely due to catching memory exception: " << e.what()  << std::endl;
+        data.m_stopped = true;
     }
 
-    // Restore previous sigint handler
-    std::signal(SIGINT, pre_sigint_handler);
+    if (m_cancellation_token.is_cancelled() || data.m_sigint_token.is_cancelled()) {
+        utils::g_log << "Feature generation was cancelled." << std::endl;
+    } else if (data.reached_memory_limit()) {
+        utils::g_log << "Feature generation reached the memory limit of " << m_memory_limit << " bytes." << std::endl;
+    }
 
+    // An interrupted or stopped generation lacks elements, hence it cannot
+    // be extended.
+    m_last_generation = (m_incremental && !data.m_stopped && !data.is_interrupted()) ? generation : nullptr;
+    m_peak_num_bytes = data.m_peak_num_bytes;
+    return data.m_generated_features;
+}
+
+static core::BooleanDenotations concatenate(const core::States&, const core::BooleanDenotations& left, const core::BooleanDenotations& right) {
+    core::BooleanDenotations result(left);
+    result.insert(result.end(), right.begin(), right.end());
+    return result;
+}
+
+static core::NumericalDenotations concatenate(const core::States&, const core::NumericalDenotations& left, const core::NumericalDenotations& right) {
+    core::NumericalDenotations result(left);
+    result.insert(result.end(), right.begin(), right.end());
+    return result;
+}
+
+template<typename Denotation>
+static core::DenotationMatrix<Denotation> concatenate(const core::States& states, const core::DenotationMatrix<Denotation>& left, const core::DenotationMatrix<Denotation>& right) {
+    core::DenotationMatrix<Denotation> result(states);
+    Denotation denotation(0);
+    for (std::size_t i = 0; i < left.size(); ++i) {
+        left.load_row(i, denotation);
+        result.store_row(i, denotation);
+    }
+    for (std::size_t i = 0; i < right.size(); ++i) {
+        right.load_row(i, denotation);
+        result.store_row(left.size() + i, denotation);
+    }
+    return result;
+}
+
+/// @brief Commits the element with its denotations on the old states
+///        followed by those on the new states, which only the new states
+///        require evaluating. Returns true iff the element was added.
+template<typename Element>
+static bool recommit(
+    const std::shared_ptr<const Element>& element,
+    int complexity,
+    Generation& last_generation,
+    const core::States& new_states,
+    core::DenotationsCaches& new_states_caches,
+    Generation& generation) {
+    auto denotations = concatenate(
+        generation.m_states,
+        *element->evaluate(last_generation.m_states, last_generation.m_caches),
+        *element->evaluate(new_states, new_states_caches));
+    using Denotations = decltype(denotations);
+    // Later compositions and extensions find the denotations on all states in the caches.
+    auto handle = generation.m_caches.data.insert_mapping<Denotations>(
+        core::DenotationsCacheKey{ element->get_index(), -1, -1 },
+        generation.m_caches.data.insert(std::move(denotations)));
+    return generation.m_data->add(element, generation.m_caches.data.get_shared<Denotations>(handle), complexity, generation.m_caches);
+}
+
+GeneratedFeatures FeatureGeneratorImpl::extend(const core::States& states) {
+    if (!m_last_generation) {
+        throw std::runtime_error("FeatureGeneratorImpl::extend - no incremental generation to extend.");
+    }
+    Generation& last_generation = *m_last_generation;
+    const GeneratorData& last_data = *last_generation.m_data;
+    auto generation = std::make_shared<Generation>(m_num_threads > 1);
+    generation->m_states = last_generation.m_states;
+    generation->m_states.insert(generation->m_states.end(), states.begin(), states.end());
+    generation->m_data = std::make_unique<GeneratorData>(last_data.m_factory, generation->m_states, generation->m_caches, last_data.m_complexity, last_data.m_time_limit, last_data.m_feature_limit, m_num_threads, m_use_fingerprints);
+    GeneratorData& data = *generation->m_data;
+    data.m_boolean_callback = m_boolean_callback;
+    data.m_numerical_callback = m_numerical_callback;
+    data.m_concept_callback = m_concept_callback;
+    data.m_role_callback = m_role_callback;
+    data.m_keep_duplicates = true;
+    data.m_cancellation_token = m_cancellation_token;
+    data.m_memory_limit = m_memory_limit;
+    // The replayed elements passed the probe states of the last generation
+    // and no candidates are constructed, hence no probe states are needed.
+    // Allow stopping with ctrl+c like generate.
+    SigintGuard sigint_guard(data.m_sigint_token);
+
+    core::DenotationsCaches new_states_caches;
+    int num_added = 0;
+    try
+    {
+        // Replay in the order of commitment across the element types such
+        // that the callbacks receive the features as during generation.
+        for (const auto& [committed, complexity] : last_data.m_committed_elements) {
+            if (data.m_stopped || data.is_interrupted()) break;
+            if (std::visit([&, complexity = complexity](const auto& element) {
+                    return recommit(element, complexity, last_generation, states, new_states_caches, *generation);
+                }, committed)) {
+                ++num_added;
+            }
+        }
+    }
+    catch (const std::bad_alloc& e)
+    {
+        std::cout << "Feature extension stopped prematurely due to catching memory exception: " << e.what()  << std::endl;
+        data.m_stopped = true;
+    }
+    data.update_peak_num_bytes(new_states_caches.data.get_num_bytes());
+    if (m_cancellation_token.is_cancelled() || data.m_sigint_token.is_cancelled()) {
+        utils::g_log << "Feature extension was cancelled." << std::endl;
+    }
+    utils::g_log << "Extended the sample by " << states.size() << " states and readmitted "
+                 << num_added - last_data.get_num_features() << " features." << std::endl;
+    data.print_statistics();
+
+    // An interrupted or stopped extension lacks elements, hence later
+    // extensions start from the last complete one.
+    if (!data.m_stopped && !data.is_interrupted()) {
+        m_last_generation = generation;
+    }
+    m_peak_num_bytes = data.m_peak_num_bytes;
     return data.m_generated_features;
 }
 
 void FeatureGeneratorImpl::generate_base(
     const core::States& states,
-    GeneratorData& data,
-    core::DenotationsCaches& caches) {
+    GeneratorData& data) {
     utils::g_log << "Started generating base features of complexity 1." << std::endl;
     for (const auto& rule : m_primitive_rules) {
         if (data.reached_resource_limit()) break;
-        rule->generate(states, 1, data, caches);
+        rule->generate(states, 1, data);
     }
+    data.run_tasks();
     utils::g_log << "Complexity " << 1 << ":" << std::endl;
     print_statistics();
+    if (!data.reached_resource_limit()) {
+        write_checkpoint(data, 1, false);
+    }
     utils::g_log << "Finished generating base features." << std::endl;
 }
 
 void FeatureGeneratorImpl::generate_inductively(
     const core::States& states,
+    int start_complexity,
     int concept_complexity_limit,
     int role_complexity_limit,
     int boolean_complexity_limit,
     int count_numerical_complexity_limit,
     int distance_numerical_complexity_limit,
-    GeneratorData& data,
-    core::DenotationsCaches& caches) {
+    GeneratorData& data) {
     utils::g_log << "Started generating composite features. " << std::endl;
     int max_complexity = std::max({concept_complexity_limit, role_complexity_limit, boolean_complexity_limit, count_numerical_complexity_limit, distance_numerical_complexity_limit});
-    for (int target_complexity = 2; target_complexity <= max_complexity; ++target_complexity) {  // every composition adds at least one complexity
+    for (int target_complexity = start_complexity; target_complexity <= max_complexity; ++target_complexity) {  // every composition adds at least one complexity
         const auto num_features = data.get_num_features();
         if (target_complexity <= concept_complexity_limit) {
-            if (data.reached_resource_limit()) break;
             for (const auto& rule : m_concept_inductive_rules) {
                 if (data.reached_resource_limit()) break;
-                rule->generate(states, target_complexity, data, caches);
+                rule->generate(states, target_complexity, data);
             }
         }
         if (target_complexity <= role_complexity_limit) {
-            if (data.reached_resource_limit()) break;
             for (const auto& rule : m_role_inductive_rules) {
                 if (data.reached_resource_limit()) break;
-                rule->generate(states, target_complexity, data, caches);
+                rule->generate(states, target_complexity, data);
             }
         }
         if (target_complexity <= boolean_complexity_limit) {
-            if (data.reached_resource_limit()) break;
             for (const auto& rule : m_boolean_inductive_rules) {
                 if (data.reached_resource_limit()) break;
-                rule->generate(states, target_complexity, data, caches);
+                rule->generate(states, target_complexity, data);
             }
         }
-        if (target_complexity <= count_numerical_complexity_limit) {
-            if (data.reached_resource_limit()) break;
-            n_count->generate(states, target_complexity, data, caches);
+        if (target_complexity <= count_numerical_complexity_limit && !data.reached_resource_limit()) {
+            n_count->generate(states, target_complexity, data);
         }
-        if (target_complexity <= distance_numerical_complexity_limit) {
-            if (data.reached_resource_limit()) break;
-            n_concept_distance->generate(states, target_complexity, data, caches);
+        if (target_complexity <= distance_numerical_complexity_limit && !data.reached_resource_limit()) {
+            n_concept_distance->generate(states, target_complexity, data);
         }
+        // Tasks that were submitted before reaching a limit still commit.
+        data.run_tasks();
         utils::g_log << "Complexity " << target_complexity << ":" << std::endl;
         data.print_statistics();
         print_statistics();
+        // The layer may be incomplete, hence a resumed generation repeats it.
+        if (data.reached_resource_limit()) break;
 
-        if (num_features == data.get_num_features()) {
+        bool converged = (num_features == data.get_num_features());
+        write_checkpoint(data, target_complexity, converged);
+        if (converged) {
             utils::g_log << "Feature generation converged." << std::endl;
             break;
         }
@@ -205,6 +427,246 @@ void FeatureGeneratorImpl::generate_inductively(
     utils::g_log << "Finished generating composite features." << std::endl;
 }
 
+/// @brief Returns a fingerprint of the instances and atoms of the states
+///        such that a checkpoint is only resumed on the same states.
+static utils::Fingerprint compute_fingerprint(const core::States& states) {
+    std::vector<int> values;
+    for (const auto& state : states) {
+        core::AtomIndices atom_indices = state.get_atom_indices();
+        std::sort(atom_indices.begin(), atom_indices.end());
+        values.push_back(state.get_instance_info()->get_index());
+        values.push_back(state.get_index());
+        values.push_back(atom_indices.size());
+        values.insert(values.end(), atom_indices.begin(), atom_indices.end());
+    }
+    return utils::compute_fingerprint(values.data(), values.size() * sizeof(int));
+}
+
+static void write_fingerprint(std::ostream& out, const utils::Fingerprint& fingerprint) {
+    out << std::hex << fingerprint[0] << " " << fingerprint[1] << std::dec;
+}
+
+static utils::Fingerprint read_fingerprint(std::istream& in) {
+    utils::Fingerprint fingerprint;
+    in >> std::hex >> fingerprint[0] >> fingerprint[1] >> std::dec;
+    return fingerprint;
+}
+
+template<typename Element>
+static void write_element(
+    std::ostream& out,
+    const std::shared_ptr<const Element>& element,
+    int complexity,
+    const std::unordered_map<core::ElementIndex, utils::Fingerprint>& fingerprints) {
+    out << "element " << complexity << " ";
+    write_fingerprint(out, fingerprints.at(element->get_index()));
+    out << " " << element->str() << "\n";
+}
+
+template<typename Element>
+static void write_elements(
+    std::ostream& out,
+    const std::vector<std::shared_ptr<const Element>>& elements,
+    int complexity,
+    const std::unordered_map<core::ElementIndex, utils::Fingerprint>& fingerprints) {
+    for (const auto& element : elements) {
+        write_element(out, element, complexity, fingerprints);
+    }
+}
+
+void FeatureGeneratorImpl::write_checkpoint(const GeneratorData& data, int complexity, bool converged) const {
+    if (m_checkpoint_file.empty()) {
+        return;
+    }
+    // Replace the previous checkpoint only once the new one is complete.
+    const std::string tmp_file = m_checkpoint_file + ".tmp";
+    {
+        std::ofstream out(tmp_file);
+        if (!out) {
+            throw std::runtime_error("FeatureGeneratorImpl::write_checkpoint - cannot open " + tmp_file + ".");
+        }
+        // The settings that determine the generated features precede them.
+        out << "checkpoint " << CHECKPOINT_VERSION << "\n"
+            << "states " << data.m_states.size() << "\n"
+            << "sample ";
+        write_fingerprint(out, compute_fingerprint(data.m_states));
+        out << "\n" << "limits";
+        for (int limit : data.m_complexity_limits) {
+            out << " " << limit;
+        }
+        out << "\n"
+            << "fingerprints " << m_use_fingerprints << "\n"
+            << "probes " << m_num_probe_states << "\n"
+            << "incremental " << data.m_keep_duplicates << "\n"
+            << "complexity " << complexity << "\n"
+            << "converged " << converged << "\n";
+        for (const auto* rules : {&m_primitive_rules, &m_concept_inductive_rules, &m_role_inductive_rules, &m_boolean_inductive_rules, &m_numerical_inductive_rules}) {
+            for (const auto& rule : *rules) {
+                out << "rule " << rule->get_name() << " " << rule->is_enabled() << " " << rule->get_count() << " " << rule->get_num_pruned() << "\n";
+            }
+        }
+        // The fingerprints of the denotations confirm them on resumption.
+        auto fingerprints = data.get_fingerprints();
+        if (data.m_keep_duplicates) {
+            // The log of an incremental generation holds the duplicates as
+            // well, in the order of commitment, which extensions replay.
+            for (const auto& [committed, element_complexity] : data.m_committed_elements) {
+                std::visit([&, element_complexity = element_complexity](const auto& element) {
+                    write_element(out, element, element_complexity, fingerprints);
+                }, committed);
+            }
+        } else {
+            for (int i = 1; i <= complexity; ++i) {
+                write_elements(out, data.m_booleans_by_iteration[i], i, fingerprints);
+                write_elements(out, data.m_numericals_by_iteration[i], i, fingerprints);
+                write_elements(out, data.m_concepts_by_iteration[i], i, fingerprints);
+                write_elements(out, data.m_roles_by_iteration[i], i, fingerprints);
+            }
+        }
+        if (!out.flush()) {
+            throw std::runtime_error("FeatureGeneratorImpl::write_checkpoint - cannot write " + tmp_file + ".");
+        }
+    }
+    std::filesystem::rename(tmp_file, m_checkpoint_file);
+}
+
+std::pair<int, bool> FeatureGeneratorImpl::read_checkpoint(GeneratorData& data) {
+    std::ifstream in(m_checkpoint_file);
+    if (!in) {
+        throw std::runtime_error("FeatureGeneratorImpl::read_checkpoint - cannot open " + m_checkpoint_file + ".");
+    }
+    std::unordered_map<std::string, Rule_Ptr> rules_by_name;
+    for (const auto* rules : {&m_primitive_rules, &m_concept_inductive_rules, &m_role_inductive_rules, &m_boolean_inductive_rules, &m_numerical_inductive_rules}) {
+        for (const auto& rule : *rules) {
+            rules_by_name.emplace(rule->get_name(), rule);
+        }
+    }
+    auto mismatch = [](const std::string& what) {
+        return std::runtime_error("FeatureGeneratorImpl::read_checkpoint - checkpoint was written for different " + what + ".");
+    };
+    int version = 0;
+    std::size_t num_states = 0;
+    int complexity = 0;
+    bool converged = false;
+    // The settings and rules that the header records, which must all
+    // precede the elements.
+    std::unordered_set<std::string> header;
+    std::string keyword;
+    if (!(in >> keyword >> version) || keyword != "checkpoint" || version != CHECKPOINT_VERSION) {
+        throw std::runtime_error("FeatureGeneratorImpl::read_checkpoint - unsupported checkpoint " + m_checkpoint_file + ".");
+    }
+    while (in >> keyword) {
+        if (keyword == "states") {
+            in >> num_states;
+            if (num_states != data.m_states.size()) {
+                throw std::runtime_error("FeatureGeneratorImpl::read_checkpoint - checkpoint was written for " + std::to_string(num_states) + " states.");
+            }
+        } else if (keyword == "sample") {
+            if (in && read_fingerprint(in) != compute_fingerprint(data.m_states)) {
+                throw mismatch("states");
+            }
+        } else if (keyword == "limits") {
+            std::array<int, 5> complexity_limits;
+            for (int& limit : complexity_limits) {
+                in >> limit;
+            }
+            if (in && complexity_limits != data.m_complexity_limits) {
+                throw mismatch("complexity limits");
+            }
+        } else if (keyword == "fingerprints") {
+            bool use_fingerprints;
+            in >> use_fingerprints;
+            if (in && use_fingerprints != m_use_fingerprints) {
+                throw mismatch("fingerprint settings");
+            }
+        } else if (keyword == "probes") {
+            int num_probe_states;
+            in >> num_probe_states;
+            if (in && num_probe_states != m_num_probe_states) {
+                throw mismatch("probe settings");
+            }
+        } else if (keyword == "incremental") {
+            bool incremental;
+            in >> incremental;
+            if (in && incremental != data.m_keep_duplicates) {
+                throw mismatch("incremental settings");
+            }
+        } else if (keyword == "complexity") {
+            in >> complexity;
+            if (complexity < 1 || complexity > data.m_complexity) {
+                throw std::runtime_error("FeatureGeneratorImpl::read_checkpoint - complexity " + std::to_string(complexity) + " exceeds the complexity limits.");
+            }
+        } else if (keyword == "converged") {
+            in >> converged;
+        } else if (keyword == "rule") {
+            std::string name;
+            bool enabled;
+            int count;
+            std::size_t num_pruned;
+            in >> name >> enabled >> count >> num_pruned;
+            auto result = rules_by_name.find(name);
+            if (result == rules_by_name.end()) {
+                throw std::runtime_error("FeatureGeneratorImpl::read_checkpoint - unknown rule " + name + ".");
+            }
+            if (in && enabled != result->second->is_enabled()) {
+                throw mismatch("enabled rules");
+            }
+            result->second->set_count(count);
+            result->second->set_num_pruned(num_pruned);
+            keyword += " " + name;
+        } else if (keyword == "element") {
+            if (header.size() != 8 + rules_by_name.size()) {
+                throw std::runtime_error("FeatureGeneratorImpl::read_checkpoint - incomplete header in checkpoint " + m_checkpoint_file + ".");
+            }
+            int element_complexity;
+            std::string repr;
+            in >> element_complexity;
+            utils::Fingerprint fingerprint = read_fingerprint(in);
+            in >> repr;
+            if (element_complexity < 1 || element_complexity > complexity) {
+                throw std::runtime_error("FeatureGeneratorImpl::read_checkpoint - element " + repr + " has invalid complexity.");
+            }
+            // The denotations are recomputed since later layers compose them.
+            // With fingerprints, they are not kept. Adding the duplicates of
+            // an incremental generation keeps them in the order of the log.
+            core::DenotationsCaches element_caches;
+            core::DenotationsCaches& caches = data.m_use_fingerprints ? element_caches : data.m_caches;
+            auto restore = [&](const auto& element) {
+                auto denotations = element->evaluate(data.m_states, caches);
+                if (compute_fingerprint(*denotations) != fingerprint) {
+                    throw mismatch("denotations of " + repr);
+                }
+                data.add(element, denotations, element_complexity, caches);
+            };
+            if (repr.rfind("b_", 0) == 0) {
+                restore(data.m_factory.parse_boolean(repr));
+            } else if (repr.rfind("n_", 0) == 0) {
+                restore(data.m_factory.parse_numerical(repr));
+            } else if (repr.rfind("c_", 0) == 0) {
+                restore(data.m_factory.parse_concept(repr));
+            } else if (repr.rfind("r_", 0) == 0) {
+                restore(data.m_factory.parse_role(repr));
+            } else {
+                throw std::runtime_error("FeatureGeneratorImpl::read_checkpoint - unknown element " + repr + ".");
+            }
+            data.update_peak_num_bytes(element_caches.data.get_num_bytes());
+        } else {
+            throw std::runtime_error("FeatureGeneratorImpl::read_checkpoint - unknown keyword " + keyword + ".");
+        }
+        if (!in) {
+            throw std::runtime_error("FeatureGeneratorImpl::read_checkpoint - malformed checkpoint " + m_checkpoint_file + ".");
+        }
+        if (keyword != "element") {
+            header.insert(keyword);
+        }
+    }
+    if (header.size() != 8 + rules_by_name.size()) {
+        throw std::runtime_error("FeatureGeneratorImpl::read_checkpoint - incomplete header in checkpoint " + m_checkpoint_file + ".");
+    }
+    utils::g_log << "Resumed from checkpoint at complexity " << complexity << "." << std::endl;
+    return {complexity, converged};
+}
+
 void FeatureGeneratorImpl::print_statistics() const {
     for (auto& r : m_primitive_rules) r->print_statistics();
     for (auto& r : m_concept_inductive_rules) r->print_statistics();
@@ -213,6 +675,63 @@ void FeatureGeneratorImpl::print_statistics() const {
     for (auto& r : m_numerical_inductive_rules) r->print_statistics();
 }
 
+void FeatureGeneratorImpl::set_num_threads(int num_threads) {
+    if (num_threads < 1) {
+        throw std::runtime_error("FeatureGeneratorImpl::set_num_threads - number of threads must be positive.");
+    }
+    m_num_threads = num_threads;
+}
+
+void FeatureGeneratorImpl::set_use_fingerprints(bool enable) {
+    m_use_fingerprints = enable;
+}
+
+void FeatureGeneratorImpl::set_num_probe_states(int num_probe_states) {
+    if (num_probe_states < 0) {
+        throw std::runtime_error("FeatureGeneratorImpl::set_num_probe_states - number of probe states must be non-negative.");
+    }
+    m_num_probe_states = num_probe_states;
+}
+
+void FeatureGeneratorImpl::set_incremental(bool enable) {
+    m_incremental = enable;
+    if (!enable) {
+        m_last_generation = nullptr;
+    }
+}
+
+void FeatureGeneratorImpl::set_cancellation_token(CancellationToken token) {
+    m_cancellation_token = std::move(token);
+}
+
+void FeatureGeneratorImpl::set_memory_limit(std::size_t num_bytes) {
+    m_memory_limit = num_bytes;
+}
+
+std::size_t FeatureGeneratorImpl::get_peak_num_bytes() const {
+    return m_peak_num_bytes;
+}
+
+void FeatureGeneratorImpl::set_checkpoint_file(const std::string& filename) {
+    m_checkpoint_file = filename;
+}
+
+void FeatureGeneratorImpl::set_boolean_callback(FeatureCallback<core::Boolean, core::BooleanDenotations> callback) {
+    m_boolean_callback = std::move(callback);
+}
+
+void FeatureGeneratorImpl::set_numerical_callback(FeatureCallback<core::Numerical, core::NumericalDenotations> callback) {
+    m_numerical_callback = std::move(callback);
+}
+
+void FeatureGeneratorImpl::set_concept_callback(FeatureCallback<core::Concept, core::ConceptDenotations> callback) {
+    m_concept_callback = std::move(callback);
+}
+
+void FeatureGeneratorImpl::set_role_callback(FeatureCallback<core::Role, core::RoleDenotations> callback) {
+    m_role_callback = std::move(callback);
+}
+
 void FeatureGeneratorImpl::set_generate_empty_boolean(bool enable) {
     b_empty->set_enabled(enable);
 }
@@ -44,6 +44,8 @@
 #include <unordered_set>
 #include <memory>
 #include <bitset>
+#include <string>
+#include <utility>
 
 
 namespace dlplan::generator {
@@ -51,8 +53,37 @@ struct GeneratorData;
 
 using Rule_Ptr = std::shared_ptr<rules::Rule>;
 
+/**
+ * The sample, caches and data of a generation, which an incremental
+ * generator keeps for extending the sample.
+ */
+struct Generation {
+    core::States m_states;
+    core::DenotationsCaches m_caches;
+    std::unique_ptr<GeneratorData> m_data;
+
+    explicit Generation(bool thread_safe);
+    ~Generation();
+};
+
 class FeatureGeneratorImpl {
 private:
+    static constexpr int CHECKPOINT_VERSION = 4;
+
+    int m_num_threads;
+    bool m_use_fingerprints;
+    int m_num_probe_states;
+    bool m_incremental;
+    std::shared_ptr<Generation> m_last_generation;
+    CancellationToken m_cancellation_token;
+    std::size_t m_memory_limit;
+    std::size_t m_peak_num_bytes;
+    std::string m_checkpoint_file;
+    FeatureCallback<core::Boolean, core::BooleanDenotations> m_boolean_callback;
+    FeatureCallback<core::Numerical, core::NumericalDenotations> m_numerical_callback;
+    FeatureCallback<core::Concept, core::ConceptDenotations> m_concept_callback;
+    FeatureCallback<core::Role, core::RoleDenotations> m_role_callback;
+
     std::vector<Rule_Ptr> m_primitive_rules;
     /**
      * Construction rules in iteration i>=2.
@@ -98,26 +129,58 @@ private:
     Rule_Ptr r_transitive_reflexive_closure;
 
 private:
+    /**
+     * Generates the features, starting after the layer of the checkpoint
+     * if from_checkpoint is true.
+     */
+    GeneratedFeatures generate(
+        core::SyntacticElementFactory& factory,
+        const core::States& states,
+        int concept_complexity_limit,
+        int role_complexity_limit,
+        int boolean_complexity_limit,
+        int count_numerical_complexity_limit,
+        int distance_numerical_complexity_limit,
+        int time_limit,
+        int feature_limit,
+        bool from_checkpoint);
+
     /**
      * Generates all Elements with complexity 1.
      */
     void generate_base(
         const core::States& states,
-        GeneratorData& data,
-        core::DenotationsCaches& caches);
+        GeneratorData& data);
 
     /**
      * Inductively generate Elements of higher complexity.
      */
     void generate_inductively(
         const core::States& states,
+        int start_complexity,
         int concept_complexity_limit,
         int role_complexity_limit,
         int boolean_complexity_limit,
         int count_numerical_complexity_limit,
         int distance_numerical_complexity_limit,
-        GeneratorData& data,
-        core::DenotationsCaches& caches);
+        GeneratorData& data);
+
+    /**
+     * Writes the elements of the completed layers up to the given
+     * complexity with the fingerprints of their denotations and the rule
+     * statistics to the checkpoint file, if set, after a header with the
+     * states and settings that determine them.
+     */
+    void write_checkpoint(const GeneratorData& data, int complexity, bool converged) const;
+
+    /**
+     * Restores the elements and rule statistics from the checkpoint file
+     * and returns the complexity of its last layer and whether the
+     * generation had converged. Rejects checkpoints whose header records
+     * other states or settings and elements whose denotations have other
+     * fingerprints.
+     */
+    std::pair<int, bool> read_checkpoint(GeneratorData& data);
 
     /**
      * Print some brief overview.
@@ -146,6 +209,39 @@ public:
         int time_limit,
         int feature_limit);
 
+    /**
+     * Continues the generation from the checkpoint file if it exists.
+     */
+    GeneratedFeatures resume(
+        core::SyntacticElementFactory& factory,
+        const core::States& states,
+        int concept_complexity_limit,
+        int role_complexity_limit,
+        int boolean_complexity_limit,
+        int count_numerical_complexity_limit,
+        int distance_numerical_complexity_limit,
+        int time_limit,
+        int feature_limit);
+
+    /**
+     * Adds the states to the sample of the last generation and readmits
+     * the elements that were dropped as duplicates but differ on them.
+     */
+    GeneratedFeatures extend(const core::States& states);
+
+    void set_num_threads(int num_threads);
+    void set_use_fingerprints(bool enable);
+    void set_num_probe_states(int num_probe_states);
+    void set_incremental(bool enable);
+    void set_cancellation_token(CancellationToken token);
+    void set_memory_limit(std::size_t num_bytes);
+    std::size_t get_peak_num_bytes() const;
+    void set_checkpoint_file(const std::string& filename);
+    void set_boolean_callback(FeatureCallback<core::Boolean, core::BooleanDenotations> callback);
+    void set_numerical_callback(FeatureCallback<core::Numerical, core::NumericalDenotations> callback);
+    void set_concept_callback(FeatureCallback<core::Concept, core::ConceptDenotations> callback);
+    void set_role_callback(FeatureCallback<core::Role, core::RoleDenotations> callback);
+
     /**
      * Set element generation on or off
      */
@@ -4,6 +4,20 @@
 
 
 namespace dlplan::generator {
+CancellationToken::CancellationToken() : m_cancelled(std::make_shared<std::atomic<bool>>(false)) { }
+
+void CancellationToken::cancel() {
+    m_cancelled->store(true);
+}
+
+bool CancellationToken::is_cancelled() const {
+    return m_cancelled->load();
+}
+
+void CancellationToken::reset() {
+    m_cancelled->store(false);
+}
+
 FeatureGenerator::FeatureGenerator() : m_pImpl(FeatureGeneratorImpl()) { }
 
 FeatureGenerator::FeatureGenerator(const FeatureGenerator& other)
@@ -41,6 +55,72 @@ GeneratedFeatures FeatureGenerator::generate(
     return m_pImpl->generate(factory, states, concept_complexity_limit, role_complexity_limit, boolean_complexity_limit, count_numerical_complexity_limit, distance_numerical_complexity_limit, time_limit, feature_limit);
 }
 
+GeneratedFeatures FeatureGenerator::resume(
+    core::SyntacticElementFactory& factory,
+    const core::States& states,
+    int concept_complexity_limit,
+    int role_complexity_limit,
+    int boolean_complexity_limit,
+    int count_numerical_complexity_limit,
+    int distance_numerical_complexity_limit,
+    int time_limit,
+    int feature_limit)
+{
+    return m_pImpl->resume(factory, states, concept_complexity_limit, role_complexity_limit, boolean_complexity_limit, count_numerical_complexity_limit, distance_numerical_complexity_limit, time_limit, feature_limit);
+}
+
+GeneratedFeatures FeatureGenerator::extend(const core::States& states) {
+    return m_pImpl->extend(states);
+}
+
+void FeatureGenerator::set_num_threads(int num_threads) {
+    m_pImpl->set_num_threads(num_threads);
+}
+
+void FeatureGenerator::set_use_fingerprints(bool enable) {
+    m_pImpl->set_use_fingerprints(enable);
+}
+
+void FeatureGenerator::set_num_probe_states(int num_probe_states) {
+    m_pImpl->set_num_probe_states(num_probe_states);
+}
+
+void FeatureGenerator::set_incremental(bool enable) {
+    m_pImpl->set_incremental(enable);
+}
+
+void FeatureGenerator::set_cancellation_token(CancellationToken token) {
+    m_pImpl->set_cancellation_token(std::move(token));
+}
+
+void FeatureGenerator::set_memory_limit(std::size_t num_bytes) {
+    m_pImpl->set_memory_limit(num_bytes);
+}
+
+std::size_t FeatureGenerator::get_peak_num_bytes() const {
+    return m_pImpl->get_peak_num_bytes();
+}
+
+void FeatureGenerator::set_boolean_callback(FeatureCallback<core::Boolean, core::BooleanDenotations> callback) {
+    m_pImpl->set_boolean_callback(std::move(callback));
+}
+
+void FeatureGenerator::set_numerical_callback(FeatureCallback<core::Numerical, core::NumericalDenotations> callback) {
+    m_pImpl->set_numerical_callback(std::move(callback));
+}
+
+void FeatureGenerator::set_concept_callback(FeatureCallback<core::Concept, core::ConceptDenotations> callback) {
+    m_pImpl->set_concept_callback(std::move(callback));
+}
+
+void FeatureGenerator::set_role_callback(FeatureCallback<core::Role, core::RoleDenotations> callback) {
+    m_pImpl->set_role_callback(std::move(callback));
+}
+
+void FeatureGenerator::set_checkpoint_file(const std::string& filename) {
+    m_pImpl->set_checkpoint_file(filename);
+}
+
 void FeatureGenerator::set_generate_empty_boolean(bool enable) {
     m_pImpl->set_generate_empty_boolean(enable);
 }
@@ -0,0 +1,366 @@
+#include "generator_data.h"
+
+#include "rules/rule.h"
+#include "../utils/threadpool.h"
+#include "../../include/dlplan/core/elements/utils.h"
+
+#include <algorithm>
+#include <limits>
+
+
+namespace dlplan::generator {
+
+template<typename Element, typename Denotations>
+bool GeneratorData::contains(
+    const std::unordered_multimap<utils::Fingerprint, std::shared_ptr<const Element>, utils::FingerprintHash>& fingerprints,
+    const utils::Fingerprint& fingerprint,
+    const Denotations& denotations,
+    core::DenotationsCaches& caches) const {
+    auto [begin, end] = fingerprints.equal_range(fingerprint);
+    for (auto it = begin; it != end; ++it) {
+        ++m_num_fingerprint_matches;
+        // The denotations of the element are not kept, hence they are
+        // recomputed from those of its children.
+        if (*it->second->evaluate(m_states, caches) == denotations) {
+            return true;
+        }
+        ++m_num_fingerprint_collisions;
+    }
+    return false;
+}
+
+template<typename Element, typename Denotations>
+bool GeneratorData::insert(
+    std::unordered_set<std::shared_ptr<const Denotations>>& hash_table,
+    std::unordered_multimap<utils::Fingerprint, std::shared_ptr<const Element>, utils::FingerprintHash>& fingerprints,
+    const std::shared_ptr<const Element>& element,
+    const std::shared_ptr<const Denotations>& denotations,
+    core::DenotationsCaches& caches) {
+    if (!m_use_fingerprints) {
+        return hash_table.insert(denotations).second;
+    }
+    auto fingerprint = compute_fingerprint(*denotations);
+    if (contains(fingerprints, fingerprint, *denotations, caches)) {
+        return false;
+    }
+    fingerprints.emplace(fingerprint, element);
+    return true;
+}
+
+void GeneratorData::initialize_probes(int num_probe_states) {
+    m_probe_states.clear();
+    if (num_probe_states >= static_cast<int>(m_states.size())) {
+        return;
+    }
+    const std::size_t max_distance = std::numeric_limits<std::size_t>::max();
+    std::vector<core::AtomIndices> sorted_atom_indices;
+    sorted_atom_indices.reserve(m_states.size());
+    for (const auto& state : m_states) {
+        sorted_atom_indices.push_back(state.get_atom_indices());
+        std::sort(sorted_atom_indices.back().begin(), sorted_atom_indices.back().end());
+    }
+    auto compute_distance = [&](std::size_t left, std::size_t right) {
+        if (m_states[left].get_instance_info() != m_states[right].get_instance_info()) {
+            return max_distance;
+        }
+        const auto& left_atoms = sorted_atom_indices[left];
+        const auto& right_atoms = sorted_atom_indices[right];
+        std::size_t num_common = 0;
+        for (std::size_t i = 0, j = 0; i < left_atoms.size() && j < right_atoms.size();) {
+            if (left_atoms[i] < right_atoms[j]) ++i;
+            else if (right_atoms[j] < left_atoms[i]) ++j;
+            else { ++num_common; ++i; ++j; }
+        }
+        return left_atoms.size() + right_atoms.size() - 2 * num_common;
+    };
+    // Distance of each state to the closest selected state.
+    std::vector<std::size_t> distances(m_states.size(), max_distance);
+    std::size_t next = 0;
+    for (int k = 0; k < num_probe_states; ++k) {
+        m_probe_states.push_back(m_states[next]);
+        for (std::size_t i = 0; i < m_states.size(); ++i) {
+            distances[i] = std::min(distances[i], compute_distance(i, next));
+        }
+        std::size_t farthest = std::max_element(distances.begin(), distances.end()) - distances.begin();
+        if (distances[farthest] == 0) {
+            // The remaining states equal selected ones.
+            break;
+        }
+        next = farthest;
+    }
+}
+
+template<typename Element>
+bool GeneratorData::is_new_on_probes(
+    const Element& element,
+    const std::unordered_set<utils::Fingerprint, utils::FingerprintHash>& probe_signatures) {
+    if (m_probe_states.empty()
+        || !probe_signatures.count(compute_fingerprint(*element.evaluate(m_probe_states, m_probe_caches)))) {
+        return true;
+    }
+    ++m_num_probe_rejections;
+    return false;
+}
+
+bool GeneratorData::is_new_on_probes(const core::Boolean& element) {
+    return is_new_on_probes(element, m_boolean_probe_signatures);
+}
+
+bool GeneratorData::is_new_on_probes(const core::Numerical& element) {
+    return is_new_on_probes(element, m_numerical_probe_signatures);
+}
+
+bool GeneratorData::is_new_on_probes(const core::Concept& element) {
+    return is_new_on_probes(element, m_concept_probe_signatures);
+}
+
+bool GeneratorData::is_new_on_probes(const core::Role& element) {
+    return is_new_on_probes(element, m_role_probe_signatures);
+}
+
+bool GeneratorData::is_new(const std::shared_ptr<const core::BooleanDenotations>& denotations, core::DenotationsCaches& caches) const {
+    if (m_keep_duplicates) {
+        return true;
+    }
+    if (m_use_fingerprints) {
+        return !contains(m_boolean_fingerprints, compute_fingerprint(*denotations), *denotations, caches);
+    }
+    return !m_boolean_hash_table.count(denotations);
+}
+
+bool GeneratorData::is_new(const std::shared_ptr<const core::NumericalDenotations>& denotations, core::DenotationsCaches& caches) const {
+    if (m_keep_duplicates) {
+        return true;
+    }
+    if (m_use_fingerprints) {
+        return !contains(m_numerical_fingerprints, compute_fingerprint(*denotations), *denotations, caches);
+    }
+    return !m_numerical_hash_table.count(denotations);
+}
+
+bool GeneratorData::is_new(const std::shared_ptr<const core::ConceptDenotations>& denotations, core::DenotationsCaches& caches) const {
+    if (m_keep_duplicates) {
+        return true;
+    }
+    if (m_use_fingerprints) {
+        return !contains(m_concept_fingerprints, compute_fingerprint(*denotations), *denotations, caches);
+    }
+    return !m_concept_hash_table.count(denotations);
+}
+
+bool GeneratorData::is_new(const std::shared_ptr<const core::RoleDenotations>& denotations, core::DenotationsCaches& caches) const {
+    if (m_keep_duplicates) {
+        return true;
+    }
+    if (m_use_fingerprints) {
+        return !contains(m_role_fingerprints, compute_fingerprint(*denotations), *denotations, caches);
+    }
+    return !m_role_hash_table.count(denotations);
+}
+
+template<typename Element>
+static void insert_fingerprints(
+    const std::unordered_multimap<utils::Fingerprint, std::shared_ptr<const Element>, utils::FingerprintHash>& fingerprints,
+    std::unordered_map<core::ElementIndex, utils::Fingerprint>& result) {
+    for (const auto& [fingerprint, element] : fingerprints) {
+        result.emplace(element->get_index(), fingerprint);
+    }
+}
+
+template<typename Element>
+static void insert_fingerprints(
+    const std::vector<std::shared_ptr<const Element>>& elements,
+    const core::States& states,
+    core::DenotationsCaches& caches,
+    std::unordered_map<core::ElementIndex, utils::Fingerprint>& result) {
+    for (const auto& element : elements) {
+        result.emplace(element->get_index(), compute_fingerprint(*element->evaluate(states, caches)));
+    }
+}
+
+std::unordered_map<core::ElementIndex, utils::Fingerprint> GeneratorData::get_fingerprints() const {
+    // Element indices are unique across element types.
+    std::unordered_map<core::ElementIndex, utils::Fingerprint> result;
+    if (m_use_fingerprints) {
+        insert_fingerprints(m_boolean_fingerprints, result);
+        insert_fingerprints(m_numerical_fingerprints, result);
+        insert_fingerprints(m_concept_fingerprints, result);
+        insert_fingerprints(m_role_fingerprints, result);
+    } else {
+        insert_fingerprints(std::get<0>(m_generated_features), m_states, m_caches, result);
+        insert_fingerprints(std::get<1>(m_generated_features), m_states, m_caches, result);
+        insert_fingerprints(std::get<2>(m_generated_features), m_states, m_caches, result);
+        insert_fingerprints(std::get<3>(m_generated_features), m_states, m_caches, result);
+    }
+    // The duplicates that are kept are recomputed, with fingerprints in
+    // caches that are released afterwards.
+    core::DenotationsCaches duplicate_caches;
+    core::DenotationsCaches& caches = m_use_fingerprints ? duplicate_caches : m_caches;
+    for (const auto& [committed, complexity] : m_committed_elements) {
+        std::visit([&](const auto& element) {
+            if (!result.count(element->get_index())) {
+                result.emplace(element->get_index(), compute_fingerprint(*element->evaluate(m_states, caches)));
+            }
+        }, committed);
+    }
+    update_peak_num_bytes(duplicate_caches.data.get_num_bytes());
+    return result;
+}
+
+void GeneratorData::run(GenerationTask& task) {
+    if (!m_use_fingerprints) {
+        task.m_generate(task.m_candidates, m_caches);
+        update_peak_num_bytes();
+        return;
+    }
+    core::DenotationsCaches caches;
+    set_task_memory_budget(caches);
+    task.m_generate(task.m_candidates, caches);
+    update_peak_num_bytes(caches.data.get_num_bytes());
+}
+
+void GeneratorData::set_task_memory_budget(core::DenotationsCaches& caches) const {
+    if (m_memory_limit > 0) {
+        // The tasks that run concurrently share half of the limit.
+        caches.set_memory_budget(m_memory_limit / (2 * m_num_threads), true);
+    }
+}
+
+void GeneratorData::submit(rules::Rule& rule, int target_complexity, std::function<void(GenerationCandidates&, core::DenotationsCaches&)> generate) {
+    GenerationTask task{&rule, target_complexity, std::move(generate), GenerationCandidates()};
+    if (m_num_threads == 1) {
+        run(task);
+        commit(task);
+    } else {
+        m_tasks.push_back(std::move(task));
+    }
+}
+
+void GeneratorData::run_tasks() {
+    utils::threadpool::parallel_for(m_tasks.size(), 1, m_num_threads, [this](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            if (!is_interrupted()) {
+                run(m_tasks[i]);
+            }
+        }
+    });
+    const rules::Rule* rule = nullptr;
+    for (auto& task : m_tasks) {
+        // The sequential generation checks the resource limits before each rule.
+        if (task.m_rule != rule) {
+            if (reached_resource_limit()) break;
+            rule = task.m_rule;
+        }
+        commit(task);
+    }
+    m_tasks.clear();
+}
+
+void GeneratorData::commit(GenerationTask& task) {
+    task.m_rule->increment_pruned(task.m_candidates.m_num_pruned);
+    // The candidates of a task share their children, hence matches are
+    // reevaluated in caches of the whole commitment.
+    core::DenotationsCaches commit_caches;
+    set_task_memory_budget(commit_caches);
+    core::DenotationsCaches& caches = m_use_fingerprints ? commit_caches : m_caches;
+    for (const auto& [element, denotations] : task.m_candidates.m_booleans) {
+        if (add(element, denotations, task.m_target_complexity, caches)) task.m_rule->increment_generated();
+    }
+    for (const auto& [element, denotations] : task.m_candidates.m_numericals) {
+        if (add(element, denotations, task.m_target_complexity, caches)) task.m_rule->increment_generated();
+    }
+    for (const auto& [element, denotations] : task.m_candidates.m_concepts) {
+        if (add(element, denotations, task.m_target_complexity, caches)) task.m_rule->increment_generated();
+    }
+    for (const auto& [element, denotations] : task.m_candidates.m_roles) {
+        if (add(element, denotations, task.m_target_complexity, caches)) task.m_rule->increment_generated();
+    }
+    // The probe caches grow with the committed elements.
+    update_peak_num_bytes(commit_caches.data.get_num_bytes());
+}
+
+bool GeneratorData::add(const std::shared_ptr<const core::Boolean>& element, const std::shared_ptr<const core::BooleanDenotations>& denotations, int complexity, core::DenotationsCaches& caches) {
+    if (m_stopped || !is_new_on_probes(*element)) {
+        return false;
+    }
+    if (m_keep_duplicates) {
+        m_committed_elements.emplace_back(element, complexity);
+    }
+    if (!insert(m_boolean_hash_table, m_boolean_fingerprints, element, denotations, caches)) {
+        return false;
+    }
+    std::get<0>(m_generated_features).push_back(element);
+    m_booleans_by_iteration[complexity].push_back(element);
+    if (!m_probe_states.empty()) {
+        m_boolean_probe_signatures.insert(compute_fingerprint(*element->evaluate(m_probe_states, m_probe_caches)));
+    }
+    if (m_boolean_callback && !m_boolean_callback(element, denotations, complexity)) {
+        m_stopped = true;
+    }
+    return true;
+}
+
+bool GeneratorData::add(const std::shared_ptr<const core::Numerical>& element, const std::shared_ptr<const core::NumericalDenotations>& denotations, int complexity, core::DenotationsCaches& caches) {
+    if (m_stopped || !is_new_on_probes(*element)) {
+        return false;
+    }
+    if (m_keep_duplicates) {
+        m_committed_elements.emplace_back(element, complexity);
+    }
+    if (!insert(m_numerical_hash_table, m_numerical_fingerprints, element, denotations, caches)) {
+        return false;
+    }
+    std::get<1>(m_generated_features).push_back(element);
+    m_numericals_by_iteration[complexity].push_back(element);
+    if (!m_probe_states.empty()) {
+        m_numerical_probe_signatures.insert(compute_fingerprint(*element->evaluate(m_probe_states, m_probe_caches)));
+    }
+    if (m_numerical_callback && !m_numerical_callback(element, denotations, complexity)) {
+        m_stopped = true;
+    }
+    return true;
+}
+
+bool GeneratorData::add(const std::shared_ptr<const core::Concept>& element, const std::shared_ptr<const core::ConceptDenotations>& denotations, int complexity, core::DenotationsCaches& caches) {
+    if (m_stopped || !is_new_on_probes(*element)) {
+        return false;
+    }
+    if (m_keep_duplicates) {
+        m_committed_elements.emplace_back(element, complexity);
+    }
+    if (!insert(m_concept_hash_table, m_concept_fingerprints, element, denotations, caches)) {
+        return false;
+    }
+    std::get<2>(m_generated_features).push_back(element);
+    m_concepts_by_iteration[complexity].push_back(element);
+    if (!m_probe_states.empty()) {
+        m_concept_probe_signatures.insert(compute_fingerprint(*element->evaluate(m_probe_states, m_probe_caches)));
+    }
+    if (m_concept_callback && !m_concept_callback(element, denotations, complexity)) {
+        m_stopped = true;
+    }
+    return true;
+}
+
+bool GeneratorData::add(const std::shared_ptr<const core::Role>& element, const std::shared_ptr<const core::RoleDenotations>& denotations, int complexity, core::DenotationsCaches& caches) {
+    if (m_stopped || !is_new_on_probes(*element)) {
+        return false;
+    }
+    if (m_keep_duplicates) {
+        m_committed_elements.emplace_back(element, complexity);
+    }
+    if (!insert(m_role_hash_table, m_role_fingerprints, element, denotations, caches)) {
+        return false;
+    }
+    std::get<3>(m_generated_features).push_back(element);
+    m_roles_by_iteration[complexity].push_back(element);
+    if (!m_probe_states.empty()) {
+        m_role_probe_signatures.insert(compute_fingerprint(*element->evaluate(m_probe_states, m_probe_caches)));
+    }
+    if (m_role_callback && !m_role_callback(element, denotations, complexity)) {
+        m_stopped = true;
+    }
+    return true;
+}
+
+}
@@ -2,50 +2,201 @@
 #define DLPLAN_SRC_GENERATOR_GENERATOR_DATA_H_
 
 #include "../utils/countdown_timer.h"
+#include "../utils/fingerprint.h"
+#include "../utils/logging.h"
 #include "../../include/dlplan/core.h"
 #include "../../include/dlplan/generator.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
 #include <iostream>
 #include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
 #include <vector>
 
 
 namespace dlplan::generator {
+namespace rules {
+class Rule;
+}
+
+/// @brief Returns the fingerprint of the denotations of an element on the
+///        states, which the fingerprint tables and checkpoints store.
+inline utils::Fingerprint compute_fingerprint(const core::BooleanDenotations& denotations) {
+    // The last block stores the size to distinguish trailing zeros.
+    std::vector<std::uint64_t> blocks(denotations.size() / 64 + 2, 0);
+    for (std::size_t i = 0; i < denotations.size(); ++i) {
+        if (denotations[i]) {
+            blocks[i / 64] |= std::uint64_t(1) << (i % 64);
+        }
+    }
+    blocks.back() = denotations.size();
+    return utils::compute_fingerprint(blocks.data(), blocks.size() * sizeof(std::uint64_t));
+}
+
+inline utils::Fingerprint compute_fingerprint(const core::NumericalDenotations& denotations) {
+    return utils::compute_fingerprint(denotations.data(), denotations.size() * sizeof(int));
+}
+
+template<typename Denotation>
+inline utils::Fingerprint compute_fingerprint(const core::DenotationMatrix<Denotation>& denotations) {
+    return denotations.compute_fingerprint();
+}
+
+/// @brief An element of any type in the log of committed elements.
+using CommittedElement = std::variant<
+    std::shared_ptr<const core::Boolean>,
+    std::shared_ptr<const core::Numerical>,
+    std::shared_ptr<const core::Concept>,
+    std::shared_ptr<const core::Role>>;
+
+/// @brief Elements that a generation task constructed together with their
+///        denotations, in the order of construction.
+struct GenerationCandidates {
+    std::vector<std::pair<std::shared_ptr<const core::Boolean>, std::shared_ptr<const core::BooleanDenotations>>> m_booleans;
+    std::vector<std::pair<std::shared_ptr<const core::Numerical>, std::shared_ptr<const core::NumericalDenotations>>> m_numericals;
+    std::vector<std::pair<std::shared_ptr<const core::Concept>, std::shared_ptr<const core::ConceptDenotations>>> m_concepts;
+    std::vector<std::pair<std::shared_ptr<const core::Role>, std::shared_ptr<const core::RoleDenotations>>> m_roles;
+    // Candidates that were skipped without evaluation.
+    std::size_t m_num_pruned = 0;
+
+    void add(std::shared_ptr<const core::Boolean>&& element, std::shared_ptr<const core::BooleanDenotations>&& denotations) {
+        m_booleans.emplace_back(std::move(element), std::move(denotations));
+    }
+    void add(std::shared_ptr<const core::Numerical>&& element, std::shared_ptr<const core::NumericalDenotations>&& denotations) {
+        m_numericals.emplace_back(std::move(element), std::move(denotations));
+    }
+    void add(std::shared_ptr<const core::Concept>&& element, std::shared_ptr<const core::ConceptDenotations>&& denotations) {
+        m_concepts.emplace_back(std::move(element), std::move(denotations));
+    }
+    void add(std::shared_ptr<const core::Role>&& element, std::shared_ptr<const core::RoleDenotations>&& denotations) {
+        m_roles.emplace_back(std::move(element), std::move(denotations));
+    }
+};
+
+/// @brief Constructs and evaluates the candidates of a rule for a target
+///        complexity in the given caches. Tasks only read elements of
+///        smaller complexities, hence the tasks of the same complexity are
+///        independent.
+struct GenerationTask {
+    rules::Rule* m_rule;
+    int m_target_complexity;
+    std::function<void(GenerationCandidates&, core::DenotationsCaches&)> m_generate;
+    GenerationCandidates m_candidates;
+};
 
 struct GeneratorData {
     core::SyntacticElementFactory& m_factory;
+    const core::States& m_states;
+    core::DenotationsCaches& m_caches;
+    // Denotations are unique in the caches, hence pointers identify them.
     std::unordered_set<std::shared_ptr<const core::BooleanDenotations>> m_boolean_hash_table;
     std::unordered_set<std::shared_ptr<const core::NumericalDenotations>> m_numerical_hash_table;
     std::unordered_set<std::shared_ptr<const core::ConceptDenotations>> m_concept_hash_table;
     std::unordered_set<std::shared_ptr<const core::RoleDenotations>> m_role_hash_table;
+    // Alternatively, map fingerprints of denotations to the elements that
+    // have them such that no denotations on the states are kept. Each task
+    // then evaluates in caches of its own, which recompute the denotations
+    // of the children, and matches are confirmed by reevaluating the element
+    // in these caches.
+    bool m_use_fingerprints;
+    std::unordered_multimap<utils::Fingerprint, std::shared_ptr<const core::Boolean>, utils::FingerprintHash> m_boolean_fingerprints;
+    std::unordered_multimap<utils::Fingerprint, std::shared_ptr<const core::Numerical>, utils::FingerprintHash> m_numerical_fingerprints;
+    std::unordered_multimap<utils::Fingerprint, std::shared_ptr<const core::Concept>, utils::FingerprintHash> m_concept_fingerprints;
+    std::unordered_multimap<utils::Fingerprint, std::shared_ptr<const core::Role>, utils::FingerprintHash> m_role_fingerprints;
+    // Counted by concurrent tasks.
+    mutable std::atomic<std::size_t> m_num_fingerprint_matches;
+    mutable std::atomic<std::size_t> m_num_fingerprint_collisions;
+    // Largest number of bytes of the shared caches together with those of
+    // the caches of a task.
+    mutable std::atomic<std::size_t> m_peak_num_bytes;
+    // With probe states, candidates are first evaluated on the probe
+    // states and dropped if a committed element has the same denotations
+    // there, which may drop candidates that differ on other states.
+    core::States m_probe_states;
+    core::DenotationsCaches m_probe_caches;
+    std::unordered_set<utils::Fingerprint, utils::FingerprintHash> m_boolean_probe_signatures;
+    std::unordered_set<utils::Fingerprint, utils::FingerprintHash> m_numerical_probe_signatures;
+    std::unordered_set<utils::Fingerprint, utils::FingerprintHash> m_concept_probe_signatures;
+    std::unordered_set<utils::Fingerprint, utils::FingerprintHash> m_role_probe_signatures;
+    std::atomic<std::size_t> m_num_probe_rejections;
+    // An incremental generator keeps all committed elements, including the
+    // duplicates, in the order of commitment, such that it can readmit the
+    // duplicates that additional states distinguish. Tasks then pass
+    // duplicates on to the commitment instead of dropping them.
+    bool m_keep_duplicates;
+    std::vector<std::pair<CommittedElement, int>> m_committed_elements;
     std::vector<std::vector<std::shared_ptr<const core::Boolean>>> m_booleans_by_iteration;
     std::vector<std::vector<std::shared_ptr<const core::Numerical>>> m_numericals_by_iteration;
     std::vector<std::vector<std::shared_ptr<const core::Concept>>> m_concepts_by_iteration;
     std::vector<std::vector<std::shared_ptr<const core::Role>>> m_roles_by_iteration;
     GeneratedFeatures m_generated_features;
 
+    // The limits of the concepts, roles, Booleans, count numericals and
+    // distance numericals, which checkpoints record.
+    std::array<int, 5> m_complexity_limits;
+
     // resource constraints
     int m_complexity;
     int m_time_limit;
     int m_feature_limit;
     utils::CountdownTimer m_timer;
+    // Checked by concurrent tasks before each candidate.
+    CancellationToken m_cancellation_token;
+    // Cancelled by SIGINT, which must not cancel the shared token above.
+    CancellationToken m_sigint_token;
+    std::size_t m_memory_limit;
+
+    // Receive the admitted elements, which stops the generation if any
+    // callback returns false.
+    FeatureCallback<core::Boolean, core::BooleanDenotations> m_boolean_callback;
+    FeatureCallback<core::Numerical, core::NumericalDenotations> m_numerical_callback;
+    FeatureCallback<core::Concept, core::ConceptDenotations> m_concept_callback;
+    FeatureCallback<core::Role, core::RoleDenotations> m_role_callback;
+    bool m_stopped;
+
+    // With more than one thread, tasks are collected until run_tasks.
+    int m_num_threads;
+    std::vector<GenerationTask> m_tasks;
 
     GeneratorData(
       core::SyntacticElementFactory& factory,
+      const core::States& states,
+      core::DenotationsCaches& caches,
       int complexity,
       int time_limit,
-      int feature_limit)
+      int feature_limit,
+      int num_threads = 1,
+      bool use_fingerprints = false)
       : m_factory(factory),
+        m_states(states),
+        m_caches(caches),
+        m_use_fingerprints(use_fingerprints),
+        m_num_fingerprint_matches(0),
+        m_num_fingerprint_collisions(0),
+        m_peak_num_bytes(0),
+        m_probe_caches(num_threads > 1),
+        m_num_probe_rejections(0),
+        m_keep_duplicates(false),
         m_booleans_by_iteration(std::vector<std::vector<std::shared_ptr<const core::Boolean>>>(complexity + 1)),
         m_numericals_by_iteration(std::vector<std::vector<std::shared_ptr<const core::Numerical>>>(complexity + 1)),
         m_concepts_by_iteration(std::vector<std::vector<std::shared_ptr<const core::Concept>>>(complexity + 1)),
         m_roles_by_iteration(std::vector<std::vector<std::shared_ptr<const core::Role>>>(complexity + 1)),
+        m_complexity_limits({complexity, complexity, complexity, complexity, complexity}),
         m_complexity(complexity),
         m_time_limit(time_limit),
         m_feature_limit(feature_limit),
-        m_timer(time_limit) { }
+        m_timer(time_limit),
+        m_memory_limit(0),
+        m_stopped(false),
+        m_num_threads(num_threads) { }
 
-    int get_num_features() {
+    int get_num_features() const {
       return std::get<0>(m_generated_features).size() + std::get<1>(m_generated_features).size() + std::get<2>(m_generated_features).size() + std::get<3>(m_generated_features).size();
     }
 
@@ -54,11 +205,142 @@ struct GeneratorData {
                    << "Total role elements: " << std::accumulate(m_roles_by_iteration.begin(), m_roles_by_iteration.end(), 0, [&](int current_sum, const auto& e){ return current_sum + e.size(); }) << std::endl
                    << "Total numerical elements: " << std::accumulate(m_numericals_by_iteration.begin(), m_numericals_by_iteration.end(), 0, [&](int current_sum, const auto& e){ return current_sum + e.size(); }) << std::endl
                    << "Total boolean elements: " << std::accumulate(m_booleans_by_iteration.begin(), m_booleans_by_iteration.end(), 0, [&](int current_sum, const auto& e){ return current_sum + e.size(); }) << std::endl;
+      if (m_use_fingerprints) {
+        utils::g_log << "Fingerprint matches: " << m_num_fingerprint_matches << std::endl
+                     << "Fingerprint collisions: " << m_num_fingerprint_collisions << std::endl;
+      }
+      utils::g_log << "Peak cached bytes: " << m_peak_num_bytes << std::endl;
+      if (!m_probe_states.empty()) {
+        utils::g_log << "Probe states: " << m_probe_states.size() << std::endl
+                     << "Probe rejections: " << m_num_probe_rejections << std::endl;
+      }
     }
 
     bool reached_resource_limit() {
-      return (get_num_features() >= m_feature_limit || m_timer.is_expired());
+      return (m_stopped || get_num_features() >= m_feature_limit || is_interrupted());
     }
+
+    /// @brief Returns the number of bytes of the shared caches.
+    std::size_t get_num_bytes() const {
+      return m_caches.data.get_num_bytes() + m_probe_caches.data.get_num_bytes();
+    }
+
+    /// @brief Raises the peak number of bytes to those of the shared caches
+    ///        plus the given bytes of caches that are about to be released.
+    void update_peak_num_bytes(std::size_t num_released_bytes = 0) const {
+      std::size_t num_bytes = get_num_bytes() + num_released_bytes;
+      std::size_t peak = m_peak_num_bytes.load();
+      while (peak < num_bytes && !m_peak_num_bytes.compare_exchange_weak(peak, num_bytes)) { }
+    }
+
+    /// @brief Returns true iff the cached denotations occupy more bytes
+    ///        than the memory limit, now or in the caches of a completed
+    ///        task.
+    bool reached_memory_limit() const {
+      return m_memory_limit > 0 && std::max(get_num_bytes(), m_peak_num_bytes.load()) > m_memory_limit;
+    }
+
+    /// @brief Returns true iff the generation was cancelled or reached the
+    ///        time or memory limit. Unlike the other limits, these are
+    ///        safe to check from concurrent tasks, which check them before
+    ///        constructing each candidate.
+    bool is_interrupted() const {
+      return m_cancellation_token.is_cancelled() || m_sigint_token.is_cancelled() || m_timer.is_expired() || reached_memory_limit();
+    }
+
+    /// @brief Returns true iff no committed element has the denotations
+    ///        or duplicates are kept. Tasks use it to drop candidates early
+    ///        and pass their caches, in which matching fingerprints are
+    ///        reevaluated.
+    bool is_new(const std::shared_ptr<const core::BooleanDenotations>& denotations, core::DenotationsCaches& caches) const;
+    bool is_new(const std::shared_ptr<const core::NumericalDenotations>& denotations, core::DenotationsCaches& caches) const;
+    bool is_new(const std::shared_ptr<const core::ConceptDenotations>& denotations, core::DenotationsCaches& caches) const;
+    bool is_new(const std::shared_ptr<const core::RoleDenotations>& denotations, core::DenotationsCaches& caches) const;
+
+    /// @brief Selects up to the given number of probe states, greedily
+    ///        taking the state whose atoms differ most from those of the
+    ///        selected states. States of different instances differ most.
+    ///        Selects none if the number is not smaller than the number of
+    ///        states.
+    void initialize_probes(int num_probe_states);
+
+    /// @brief Returns false iff probe states are selected and a committed
+    ///        element has the same denotations on them as the element.
+    bool is_new_on_probes(const core::Boolean& element);
+    bool is_new_on_probes(const core::Numerical& element);
+    bool is_new_on_probes(const core::Concept& element);
+    bool is_new_on_probes(const core::Role& element);
+
+    template<typename Element>
+    bool is_new_on_probes(
+      const Element& element,
+      const std::unordered_set<utils::Fingerprint, utils::FingerprintHash>& probe_signatures);
+
+    /// @brief Returns true iff an element with equal denotations is in the
+    ///        fingerprint table. Reevaluates the elements whose fingerprint
+    ///        matches in the given caches, which share the denotations of
+    ///        their children across matches, and counts the matches that
+    ///        are collisions.
+    template<typename Element, typename Denotations>
+    bool contains(
+      const std::unordered_multimap<utils::Fingerprint, std::shared_ptr<const Element>, utils::FingerprintHash>& fingerprints,
+      const utils::Fingerprint& fingerprint,
+      const Denotations& denotations,
+      core::DenotationsCaches& caches) const;
+
+    /// @brief Inserts the element if no committed element has its
+    ///        denotations and returns true iff it was inserted.
+    template<typename Element, typename Denotations>
+    bool insert(
+      std::unordered_set<std::shared_ptr<const Denotations>>& hash_table,
+      std::unordered_multimap<utils::Fingerprint, std::shared_ptr<const Element>, utils::FingerprintHash>& fingerprints,
+      const std::shared_ptr<const Element>& element,
+      const std::shared_ptr<const Denotations>& denotations,
+      core::DenotationsCaches& caches);
+
+    /// @brief Returns the fingerprints of the denotations of the generated
+    ///        features and the kept duplicates by element index. These are
+    ///        the keys of the fingerprint tables or are computed from the
+    ///        cached denotations.
+    std::unordered_map<core::ElementIndex, utils::Fingerprint> get_fingerprints() const;
+
+    /// @brief Runs the task in the shared caches or, with fingerprints, in
+    ///        caches of its own that are released when it completes. With a
+    ///        memory limit, these caches also evict the denotations of the
+    ///        elements that the last candidates did not use.
+    void run(GenerationTask& task);
+
+    /// @brief Bounds caches of a task by its share of the memory limit,
+    ///        evicting the denotations of the elements that the last
+    ///        candidates did not use.
+    void set_task_memory_budget(core::DenotationsCaches& caches) const;
+
+    /// @brief Runs the task and commits its candidates immediately if there
+    ///        is a single thread. Otherwise, defers the task to run_tasks.
+    void submit(rules::Rule& rule, int target_complexity, std::function<void(GenerationCandidates&, core::DenotationsCaches&)> generate);
+
+    /// @brief Runs the deferred tasks concurrently and then commits their
+    ///        candidates in the order of submission. Hence, the first
+    ///        element with a denotation is kept as in the sequential case.
+    void run_tasks();
+
+    /// @brief Adds the candidates with new denotations to the generated
+    ///        features and the elements of the target complexity. With
+    ///        fingerprints, reevaluates matches in caches of the commitment.
+    void commit(GenerationTask& task);
+
+    /// @brief Adds the element to the generated features and the elements
+    ///        of the given complexity unless a committed element has the
+    ///        denotations and the generation was not stopped. Returns true
+    ///        iff the element was added. Passes it to the callback. Keeps
+    ///        the element if duplicates are kept, even if it was not added.
+    ///        Screens the element on the probe states again, because
+    ///        concurrent tasks only screen against earlier layers.
+    ///        Reevaluates matching fingerprints in the given caches.
+    bool add(const std::shared_ptr<const core::Boolean>& element, const std::shared_ptr<const core::BooleanDenotations>& denotations, int complexity, core::DenotationsCaches& caches);
+    bool add(const std::shared_ptr<const core::Numerical>& element, const std::shared_ptr<const core::NumericalDenotations>& denotations, int complexity, core::DenotationsCaches& caches);
+    bool add(const std::shared_ptr<const core::Concept>& element, const std::shared_ptr<const core::ConceptDenotations>& denotations, int complexity, core::DenotationsCaches& caches);
+    bool add(const std::shared_ptr<const core::Role>& element, const std::shared_ptr<const core::RoleDenotations>& denotations, int complexity, core::DenotationsCaches& caches);
 };
 
 }
@@ -4,25 +4,32 @@
 
 
 namespace dlplan::generator::rules {
-void EmptyBoolean::generate_impl(const core::States& states, int target_complexity, dlplan::generator::GeneratorData& data, core::DenotationsCaches& caches) {
-    core::SyntacticElementFactory& factory = data.m_factory;
+void EmptyBoolean::generate_impl(const core::States& states, int target_complexity, dlplan::generator::GeneratorData& data) {
     for (const auto& concept_ : data.m_concepts_by_iteration[target_complexity-1]) {
-        auto element = factory.make_empty_boolean(concept_);
-        auto denotations = element->evaluate(states, caches);
-        if (data.m_boolean_hash_table.insert(denotations).second) {
-            std::get<0>(data.m_generated_features).push_back(element);
-            data.m_booleans_by_iteration[target_complexity].push_back(std::move(element));
-            increment_generated();
-        }
+        data.submit(*this, target_complexity, [&states, &data, concept_](GenerationCandidates& candidates, core::DenotationsCaches& caches) {
+            core::SyntacticElementFactory& factory = data.m_factory;
+            if (data.is_interrupted()) return;
+            auto element = factory.make_empty_boolean(concept_);
+            if (data.is_new_on_probes(*element)) {
+                auto denotations = element->evaluate(states, caches);
+                if (data.is_new(denotations, caches)) {
+                    candidates.add(std::move(element), std::move(denotations));
+                }
+            }
+        });
     }
     for (const auto& role : data.m_roles_by_iteration[target_complexity-1]) {
-        auto element = factory.make_empty_boolean(role);
-        auto denotations = element->evaluate(states, caches);
-        if (data.m_boolean_hash_table.insert(denotations).second) {
-            std::get<0>(data.m_generated_features).push_back(element);
-            data.m_booleans_by_iteration[target_complexity].push_back(std::move(element));
-            increment_generated();
-        }
+        data.submit(*this, target_complexity, [&states, &data, role](GenerationCandidates& candidates, core::DenotationsCaches& caches) {
+            core::SyntacticElementFactory& factory = data.m_factory;
+            if (data.is_interrupted()) return;
+            auto element = factory.make_empty_boolean(role);
+            if (data.is_new_on_probes(*element)) {
+                auto denotations = element->evaluate(states, caches);
+                if (data.is_new(denotations, caches)) {
+                    candidates.add(std::move(element), std::move(denotations));
+                }
+            }
+        });
     }
 }
 
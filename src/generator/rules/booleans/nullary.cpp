@@ -4,20 +4,23 @@
 
 
 namespace dlplan::generator::rules {
-void NullaryBoolean::generate_impl(const core::States& states, int target_complexity, GeneratorData& data, core::DenotationsCaches& caches) {
+void NullaryBoolean::generate_impl(const core::States& states, int target_complexity, GeneratorData& data) {
     assert(target_complexity == 1);
-    core::SyntacticElementFactory& factory = data.m_factory;
-    for (const auto& predicate : factory.get_vocabulary_info()->get_predicates()) {
-        if (predicate.get_arity() == 0) {
-            auto element = factory.make_nullary_boolean(predicate);
-            auto denotations = element->evaluate(states, caches);
-            if (data.m_boolean_hash_table.insert(denotations).second) {
-                std::get<0>(data.m_generated_features).push_back(element);
-                data.m_booleans_by_iteration[target_complexity].push_back(std::move(element));
-                increment_generated();
+    data.submit(*this, target_complexity, [&states, &data](GenerationCandidates& candidates, core::DenotationsCaches& caches) {
+        core::SyntacticElementFactory& factory = data.m_factory;
+        for (const auto& predicate : factory.get_vocabulary_info()->get_predicates()) {
+            if (predicate.get_arity() == 0) {
+                if (data.is_interrupted()) return;
+                auto element = factory.make_nullary_boolean(predicate);
+                if (data.is_new_on_probes(*element)) {
+                    auto denotations = element->evaluate(states, caches);
+                    if (data.is_new(denotations, caches)) {
+                        candidates.add(std::move(element), std::move(denotations));
+                    }
+                }
             }
         }
-    }
+    });
 }
 
 std::string NullaryBoolean::get_name() const {
@@ -1,23 +1,43 @@
 #include "and.h"
 
+#include "../../canonicalization.h"
 #include "../../generator_data.h"
 
 
 namespace dlplan::generator::rules {
-void AndConcept::generate_impl(const core::States& states, int target_complexity, GeneratorData& data, core::DenotationsCaches& caches) {
-    core::SyntacticElementFactory& factory = data.m_factory;
+void AndConcept::generate_impl(const core::States& states, int target_complexity, GeneratorData& data) {
     for (int i = 1; i < target_complexity - 1; ++i) {
         int j = target_complexity - i - 1;
-        for (const auto& c1 : data.m_concepts_by_iteration[i]) {
-            for (const auto& c2 : data.m_concepts_by_iteration[j]) {
-                auto element = factory.make_and_concept(c1, c2);
-                auto denotations = element->evaluate(states, caches);
-                if (data.m_concept_hash_table.insert(denotations).second) {
-                    std::get<2>(data.m_generated_features).push_back(element);
-                    data.m_concepts_by_iteration[target_complexity].push_back(std::move(element));
-                    increment_generated();
+        const auto& concepts_1 = data.m_concepts_by_iteration[i];
+        if (i > j) {
+            // The operation is commutative and the swapped pairs came first.
+            increment_pruned(concepts_1.size() * data.m_concepts_by_iteration[j].size());
+            continue;
+        }
+        for (std::size_t k = 0; k < concepts_1.size(); ++k) {
+            const auto& c1 = concepts_1[k];
+            // For i = j, the pairs up to the diagonal came first or are redundant.
+            std::size_t begin = (i == j) ? k + 1 : 0;
+            increment_pruned(begin);
+            data.submit(*this, target_complexity, [&states, &data, c1, j, begin](GenerationCandidates& candidates, core::DenotationsCaches& caches) {
+                core::SyntacticElementFactory& factory = data.m_factory;
+                const auto& concepts_2 = data.m_concepts_by_iteration[j];
+                for (std::size_t l = begin; l < concepts_2.size(); ++l) {
+                    const auto& c2 = concepts_2[l];
+                    if (canonicalization::is_redundant_and(*c1, *c2)) {
+                        ++candidates.m_num_pruned;
+                        continue;
+                    }
+                    if (data.is_interrupted()) return;
+                    auto element = factory.make_and_concept(c1, c2);
+                    if (data.is_new_on_probes(*element)) {
+                        auto denotations = element->evaluate(states, caches);
+                        if (data.is_new(denotations, caches)) {
+                            candidates.add(std::move(element), std::move(denotations));
+                        }
+                    }
                 }
-            }
+            });
         }
     }
 }
@@ -7,7 +7,7 @@
 namespace dlplan::generator::rules {
 class AndConcept : public Rule {
 public:
-    void generate_impl(const core::States& states, int target_complexity, GeneratorData& data, core::DenotationsCaches& caches) override;
+    void generate_impl(const core::States& states, int target_complexity, GeneratorData& data) override;
 
     std::string get_name() const override;
 };
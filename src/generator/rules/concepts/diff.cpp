@@ -1,23 +1,31 @@
 #include "diff.h"
 
+#include "../../canonicalization.h"
 #include "../../generator_data.h"
 
 
 namespace dlplan::generator::rules {
-void DiffConcept::generate_impl(const core::States& states, int target_complexity, GeneratorData& data, core::DenotationsCaches& caches) {
-    core::SyntacticElementFactory& factory = data.m_factory;
+void DiffConcept::generate_impl(const core::States& states, int target_complexity, GeneratorData& data) {
     for (int i = 1; i < target_complexity - 1; ++i) {
         int j = target_complexity - i - 1;
         for (const auto& c1 : data.m_concepts_by_iteration[i]) {
-            for (const auto& c2 : data.m_concepts_by_iteration[j]) {
-                auto element = factory.make_diff_concept(c1, c2);
-                auto denotations = element->evaluate(states, caches);
-                if (data.m_concept_hash_table.insert(denotations).second) {
-                    std::get<2>(data.m_generated_features).push_back(element);
-                    data.m_concepts_by_iteration[target_complexity].push_back(std::move(element));
-                    increment_generated();
+            data.submit(*this, target_complexity, [&states, &data, c1, j](GenerationCandidates& candidates, core::DenotationsCaches& caches) {
+                core::SyntacticElementFactory& factory = data.m_factory;
+                for (const auto& c2 : data.m_concepts_by_iteration[j]) {
+                    if (canonicalization::is_redundant_diff(*c1, *c2)) {
+                        ++candidates.m_num_pruned;
+                        continue;
+                    }
+                    if (data.is_interrupted()) return;
+                    auto element = factory.make_diff_concept(c1, c2);
+                    if (data.is_new_on_probes(*element)) {
+                        auto denotations = element->evaluate(states, caches);
+                        if (data.is_new(denotations, caches)) {
+                            candidates.add(std::move(element), std::move(denotations));
+                        }
+                    }
                 }
-            }
+            });
         }
     }
 }
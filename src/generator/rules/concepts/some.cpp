@@ -4,20 +4,23 @@
 
 
 namespace dlplan::generator::rules {
-void SomeConcept::generate_impl(const core::States& states, int target_complexity, GeneratorData& data, core::DenotationsCaches& caches) {
-    core::SyntacticElementFactory& factory = data.m_factory;
+void SomeConcept::generate_impl(const core::States& states, int target_complexity, GeneratorData& data) {
     for (int i = 1; i < target_complexity - 1; ++i) {
         int j = target_complexity - i - 1;
         for (const auto& r : data.m_roles_by_iteration[i]) {
-            for (const auto& c : data.m_concepts_by_iteration[j]) {
-                auto element = factory.make_some_concept(r, c);
-                auto denotations = element->evaluate(states, caches);
-                if (data.m_concept_hash_table.insert(denotations).second) {
-                    std::get<2>(data.m_generated_features).push_back(element);
-                    data.m_concepts_by_iteration[target_complexity].push_back(std::move(element));
-                    increment_generated();
+            data.submit(*this, target_complexity, [&states, &data, r, j](GenerationCandidates& candidates, core::DenotationsCaches& caches) {
+                core::SyntacticElementFactory& factory = data.m_factory;
+                for (const auto& c : data.m_concepts_by_iteration[j]) {
+                    if (data.is_interrupted()) return;
+                    auto element = factory.make_some_concept(r, c);
+                    if (data.is_new_on_probes(*element)) {
+                        auto denotations = element->evaluate(states, caches);
+                        if (data.is_new(denotations, caches)) {
+                            candidates.add(std::move(element), std::move(denotations));
+                        }
+                    }
                 }
-            }
+            });
         }
     }
 }
@@ -4,16 +4,19 @@
 
 
 namespace dlplan::generator::rules {
-void TopConcept::generate_impl(const core::States& states, int target_complexity, GeneratorData& data, core::DenotationsCaches& caches) {
+void TopConcept::generate_impl(const core::States& states, int target_complexity, GeneratorData& data) {
     assert(target_complexity == 1);
-    core::SyntacticElementFactory& factory = data.m_factory;
-    auto element = factory.make_top_concept();
-    auto denotations = element->evaluate(states, caches);
-    if (data.m_concept_hash_table.insert(denotations).second) {
-        std::get<2>(data.m_generated_features).push_back(element);
-        data.m_concepts_by_iteration[target_complexity].push_back(std::move(element));
-        increment_generated();
-    }
+    data.submit(*this, target_complexity, [&states, &data](GenerationCandidates& candidates, core::DenotationsCaches& caches) {
+        core::SyntacticElementFactory& factory = data.m_factory;
+        if (data.is_interrupted()) return;
+        auto element = factory.make_top_concept();
+        if (data.is_new_on_probes(*element)) {
+            auto denotations = element->evaluate(states, caches);
+            if (data.is_new(denotations, caches)) {
+                candidates.add(std::move(element), std::move(denotations));
+            }
+        }
+    });
 }
 
 std::string TopConcept::get_name() const {
@@ -4,39 +4,42 @@
 
 
 namespace dlplan::generator::rules {
-void ConceptDistanceNumerical::generate_impl(const core::States& states, int target_complexity, GeneratorData& data, core::DenotationsCaches& caches) {
-    core::SyntacticElementFactory& factory = data.m_factory;
+void ConceptDistanceNumerical::generate_impl(const core::States& states, int target_complexity, GeneratorData& data) {
     int j = 3;  // R:C has complexity 3
     for (int i = 1; i < target_complexity - j - 1; ++i) {
         int k = target_complexity - i - j - 1;
         for (const auto& c1 : data.m_concepts_by_iteration[i]) {
-            // left role must evaluate to concept denotation that contains exactly one object.
-            auto c1_denotations = c1->evaluate(states, caches);
-            bool one = true;
-            for (const auto& denot_ptr : *c1_denotations) {
-                if (denot_ptr->size() != 1) {
-                    one = false;
-                    break;
+            data.submit(*this, target_complexity, [&states, &data, c1, j, k](GenerationCandidates& candidates, core::DenotationsCaches& caches) {
+                core::SyntacticElementFactory& factory = data.m_factory;
+                // left role must evaluate to concept denotation that contains exactly one object.
+                auto c1_denotations = c1->evaluate(states, caches);
+                bool one = true;
+                for (size_t l = 0; l < c1_denotations->size(); ++l) {
+                    if (c1_denotations->count(l) != 1) {
+                        one = false;
+                        break;
+                    }
                 }
-            }
-            if (!one) {
-                continue;
-            }
-            for (const auto& r : data.m_roles_by_iteration[j]) {
-                // middle role must be restriction
-                if (r->str().substr(0, 10) != "r_restrict") {
-                    continue;
+                if (!one) {
+                    return;
                 }
-                for (const auto& c2 : data.m_concepts_by_iteration[k]) {
-                    auto element = factory.make_concept_distance_numerical(c1, r, c2);
-                    auto denotations = element->evaluate(states, caches);
-                    if (data.m_numerical_hash_table.insert(denotations).second) {
-                        std::get<1>(data.m_generated_features).push_back(element);
-                        data.m_numericals_by_iteration[target_complexity].push_back(std::move(element));
-                        increment_generated();
+                for (const auto& r : data.m_roles_by_iteration[j]) {
+                    // middle role must be restriction
+                    if (r->str().substr(0, 10) != "r_restrict") {
+                        continue;
+                    }
+                    for (const auto& c2 : data.m_concepts_by_iteration[k]) {
+                        if (data.is_interrupted()) return;
+                        auto element = factory.make_concept_distance_numerical(c1, r, c2);
+                        if (data.is_new_on_probes(*element)) {
+                            auto denotations = element->evaluate(states, caches);
+                            if (data.is_new(denotations, caches)) {
+                                candidates.add(std::move(element), std::move(denotations));
+                            }
+                        }
                     }
                 }
-            }
+            });
         }
     }
 
@@ -44,29 +47,33 @@ void ConceptDistanceNumerical::generate_impl(const core::States& states, int tar
     for (int i = 1; i < target_complexity - j - 1; ++i) {
         int k = target_complexity - i - j - 1;
         for (const auto& c1 : data.m_concepts_by_iteration[i]) {
-            // left role must evaluate to concept denotation that contains exactly one object.
-            auto c1_denotations = c1->evaluate(states, caches);
-            bool one = true;
-            for (const auto& denot_ptr : *c1_denotations) {
-                if (denot_ptr->size() != 1) {
-                    one = false;
-                    break;
+            data.submit(*this, target_complexity, [&states, &data, c1, j, k](GenerationCandidates& candidates, core::DenotationsCaches& caches) {
+                core::SyntacticElementFactory& factory = data.m_factory;
+                // left role must evaluate to concept denotation that contains exactly one object.
+                auto c1_denotations = c1->evaluate(states, caches);
+                bool one = true;
+                for (size_t l = 0; l < c1_denotations->size(); ++l) {
+                    if (c1_denotations->count(l) != 1) {
+                        one = false;
+                        break;
+                    }
+                }
+                if (!one) {
+                    return;
                 }
-            }
-            if (!one) {
-                continue;
-            }
-            for (const auto& r : data.m_roles_by_iteration[j]) {
-                for (const auto& c2 : data.m_concepts_by_iteration[k]) {
-                    auto element = factory.make_concept_distance_numerical(c1, r, c2);
-                    auto denotations = element->evaluate(states, caches);
-                    if (data.m_numerical_hash_table.insert(denotations).second) {
-                        std::get<1>(data.m_generated_features).push_back(element);
-                        data.m_numericals_by_iteration[target_complexity].push_back(std::move(element));
-                        increment_generated();
+                for (const auto& r : data.m_roles_by_iteration[j]) {
+                    for (const auto& c2 : data.m_concepts_by_iteration[k]) {
+                        if (data.is_interrupted()) return;
+                        auto element = factory.make_concept_distance_numerical(c1, r, c2);
+                        if (data.is_new_on_probes(*element)) {
+                            auto denotations = element->evaluate(states, caches);
+                            if (data.is_new(denotations, caches)) {
+                                candidates.add(std::move(element), std::move(denotations));
+                            }
+                        }
                     }
                 }
-            }
+            });
         }
     }
 }
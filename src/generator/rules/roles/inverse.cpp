@@ -1,19 +1,27 @@
 #include "inverse.h"
 
+#include "../../canonicalization.h"
 #include "../../generator_data.h"
 
 
 namespace dlplan::generator::rules {
-void InverseRole::generate_impl(const core::States& states, int target_complexity, GeneratorData& data, core::DenotationsCaches& caches) {
-    core::SyntacticElementFactory& factory = data.m_factory;
+void InverseRole::generate_impl(const core::States& states, int target_complexity, GeneratorData& data) {
     for (const auto& r : data.m_roles_by_iteration[target_complexity-1]) {
-        auto element = factory.make_inverse_role(r);
-        auto denotations = element->evaluate(states, caches);
-        if (data.m_role_hash_table.insert(denotations).second) {
-            std::get<3>(data.m_generated_features).push_back(element);
-            data.m_roles_by_iteration[target_complexity].push_back(std::move(element));
-            increment_generated();
+        if (canonicalization::is_redundant_inverse(*r)) {
+            increment_pruned();
+            continue;
         }
+        data.submit(*this, target_complexity, [&states, &data, r](GenerationCandidates& candidates, core::DenotationsCaches& caches) {
+            core::SyntacticElementFactory& factory = data.m_factory;
+            if (data.is_interrupted()) return;
+            auto element = factory.make_inverse_role(r);
+            if (data.is_new_on_probes(*element)) {
+                auto denotations = element->evaluate(states, caches);
+                if (data.is_new(denotations, caches)) {
+                    candidates.add(std::move(element), std::move(denotations));
+                }
+            }
+        });
     }
 }
 
@@ -9,7 +9,7 @@ class InverseRole : public Rule {
 public:
     InverseRole() : Rule() { }
 
-    void generate_impl(const core::States& states, int target_complexity, GeneratorData& data, core::DenotationsCaches& caches) override;
+    void generate_impl(const core::States& states, int target_complexity, GeneratorData& data) override;
 
     std::string get_name() const override;
 };
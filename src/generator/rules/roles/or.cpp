@@ -1,23 +1,43 @@
 #include "or.h"
 
+#include "../../canonicalization.h"
 #include "../../generator_data.h"
 
 
 namespace dlplan::generator::rules {
-void OrRole::generate_impl(const core::States& states, int target_complexity, GeneratorData& data, core::DenotationsCaches& caches) {
-    core::SyntacticElementFactory& factory = data.m_factory;
+void OrRole::generate_impl(const core::States& states, int target_complexity, GeneratorData& data) {
     for (int i = 1; i < target_complexity - 1; ++i) {
         int j = target_complexity - i - 1;
-        for (const auto& r1 : data.m_roles_by_iteration[i]) {
-            for (const auto& r2 : data.m_roles_by_iteration[j]) {
-                auto element = factory.make_or_role(r1, r2);
-                auto denotations = element->evaluate(states, caches);
-                if (data.m_role_hash_table.insert(denotations).second) {
-                    std::get<3>(data.m_generated_features).push_back(element);
-                    data.m_roles_by_iteration[target_complexity].push_back(std::move(element));
-                    increment_generated();
+        const auto& roles_1 = data.m_roles_by_iteration[i];
+        if (i > j) {
+            // The operation is commutative and the swapped pairs came first.
+            increment_pruned(roles_1.size() * data.m_roles_by_iteration[j].size());
+            continue;
+        }
+        for (std::size_t k = 0; k < roles_1.size(); ++k) {
+            const auto& r1 = roles_1[k];
+            // For i = j, the pairs up to the diagonal came first or are redundant.
+            std::size_t begin = (i == j) ? k + 1 : 0;
+            increment_pruned(begin);
+            data.submit(*this, target_complexity, [&states, &data, r1, j, begin](GenerationCandidates& candidates, core::DenotationsCaches& caches) {
+                core::SyntacticElementFactory& factory = data.m_factory;
+                const auto& roles_2 = data.m_roles_by_iteration[j];
+                for (std::size_t l = begin; l < roles_2.size(); ++l) {
+                    const auto& r2 = roles_2[l];
+                    if (canonicalization::is_redundant_or(*r1, *r2)) {
+                        ++candidates.m_num_pruned;
+                        continue;
+                    }
+                    if (data.is_interrupted()) return;
+                    auto element = factory.make_or_role(r1, r2);
+                    if (data.is_new_on_probes(*element)) {
+                        auto denotations = element->evaluate(states, caches);
+                        if (data.is_new(denotations, caches)) {
+                            candidates.add(std::move(element), std::move(denotations));
+                        }
+                    }
                 }
-            }
+            });
         }
     }
 }
@@ -4,17 +4,20 @@
 
 
 namespace dlplan::generator::rules {
-void TransitiveReflexiveClosureRole::generate_impl(const core::States& states, int target_complexity, GeneratorData& data, core::DenotationsCaches& caches) {
+void TransitiveReflexiveClosureRole::generate_impl(const core::States& states, int target_complexity, GeneratorData& data) {
     if (target_complexity == 2) {
-        core::SyntacticElementFactory& factory = data.m_factory;
         for (const auto& r : data.m_roles_by_iteration[target_complexity-1]) {
-            auto element = factory.make_transitive_reflexive_closure(r);
-            auto denotations = element->evaluate(states, caches);
-            if (data.m_role_hash_table.insert(denotations).second) {
-                std::get<3>(data.m_generated_features).push_back(element);
-                data.m_roles_by_iteration[target_complexity].push_back(std::move(element));
-                increment_generated();
-            }
+            data.submit(*this, target_complexity, [&states, &data, r](GenerationCandidates& candidates, core::DenotationsCaches& caches) {
+                core::SyntacticElementFactory& factory = data.m_factory;
+                if (data.is_interrupted()) return;
+                auto element = factory.make_transitive_reflexive_closure(r);
+                if (data.is_new_on_probes(*element)) {
+                    auto denotations = element->evaluate(states, caches);
+                    if (data.is_new(denotations, caches)) {
+                        candidates.add(std::move(element), std::move(denotations));
+                    }
+                }
+            });
         }
     }
 }
@@ -4,6 +4,7 @@
 #include "../../../include/dlplan/core.h"
 #include "../../../src/utils/logging.h"
 
+#include <cstddef>
 #include <string>
 #include <iostream>
 
@@ -24,29 +25,41 @@ protected:
      */
     int m_count;
 
+    /**
+     * Number of candidates that were skipped without evaluation because
+     * they are syntactically redundant.
+     */
+    std::size_t m_num_pruned;
+
 protected:
-    virtual void generate_impl(const core::States& states, int target_complexity, GeneratorData& data, core::DenotationsCaches& caches) = 0;
+    virtual void generate_impl(const core::States& states, int target_complexity, GeneratorData& data) = 0;
 
 public:
-    Rule() : m_enabled(true), m_count(0) { }
+    Rule() : m_enabled(true), m_count(0), m_num_pruned(0) { }
     virtual ~Rule() = default;
 
     void initialize() {
         m_count = 0;
+        m_num_pruned = 0;
     }
 
     /**
-     * Submits tasks to threadpool.
+     * Submits the tasks that generate the candidates of the rule to the data,
+     * which runs them concurrently if there are multiple threads.
      */
-    void generate(const core::States& states, int target_complexity, GeneratorData& data, core::DenotationsCaches& caches) {
+    void generate(const core::States& states, int target_complexity, GeneratorData& data) {
         if (m_enabled) {
-            generate_impl(states, target_complexity, data, caches);
+            generate_impl(states, target_complexity, data);
         }
     }
 
     void print_statistics() const {
         if (m_enabled) {
-          utils::g_log << "    " << get_name() << ": " << m_count << std::endl;
+          utils::g_log << "    " << get_name() << ": " << m_count;
+          if (m_num_pruned > 0) {
+            utils::g_log << " (" << m_num_pruned << " pruned)";
+          }
+          utils::g_log << std::endl;
         }
     }
 
@@ -54,11 +67,35 @@ public:
         m_enabled = enabled;
     }
 
+    bool is_enabled() const {
+        return m_enabled;
+    }
+
     virtual std::string get_name() const = 0;
 
     void increment_generated() {
         ++m_count;
     }
+
+    int get_count() const {
+        return m_count;
+    }
+
+    void set_count(int count) {
+        m_count = count;
+    }
+
+    void increment_pruned(std::size_t num_pruned = 1) {
+        m_num_pruned += num_pruned;
+    }
+
+    std::size_t get_num_pruned() const {
+        return m_num_pruned;
+    }
+
+    void set_num_pruned(std::size_t num_pruned) {
+        m_num_pruned = num_pruned;
+    }
 };
 
 }
@@ -0,0 +1,244 @@
+#include "../../include/dlplan/policy.h"
+
+#include "../../include/dlplan/core.h"
+#include "../../include/dlplan/policy/condition.h"
+#include "../../include/dlplan/policy/effect.h"
+
+#include <stdexcept>
+
+
+namespace dlplan::policy {
+
+using ConditionType = PolicyEvaluationPlan::ConditionType;
+using EffectType = PolicyEvaluationPlan::EffectType;
+
+struct CompileCondition : public BaseConditionVisitor {
+    const core::EvaluationPlan& plan;
+    std::vector<PolicyEvaluationPlan::CompiledFeature<ConditionType>>& conditions;
+
+    CompileCondition(const core::EvaluationPlan& plan_, std::vector<PolicyEvaluationPlan::CompiledFeature<ConditionType>>& conditions_)
+        : plan(plan_), conditions(conditions_) { }
+
+    template<typename Condition>
+    void add(ConditionType type, const Condition& condition) {
+        conditions.push_back({ type, plan.get_slot(*condition.get_named_element()->get_element()) });
+    }
+
+    void visit(const std::shared_ptr<const PositiveBooleanCondition>& condition) override {
+        add(ConditionType::POSITIVE_BOOLEAN, *condition);
+    }
+
+    void visit(const std::shared_ptr<const NegativeBooleanCondition>& condition) override {
+        add(ConditionType::NEGATIVE_BOOLEAN, *condition);
+    }
+
+    void visit(const std::shared_ptr<const GreaterNumericalCondition>& condition) override {
+        add(ConditionType::GREATER_NUMERICAL, *condition);
+    }
+
+    void visit(const std::shared_ptr<const EqualNumericalCondition>& condition) override {
+        add(ConditionType::EQUAL_NUMERICAL, *condition);
+    }
+
+    void visit(const std::shared_ptr<const GreaterConceptCondition>& condition) override {
+        add(ConditionType::GREATER_CONCEPT, *condition);
+    }
+
+    void visit(const std::shared_ptr<const EqualConceptCondition>& condition) override {
+        add(ConditionType::EQUAL_CONCEPT, *condition);
+    }
+};
+
+
+struct CompileEffect : public BaseEffectVisitor {
+    const core::EvaluationPlan& plan;
+    std::vector<PolicyEvaluationPlan::CompiledFeature<EffectType>>& effects;
+
+    CompileEffect(const core::EvaluationPlan& plan_, std::vector<PolicyEvaluationPlan::CompiledFeature<EffectType>>& effects_)
+        : plan(plan_), effects(effects_) { }
+
+    template<typename Effect>
+    void add(EffectType type, const Effect& effect) {
+        effects.push_back({ type, plan.get_slot(*effect.get_named_element()->get_element()) });
+    }
+
+    void visit(const std::shared_ptr<const PositiveBooleanEffect>& effect) override {
+        add(EffectType::POSITIVE_BOOLEAN, *effect);
+    }
+
+    void visit(const std::shared_ptr<const NegativeBooleanEffect>& effect) override {
+        add(EffectType::NEGATIVE_BOOLEAN, *effect);
+    }
+
+    void visit(const std::shared_ptr<const UnchangedBooleanEffect>& effect) override {
+        add(EffectType::UNCHANGED_BOOLEAN, *effect);
+    }
+
+    void visit(const std::shared_ptr<const IncrementNumericalEffect>& effect) override {
+        add(EffectType::INCREMENT_NUMERICAL, *effect);
+    }
+
+    void visit(const std::shared_ptr<const IncrementOrUnchangedNumericalEffect>& effect) override {
+        add(EffectType::INCREMENT_OR_UNCHANGED_NUMERICAL, *effect);
+    }
+
+    void visit(const std::shared_ptr<const DecrementNumericalEffect>& effect) override {
+        add(EffectType::DECREMENT_NUMERICAL, *effect);
+    }
+
+    void visit(const std::shared_ptr<const DecrementOrUnchangedNumericalEffect>& effect) override {
+        add(EffectType::DECREMENT_OR_UNCHANGED_NUMERICAL, *effect);
+    }
+
+    void visit(const std::shared_ptr<const UnchangedNumericalEffect>& effect) override {
+        add(EffectType::UNCHANGED_NUMERICAL, *effect);
+    }
+
+    void visit(const std::shared_ptr<const GreaterNumericalEffect>& effect) override {
+        add(EffectType::GREATER_NUMERICAL, *effect);
+    }
+
+    void visit(const std::shared_ptr<const EqualNumericalEffect>& effect) override {
+        add(EffectType::EQUAL_NUMERICAL, *effect);
+    }
+
+    void visit(const std::shared_ptr<const IncrementConceptEffect>& effect) override {
+        add(EffectType::INCREMENT_CONCEPT, *effect);
+    }
+
+    void visit(const std::shared_ptr<const DecrementConceptEffect>& effect) override {
+        add(EffectType::DECREMENT_CONCEPT, *effect);
+    }
+
+    void visit(const std::shared_ptr<const UnchangedConceptEffect>& effect) override {
+        add(EffectType::UNCHANGED_CONCEPT, *effect);
+    }
+
+    void visit(const std::shared_ptr<const GreaterConceptEffect>& effect) override {
+        add(EffectType::GREATER_CONCEPT, *effect);
+    }
+
+    void visit(const std::shared_ptr<const EqualConceptEffect>& effect) override {
+        add(EffectType::EQUAL_CONCEPT, *effect);
+    }
+};
+
+
+PolicyEvaluationPlan::PolicyEvaluationPlan(const Policy& policy) : m_policy_index(policy.get_index()) {
+    std::vector<std::shared_ptr<const core::Boolean>> booleans;
+    for (const auto& boolean : policy.get_booleans()) {
+        booleans.push_back(boolean->get_element());
+    }
+    std::vector<std::shared_ptr<const core::Numerical>> numericals;
+    for (const auto& numerical : policy.get_numericals()) {
+        numericals.push_back(numerical->get_element());
+    }
+    std::vector<std::shared_ptr<const core::Concept>> concepts;
+    for (const auto& concept_ : policy.get_concepts()) {
+        concepts.push_back(concept_->get_element());
+    }
+    m_plan = std::make_shared<const core::EvaluationPlan>(booleans, numericals, concepts);
+    for (const auto& rule : policy.get_rules()) {
+        CompiledRule compiled_rule{ rule, {}, {} };
+        CompileCondition compile_condition(*m_plan, compiled_rule.conditions);
+        for (const auto& condition : rule->get_conditions()) {
+            condition->accept(compile_condition);
+        }
+        CompileEffect compile_effect(*m_plan, compiled_rule.effects);
+        for (const auto& effect : rule->get_effects()) {
+            effect->accept(compile_effect);
+        }
+        if (rule->get_index() >= static_cast<int>(m_rule_positions.size())) {
+            m_rule_positions.resize(rule->get_index() + 1, -1);
+        }
+        m_rule_positions[rule->get_index()] = m_rules.size();
+        m_rules.push_back(std::move(compiled_rule));
+    }
+}
+
+const PolicyEvaluationPlan::CompiledRule* PolicyEvaluationPlan::get_rule(const Rule& rule) const {
+    if (rule.get_index() >= static_cast<int>(m_rule_positions.size()) || m_rule_positions[rule.get_index()] == -1) {
+        return nullptr;
+    }
+    return &m_rules[m_rule_positions[rule.get_index()]];
+}
+
+const std::vector<PolicyEvaluationPlan::CompiledRule>& PolicyEvaluationPlan::get_rules() const {
+    return m_rules;
+}
+
+const std::shared_ptr<const core::EvaluationPlan>& PolicyEvaluationPlan::get_plan() const {
+    return m_plan;
+}
+
+int PolicyEvaluationPlan::get_policy_index() const {
+    return m_policy_index;
+}
+
+bool PolicyEvaluationPlan::evaluate_conditions(const CompiledRule& rule, const core::EvaluationFrame& source_frame) {
+    for (const auto& condition : rule.conditions) {
+        bool holds;
+        switch (condition.type) {
+            case ConditionType::POSITIVE_BOOLEAN: holds = source_frame.get_boolean_denotation(condition.slot); break;
+            case ConditionType::NEGATIVE_BOOLEAN: holds = !source_frame.get_boolean_denotation(condition.slot); break;
+            case ConditionType::GREATER_NUMERICAL: holds = source_frame.get_numerical_denotation(condition.slot) > 0; break;
+            case ConditionType::EQUAL_NUMERICAL: holds = source_frame.get_numerical_denotation(condition.slot) == 0; break;
+            case ConditionType::GREATER_CONCEPT: holds = source_frame.get_concept_denotation(condition.slot).size() > 0; break;
+            case ConditionType::EQUAL_CONCEPT: holds = source_frame.get_concept_denotation(condition.slot).size() == 0; break;
+            default: throw std::runtime_error("PolicyEvaluationPlan::evaluate_conditions - unknown condition type.");
+        }
+        if (!holds) return false;
+    }
+    return true;
+}
+
+bool PolicyEvaluationPlan::evaluate_effects(const CompiledRule& rule, const core::EvaluationFrame& source_frame, const core::EvaluationFrame& target_frame) {
+    for (const auto& effect : rule.effects) {
+        bool holds;
+        switch (effect.type) {
+            case EffectType::POSITIVE_BOOLEAN: holds = target_frame.get_boolean_denotation(effect.slot); break;
+            case EffectType::NEGATIVE_BOOLEAN: holds = !target_frame.get_boolean_denotation(effect.slot); break;
+            case EffectType::UNCHANGED_BOOLEAN: holds = source_frame.get_boolean_denotation(effect.slot) == target_frame.get_boolean_denotation(effect.slot); break;
+            case EffectType::INCREMENT_NUMERICAL: holds = source_frame.get_numerical_denotation(effect.slot) < target_frame.get_numerical_denotation(effect.slot); break;
+            case EffectType::INCREMENT_OR_UNCHANGED_NUMERICAL: holds = source_frame.get_numerical_denotation(effect.slot) <= target_frame.get_numerical_denotation(effect.slot); break;
+            case EffectType::DECREMENT_NUMERICAL: holds = source_frame.get_numerical_denotation(effect.slot) > target_frame.get_numerical_denotation(effect.slot); break;
+            case EffectType::DECREMENT_OR_UNCHANGED_NUMERICAL: holds = source_frame.get_numerical_denotation(effect.slot) >= target_frame.get_numerical_denotation(effect.slot); break;
+            case EffectType::UNCHANGED_NUMERICAL: holds = source_frame.get_numerical_denotation(effect.slot) == target_frame.get_numerical_denotation(effect.slot); break;
+            case EffectType::GREATER_NUMERICAL: holds = target_frame.get_numerical_denotation(effect.slot) > 0; break;
+            case EffectType::EQUAL_NUMERICAL: holds = target_frame.get_numerical_denotation(effect.slot) == 0; break;
+            case EffectType::INCREMENT_CONCEPT: holds = source_frame.get_concept_denotation(effect.slot).size() < target_frame.get_concept_denotation(effect.slot).size(); break;
+            case EffectType::DECREMENT_CONCEPT: holds = source_frame.get_concept_denotation(effect.slot).size() > target_frame.get_concept_denotation(effect.slot).size(); break;
+            case EffectType::UNCHANGED_CONCEPT: holds = source_frame.get_concept_denotation(effect.slot).size() == target_frame.get_concept_denotation(effect.slot).size(); break;
+            case EffectType::GREATER_CONCEPT: holds = target_frame.get_concept_denotation(effect.slot).size() > 0; break;
+            case EffectType::EQUAL_CONCEPT: holds = target_frame.get_concept_denotation(effect.slot).size() == 0; break;
+            default: throw std::runtime_error("PolicyEvaluationPlan::evaluate_effects - unknown effect type.");
+        }
+        if (!holds) return false;
+    }
+    return true;
+}
+
+
+PolicyEvaluationFrames::PolicyEvaluationFrames(std::shared_ptr<const PolicyEvaluationPlan> plan)
+    : m_plan(plan),
+      m_source_frame(plan->get_plan()),
+      m_target_frame(plan->get_plan()) { }
+
+const core::EvaluationFrame& PolicyEvaluationFrames::evaluate_source(const core::State& source_state) {
+    if (!m_source_state || !(*m_source_state == source_state)) {
+        m_source_frame.evaluate(source_state);
+        m_source_state = source_state;
+    }
+    return m_source_frame;
+}
+
+const core::EvaluationFrame& PolicyEvaluationFrames::evaluate_target(const core::State& target_state) {
+    m_target_frame.evaluate(target_state);
+    return m_target_frame;
+}
+
+const std::shared_ptr<const PolicyEvaluationPlan>& PolicyEvaluationFrames::get_plan() const {
+    return m_plan;
+}
+
+}
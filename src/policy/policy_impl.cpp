@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <sstream>
+#include <stdexcept>
 
 
 namespace dlplan::policy {
@@ -212,6 +213,64 @@ std::shared_ptr<const Rule> Policy::evaluate_effects(const core::State& source_s
     return nullptr;
 }
 
+std::shared_ptr<const PolicyEvaluationPlan> Policy::compile_evaluation_plan() const {
+    return std::make_shared<const PolicyEvaluationPlan>(*this);
+}
+
+static const PolicyEvaluationPlan& get_evaluation_plan(const Policy& policy, const PolicyEvaluationFrames& frames) {
+    if (frames.get_plan()->get_policy_index() != policy.get_index()) {
+        throw std::runtime_error("Policy::evaluate - evaluation frames hold the plan of a different policy.");
+    }
+    return *frames.get_plan();
+}
+
+std::shared_ptr<const Rule> Policy::evaluate(const core::State& source_state, const core::State& target_state, PolicyEvaluationFrames& frames) const {
+    const auto& plan = get_evaluation_plan(*this, frames);
+    const auto& source_frame = frames.evaluate_source(source_state);
+    // The target state is only evaluated if the conditions of a rule hold.
+    const core::EvaluationFrame* target_frame = nullptr;
+    for (const auto& rule : plan.get_rules()) {
+        if (PolicyEvaluationPlan::evaluate_conditions(rule, source_frame)) {
+            if (!target_frame) target_frame = &frames.evaluate_target(target_state);
+            if (PolicyEvaluationPlan::evaluate_effects(rule, source_frame, *target_frame)) {
+                return rule.rule;
+            }
+        }
+    }
+    return nullptr;
+}
+
+std::vector<std::shared_ptr<const Rule>> Policy::evaluate_conditions(const core::State& source_state, PolicyEvaluationFrames& frames) const {
+    const auto& plan = get_evaluation_plan(*this, frames);
+    const auto& source_frame = frames.evaluate_source(source_state);
+    std::vector<std::shared_ptr<const Rule>> result;
+    for (const auto& rule : plan.get_rules()) {
+        if (PolicyEvaluationPlan::evaluate_conditions(rule, source_frame)) {
+            result.push_back(rule.rule);
+        }
+    }
+    return result;
+}
+
+std::shared_ptr<const Rule> Policy::evaluate_effects(const core::State& source_state, const core::State& target_state, const std::vector<std::shared_ptr<const Rule>>& rules, PolicyEvaluationFrames& frames) const {
+    const auto& plan = get_evaluation_plan(*this, frames);
+    if (rules.empty()) {
+        return nullptr;
+    }
+    const auto& source_frame = frames.evaluate_source(source_state);
+    const auto& target_frame = frames.evaluate_target(target_state);
+    for (const auto& r : rules) {
+        const auto* rule = plan.get_rule(*r);
+        if (!rule) {
+            throw std::runtime_error("Policy::evaluate_effects - rule " + r->str() + " is not in the policy.");
+        }
+        if (PolicyEvaluationPlan::evaluate_effects(*rule, source_frame, target_frame)) {
+            return r;
+        }
+    }
+    return nullptr;
+}
+
 void Policy::str_impl(std::stringstream& out) const {
     out << "(:policy\n";
     out << "(:booleans ";
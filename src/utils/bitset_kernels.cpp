@@ -0,0 +1,447 @@
+#include "../../include/dlplan/utils/bitset_kernels.h"
+
+#include <bit>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DLPLAN_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+
+namespace dlplan::kernels {
+
+/*
+  Portable kernels. The compiler is free to autovectorize these for the
+  baseline instruction set, std::popcount falls back to a bit-twiddling
+  implementation if the baseline does not include popcnt.
+*/
+namespace scalar {
+static void bitwise_and(Block* dst, const Block* src, std::size_t num_blocks) {
+    for (std::size_t i = 0; i < num_blocks; ++i) dst[i] &= src[i];
+}
+
+static void bitwise_or(Block* dst, const Block* src, std::size_t num_blocks) {
+    for (std::size_t i = 0; i < num_blocks; ++i) dst[i] |= src[i];
+}
+
+static void bitwise_and_not(Block* dst, const Block* src, std::size_t num_blocks) {
+    for (std::size_t i = 0; i < num_blocks; ++i) dst[i] &= ~src[i];
+}
+
+static void bitwise_not(Block* dst, std::size_t num_blocks) {
+    for (std::size_t i = 0; i < num_blocks; ++i) dst[i] = ~dst[i];
+}
+
+static bool intersects(const Block* left, const Block* right, std::size_t num_blocks) {
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        if (left[i] & right[i]) return true;
+    }
+    return false;
+}
+
+static bool is_subset_of(const Block* left, const Block* right, std::size_t num_blocks) {
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        if (left[i] & ~right[i]) return false;
+    }
+    return true;
+}
+
+static bool equal(const Block* left, const Block* right, std::size_t num_blocks) {
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        if (left[i] != right[i]) return false;
+    }
+    return true;
+}
+
+static bool none(const Block* data, std::size_t num_blocks) {
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        if (data[i]) return false;
+    }
+    return true;
+}
+
+static std::size_t count(const Block* data, std::size_t num_blocks) {
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < num_blocks; ++i) result += std::popcount(data[i]);
+    return result;
+}
+}
+
+
+#ifdef DLPLAN_X86_KERNELS
+/*
+  Scalar kernels with the hardware popcnt instruction.
+  Only count differs from the portable kernels.
+*/
+namespace popcnt {
+__attribute__((target("popcnt")))
+static std::size_t count(const Block* data, std::size_t num_blocks) {
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < num_blocks; ++i) result += _mm_popcnt_u64(data[i]);
+    return result;
+}
+}
+
+
+/*
+  AVX2 kernels process 4 blocks per iteration and handle the remainder with
+  scalar code.
+*/
+namespace avx2 {
+__attribute__((target("avx2")))
+static void bitwise_and(Block* dst, const Block* src, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 4 <= num_blocks; i += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_and_si256(a, b));
+    }
+    for (; i < num_blocks; ++i) dst[i] &= src[i];
+}
+
+__attribute__((target("avx2")))
+static void bitwise_or(Block* dst, const Block* src, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 4 <= num_blocks; i += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_or_si256(a, b));
+    }
+    for (; i < num_blocks; ++i) dst[i] |= src[i];
+}
+
+__attribute__((target("avx2")))
+static void bitwise_and_not(Block* dst, const Block* src, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 4 <= num_blocks; i += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        // andnot computes ~b & a
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_andnot_si256(b, a));
+    }
+    for (; i < num_blocks; ++i) dst[i] &= ~src[i];
+}
+
+__attribute__((target("avx2")))
+static void bitwise_not(Block* dst, std::size_t num_blocks) {
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    std::size_t i = 0;
+    for (; i + 4 <= num_blocks; i += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(a, ones));
+    }
+    for (; i < num_blocks; ++i) dst[i] = ~dst[i];
+}
+
+__attribute__((target("avx2")))
+static bool intersects(const Block* left, const Block* right, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 4 <= num_blocks; i += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(left + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(right + i));
+        // testz returns 1 iff a & b is zero
+        if (!_mm256_testz_si256(a, b)) return true;
+    }
+    for (; i < num_blocks; ++i) {
+        if (left[i] & right[i]) return true;
+    }
+    return false;
+}
+
+__attribute__((target("avx2")))
+static bool is_subset_of(const Block* left, const Block* right, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 4 <= num_blocks; i += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(left + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(right + i));
+        // testc returns 1 iff ~b & a is zero
+        if (!_mm256_testc_si256(b, a)) return false;
+    }
+    for (; i < num_blocks; ++i) {
+        if (left[i] & ~right[i]) return false;
+    }
+    return true;
+}
+
+__attribute__((target("avx2")))
+static bool equal(const Block* left, const Block* right, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 4 <= num_blocks; i += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(left + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(right + i));
+        __m256i diff = _mm256_xor_si256(a, b);
+        if (!_mm256_testz_si256(diff, diff)) return false;
+    }
+    for (; i < num_blocks; ++i) {
+        if (left[i] != right[i]) return false;
+    }
+    return true;
+}
+
+__attribute__((target("avx2")))
+static bool none(const Block* data, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 4 <= num_blocks; i += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        if (!_mm256_testz_si256(a, a)) return false;
+    }
+    for (; i < num_blocks; ++i) {
+        if (data[i]) return false;
+    }
+    return true;
+}
+
+/// Four independent accumulators hide the latency of popcnt.
+__attribute__((target("avx2,popcnt")))
+static std::size_t count(const Block* data, std::size_t num_blocks) {
+    std::size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= num_blocks; i += 4) {
+        c0 += _mm_popcnt_u64(data[i]);
+        c1 += _mm_popcnt_u64(data[i + 1]);
+        c2 += _mm_popcnt_u64(data[i + 2]);
+        c3 += _mm_popcnt_u64(data[i + 3]);
+    }
+    for (; i < num_blocks; ++i) c0 += _mm_popcnt_u64(data[i]);
+    return c0 + c1 + c2 + c3;
+}
+}
+
+
+/*
+  AVX-512 kernels process 8 blocks per iteration and handle the remainder
+  with scalar code. Masked loads and stores for the remainder turned out to be
+  slower than scalar code for the small denotations that we usually encounter.
+*/
+namespace avx512 {
+__attribute__((target("avx512f")))
+static void bitwise_and(Block* dst, const Block* src, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 8 <= num_blocks; i += 8) {
+        __m512i a = _mm512_loadu_si512(dst + i);
+        __m512i b = _mm512_loadu_si512(src + i);
+        _mm512_storeu_si512(dst + i, _mm512_and_si512(a, b));
+    }
+    for (; i < num_blocks; ++i) dst[i] &= src[i];
+}
+
+__attribute__((target("avx512f")))
+static void bitwise_or(Block* dst, const Block* src, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 8 <= num_blocks; i += 8) {
+        __m512i a = _mm512_loadu_si512(dst + i);
+        __m512i b = _mm512_loadu_si512(src + i);
+        _mm512_storeu_si512(dst + i, _mm512_or_si512(a, b));
+    }
+    for (; i < num_blocks; ++i) dst[i] |= src[i];
+}
+
+/// Computes a & ~b as (a & b) ^ a, which avoids a spurious GCC warning in andnot.
+__attribute__((target("avx512f")))
+static void bitwise_and_not(Block* dst, const Block* src, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 8 <= num_blocks; i += 8) {
+        __m512i a = _mm512_loadu_si512(dst + i);
+        __m512i b = _mm512_loadu_si512(src + i);
+        _mm512_storeu_si512(dst + i, _mm512_xor_si512(a, _mm512_and_si512(a, b)));
+    }
+    for (; i < num_blocks; ++i) dst[i] &= ~src[i];
+}
+
+__attribute__((target("avx512f")))
+static void bitwise_not(Block* dst, std::size_t num_blocks) {
+    const __m512i ones = _mm512_set1_epi64(-1);
+    std::size_t i = 0;
+    for (; i + 8 <= num_blocks; i += 8) {
+        __m512i a = _mm512_loadu_si512(dst + i);
+        _mm512_storeu_si512(dst + i, _mm512_xor_si512(a, ones));
+    }
+    for (; i < num_blocks; ++i) dst[i] = ~dst[i];
+}
+
+__attribute__((target("avx512f")))
+static bool intersects(const Block* left, const Block* right, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 8 <= num_blocks; i += 8) {
+        __m512i a = _mm512_loadu_si512(left + i);
+        __m512i b = _mm512_loadu_si512(right + i);
+        if (_mm512_test_epi64_mask(a, b)) return true;
+    }
+    for (; i < num_blocks; ++i) {
+        if (left[i] & right[i]) return true;
+    }
+    return false;
+}
+
+__attribute__((target("avx512f")))
+static bool is_subset_of(const Block* left, const Block* right, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 8 <= num_blocks; i += 8) {
+        __m512i a = _mm512_loadu_si512(left + i);
+        __m512i b = _mm512_loadu_si512(right + i);
+        if (_mm512_cmpneq_epi64_mask(_mm512_and_si512(a, b), a)) return false;
+    }
+    for (; i < num_blocks; ++i) {
+        if (left[i] & ~right[i]) return false;
+    }
+    return true;
+}
+
+__attribute__((target("avx512f")))
+static bool equal(const Block* left, const Block* right, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 8 <= num_blocks; i += 8) {
+        __m512i a = _mm512_loadu_si512(left + i);
+        __m512i b = _mm512_loadu_si512(right + i);
+        if (_mm512_cmpneq_epi64_mask(a, b)) return false;
+    }
+    for (; i < num_blocks; ++i) {
+        if (left[i] != right[i]) return false;
+    }
+    return true;
+}
+
+__attribute__((target("avx512f")))
+static bool none(const Block* data, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 8 <= num_blocks; i += 8) {
+        __m512i a = _mm512_loadu_si512(data + i);
+        if (_mm512_test_epi64_mask(a, a)) return false;
+    }
+    for (; i < num_blocks; ++i) {
+        if (data[i]) return false;
+    }
+    return true;
+}
+
+/// Requires AVX512_VPOPCNTDQ, otherwise the AVX2 count is used.
+__attribute__((target("avx512f,avx512vpopcntdq,popcnt")))
+static std::size_t count(const Block* data, std::size_t num_blocks) {
+    __m512i acc = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 8 <= num_blocks; i += 8) {
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_loadu_si512(data + i)));
+    }
+    alignas(64) std::uint64_t lanes[8];
+    _mm512_store_si512(lanes, acc);
+    std::size_t result = lanes[0] + lanes[1] + lanes[2] + lanes[3] + lanes[4] + lanes[5] + lanes[6] + lanes[7];
+    for (; i < num_blocks; ++i) result += _mm_popcnt_u64(data[i]);
+    return result;
+}
+}
+#endif
+
+
+static const BitsetKernels scalar_kernels = {
+    KernelVariant::SCALAR,
+    scalar::bitwise_and,
+    scalar::bitwise_or,
+    scalar::bitwise_and_not,
+    scalar::bitwise_not,
+    scalar::intersects,
+    scalar::is_subset_of,
+    scalar::equal,
+    scalar::none,
+    scalar::count
+};
+
+#ifdef DLPLAN_X86_KERNELS
+static const BitsetKernels popcnt_kernels = {
+    KernelVariant::POPCNT,
+    scalar::bitwise_and,
+    scalar::bitwise_or,
+    scalar::bitwise_and_not,
+    scalar::bitwise_not,
+    scalar::intersects,
+    scalar::is_subset_of,
+    scalar::equal,
+    scalar::none,
+    popcnt::count
+};
+
+static const BitsetKernels avx2_kernels = {
+    KernelVariant::AVX2,
+    avx2::bitwise_and,
+    avx2::bitwise_or,
+    avx2::bitwise_and_not,
+    avx2::bitwise_not,
+    avx2::intersects,
+    avx2::is_subset_of,
+    avx2::equal,
+    avx2::none,
+    avx2::count
+};
+
+static BitsetKernels make_avx512_kernels() {
+    return BitsetKernels{
+        KernelVariant::AVX512,
+        avx512::bitwise_and,
+        avx512::bitwise_or,
+        avx512::bitwise_and_not,
+        avx512::bitwise_not,
+        avx512::intersects,
+        avx512::is_subset_of,
+        avx512::equal,
+        avx512::none,
+        __builtin_cpu_supports("avx512vpopcntdq") ? avx512::count : avx2::count
+    };
+}
+#endif
+
+
+const BitsetKernels* get_kernels(KernelVariant variant) {
+    switch (variant) {
+        case KernelVariant::SCALAR: {
+            return &scalar_kernels;
+        }
+#ifdef DLPLAN_X86_KERNELS
+        case KernelVariant::POPCNT: {
+            return __builtin_cpu_supports("popcnt") ? &popcnt_kernels : nullptr;
+        }
+        case KernelVariant::AVX2: {
+            return (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) ? &avx2_kernels : nullptr;
+        }
+        case KernelVariant::AVX512: {
+            if (!__builtin_cpu_supports("avx512f")) {
+                return nullptr;
+            }
+            static const BitsetKernels avx512_kernels = make_avx512_kernels();
+            return &avx512_kernels;
+        }
+#endif
+        default: {
+            return nullptr;
+        }
+    }
+}
+
+const BitsetKernels& get_kernels() {
+    static const BitsetKernels& kernels = []() -> const BitsetKernels& {
+        auto variants = get_supported_variants();
+        return *get_kernels(variants.back());
+    }();
+    return kernels;
+}
+
+std::vector<KernelVariant> get_supported_variants() {
+    std::vector<KernelVariant> result;
+    for (auto variant : {KernelVariant::SCALAR, KernelVariant::POPCNT, KernelVariant::AVX2, KernelVariant::AVX512}) {
+        if (get_kernels(variant)) {
+            result.push_back(variant);
+        }
+    }
+    return result;
+}
+
+std::string to_string(KernelVariant variant) {
+    switch (variant) {
+        case KernelVariant::SCALAR: return "scalar";
+        case KernelVariant::POPCNT: return "popcnt";
+        case KernelVariant::AVX2: return "avx2";
+        case KernelVariant::AVX512: return "avx512";
+    }
+    throw std::runtime_error("to_string - unknown kernel variant.");
+}
+
+}
@@ -0,0 +1,30 @@
+#ifndef DLPLAN_SRC_UTILS_FINGERPRINT_H
+#define DLPLAN_SRC_UTILS_FINGERPRINT_H
+
+#include "MurmurHash3.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace dlplan::utils {
+
+/// @brief A 128-bit hash that identifies data up to negligible collisions.
+using Fingerprint = std::array<std::uint64_t, 2>;
+
+struct FingerprintHash {
+    std::size_t operator()(const Fingerprint& fingerprint) const {
+        return fingerprint[0];
+    }
+};
+
+inline Fingerprint compute_fingerprint(const void* data, std::size_t num_bytes) {
+    Fingerprint result;
+    MurmurHash3_x64_128(data, static_cast<int>(num_bytes), static_cast<std::uint32_t>(num_bytes), result.data());
+    return result;
+}
+
+}
+
+#endif
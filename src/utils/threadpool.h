@@ -25,9 +25,9 @@
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
+#include <exception>
 #include <functional>
 #include <future>
-#include <iostream>
 #include <memory>
 #include <mutex>
 #include <queue>
@@ -273,7 +273,6 @@ public:
             destroy();
             throw;
         }
-        std::cout << "Constructed thread pool with " << m_threads.size() << " thread." << std::endl;
     }
 
     /**
@@ -302,8 +301,7 @@ public:
     auto submit(Func&& func, Args&&... args)
     {
         auto boundTask = std::bind(std::forward<Func>(func), std::forward<Args>(args)...);
-        //using ResultType = std::result_of_t<decltype(func)()>;
-        using ResultType = typename std::result_of<Func(Args...)>::type;
+        using ResultType = std::invoke_result_t<Func, Args...>;
         using PackagedTask = std::packaged_task<ResultType()>;
         using TaskType = ThreadTask<PackagedTask>;
 
@@ -313,6 +311,26 @@ public:
         return result;
     }
 
+    /**
+     * Submit a job to be run by the thread pool without waiting for it.
+     * Unlike submit, no future is returned that blocks on destruction,
+     * hence the job must own the state that it accesses.
+     */
+    template <typename Func>
+    void post(Func&& func)
+    {
+        using TaskType = ThreadTask<std::decay_t<Func>>;
+        m_workQueue.push(std::make_unique<TaskType>(std::decay_t<Func>(std::forward<Func>(func))));
+    }
+
+    /**
+     * Returns the number of worker threads.
+     */
+    std::size_t get_num_threads(void) const
+    {
+        return m_threads.size();
+    }
+
     const ThreadSafeQueue<std::unique_ptr<IThreadTask>>& get_queue() const {
         return m_workQueue;
     }
@@ -377,6 +395,86 @@ namespace DefaultThreadPool
     }
 }
 
+/**
+ * The ranges of a parallel_for that threads claim in order. Workers share
+ * ownership, because they might only start after the parallel_for returned.
+ */
+struct ParallelForRanges
+{
+    const std::function<void(std::size_t, std::size_t)>* body;
+    std::size_t num_items;
+    std::size_t range_size;
+    std::size_t num_ranges;
+    std::atomic<std::size_t> next_range{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::size_t num_finished_ranges = 0;
+    std::exception_ptr exception;
+
+    /**
+     * Process ranges until none is left.
+     */
+    void process(void)
+    {
+        for (std::size_t range = next_range++; range < num_ranges; range = next_range++)
+        {
+            std::exception_ptr range_exception;
+            try
+            {
+                std::size_t begin = range * range_size;
+                (*body)(begin, std::min(begin + range_size, num_items));
+            }
+            catch (...)
+            {
+                range_exception = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (range_exception && !exception)
+            {
+                exception = range_exception;
+            }
+            if (++num_finished_ranges == num_ranges)
+            {
+                finished.notify_all();
+            }
+        }
+    }
+};
+
+/**
+ * Call body(begin, end) on consecutive ranges of the given size that partition
+ * [0, num_items). The calling thread and up to num_threads - 1 workers of the
+ * default thread pool claim the ranges in order, hence the load is balanced
+ * dynamically. Since the calling thread also processes ranges, nested calls
+ * finish even if all workers are busy. The first exception thrown by the body
+ * is rethrown after all ranges finished.
+ */
+inline void parallel_for(std::size_t num_items, std::size_t range_size, int num_threads, const std::function<void(std::size_t, std::size_t)>& body)
+{
+    if (num_items == 0)
+    {
+        return;
+    }
+    auto ranges = std::make_shared<ParallelForRanges>();
+    ranges->body = &body;
+    ranges->num_items = num_items;
+    ranges->range_size = std::max<std::size_t>(1, range_size);
+    ranges->num_ranges = (num_items + ranges->range_size - 1) / ranges->range_size;
+    auto& pool = DefaultThreadPool::getThreadPool();
+    std::size_t num_workers = std::min({static_cast<std::size_t>(std::max(num_threads, 1) - 1), pool.get_num_threads(), ranges->num_ranges - 1});
+    for (std::size_t i = 0; i < num_workers; ++i)
+    {
+        pool.post([ranges]() { ranges->process(); });
+    }
+    ranges->process();
+    std::unique_lock<std::mutex> lock(ranges->mutex);
+    ranges->finished.wait(lock, [&]() { return ranges->num_finished_ranges == ranges->num_ranges; });
+    if (ranges->exception)
+    {
+        std::rethrow_exception(ranges->exception);
+    }
+}
+
 }
 
 #endif
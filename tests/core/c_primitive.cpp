@@ -30,4 +30,48 @@ TEST(DLPTests, ConceptPrimitive) {
     EXPECT_EQ(concept3->evaluate(state_0), create_concept_denotation(*instance, {"C", "F"}));
 }
 
+TEST(DLPTests, ConceptPrimitiveStaticAtoms) {
+    auto vocabulary = std::make_shared<VocabularyInfo>();
+    auto predicate_0 = vocabulary->add_predicate("other", 1);
+    auto predicate_1 = vocabulary->add_predicate("predicate", 2);
+    auto instance = std::make_shared<InstanceInfo>(0, vocabulary);
+    auto atom_0 = instance->add_atom("other", {"A"});
+    auto atom_1 = instance->add_atom("predicate", {"A", "B"});
+    auto atom_2 = instance->add_atom("predicate", {"C", "D"});
+    instance->add_static_atom("predicate", {"E", "F"});
+    EXPECT_EQ(instance->get_atom_indices_of_predicate(predicate_1.get_index()), AtomIndices({atom_1.get_index(), atom_2.get_index()}));
+    EXPECT_EQ(instance->get_static_atom_indices_of_predicate(predicate_1.get_index()), AtomIndices({0}));
+    EXPECT_TRUE(instance->get_static_atom_indices_of_predicate(predicate_0.get_index()).empty());
+
+    State state_0(0, instance, {atom_2, atom_0});
+    State state_1(1, instance, {atom_1, atom_2});
+    auto atom_indices = state_0.get_atom_indices_of_predicate(predicate_1.get_index());
+    EXPECT_EQ(AtomIndices(atom_indices.begin(), atom_indices.end()), AtomIndices({atom_2.get_index()}));
+
+    SyntacticElementFactory factory(vocabulary);
+    DenotationsCaches caches;
+
+    // The static atoms contribute to the denotations on all states.
+    auto concept_0 = factory.parse_concept("c_primitive(predicate,0)");
+    EXPECT_EQ(concept_0->evaluate(state_0), create_concept_denotation(*instance, {"C", "E"}));
+    EXPECT_EQ(concept_0->evaluate(state_1), create_concept_denotation(*instance, {"A", "C", "E"}));
+    EXPECT_EQ(*concept_0->evaluate(state_0, caches), concept_0->evaluate(state_0));
+    EXPECT_EQ(*concept_0->evaluate(state_1, caches), concept_0->evaluate(state_1));
+    auto denotations = concept_0->evaluate(States{state_0, state_1}, caches);
+    EXPECT_EQ(denotations->get_denotation(0), concept_0->evaluate(state_0));
+    EXPECT_EQ(denotations->get_denotation(1), concept_0->evaluate(state_1));
+
+    // The contribution of the static atoms does not collide with the
+    // denotation on a state of index -1, in either order of evaluation.
+    State state_2(-1, instance, {atom_1});
+    for (bool state_first : {false, true}) {
+        DenotationsCaches caches_2;
+        if (state_first) {
+            EXPECT_EQ(*concept_0->evaluate(state_2, caches_2), create_concept_denotation(*instance, {"A", "E"}));
+        }
+        EXPECT_EQ(*concept_0->evaluate(state_0, caches_2), concept_0->evaluate(state_0));
+        EXPECT_EQ(*concept_0->evaluate(state_2, caches_2), create_concept_denotation(*instance, {"A", "E"}));
+    }
+}
+
 }
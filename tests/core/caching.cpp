@@ -4,6 +4,8 @@
 
 #include "../../include/dlplan/core.h"
 
+#include <thread>
+
 using namespace dlplan::core;
 
 namespace dlplan::tests::core
@@ -28,10 +30,10 @@ namespace dlplan::tests::core
         EXPECT_EQ(concept_0->evaluate(state_1), create_concept_denotation(*instance, {"A"}));
         EXPECT_EQ(concept_0->evaluate(state_1), *concept_0->evaluate(state_1, caches));
         EXPECT_EQ(concept_0->evaluate(state_1, caches), concept_0->evaluate(state_1, caches));
-        EXPECT_EQ(
-            ConceptDenotations({concept_0->evaluate(state_0,caches), concept_0->evaluate(state_1,caches)}),
-            *concept_0->evaluate(States{state_0, state_1}, caches)
-        );
+        auto concept_denotations = concept_0->evaluate(States{state_0, state_1}, caches);
+        EXPECT_EQ(concept_denotations->get_denotation(0), *concept_0->evaluate(state_0, caches));
+        EXPECT_EQ(concept_denotations->get_denotation(1), *concept_0->evaluate(state_1, caches));
+        EXPECT_EQ(concept_denotations, concept_0->evaluate(States{state_0, state_1}, caches));
 
         auto role_0 = factory.parse_role("r_primitive(role, 0, 1)");
         EXPECT_EQ(role_0->evaluate(state_0), create_role_denotation(*instance, {}));
@@ -40,10 +42,10 @@ namespace dlplan::tests::core
         EXPECT_EQ(role_0->evaluate(state_1), create_role_denotation(*instance, {{"A", "B"}}));
         EXPECT_EQ(role_0->evaluate(state_1), *role_0->evaluate(state_1, caches));
         EXPECT_EQ(role_0->evaluate(state_1, caches), role_0->evaluate(state_1, caches));
-        EXPECT_EQ(
-            RoleDenotations({role_0->evaluate(state_0,caches), role_0->evaluate(state_1,caches)}),
-            *role_0->evaluate(States{state_0, state_1}, caches)
-        );
+        auto role_denotations = role_0->evaluate(States{state_0, state_1}, caches);
+        EXPECT_EQ(role_denotations->get_denotation(0), *role_0->evaluate(state_0, caches));
+        EXPECT_EQ(role_denotations->get_denotation(1), *role_0->evaluate(state_1, caches));
+        EXPECT_EQ(role_denotations, role_0->evaluate(States{state_0, state_1}, caches));
 
         auto numerical_0 = factory.parse_numerical("n_count(c_primitive(role, 0))");
         EXPECT_EQ(numerical_0->evaluate(state_0), 0);
@@ -67,4 +69,193 @@ namespace dlplan::tests::core
         );
         EXPECT_EQ(boolean_0->evaluate(States{state_0, state_1}, caches), boolean_0->evaluate(States{state_0, state_1}, caches));
     }
+
+    TEST(DLPTests, CachingHandles)
+    {
+        SharedObjectCache<DenotationsCacheKey, ConceptDenotation> cache;
+        // enough objects to span several arena chunks and table resizes
+        std::vector<ObjectHandle> handles;
+        for (int i = 0; i < 1000; ++i) {
+            ConceptDenotation denotation(1000);
+            denotation.insert(i);
+            handles.push_back(cache.insert(std::move(denotation)));
+            EXPECT_EQ(handles.back(), static_cast<ObjectHandle>(i));
+        }
+        const ConceptDenotation& first = cache.get_object<ConceptDenotation>(handles[0]);
+        for (int i = 0; i < 1000; ++i) {
+            ConceptDenotation denotation(1000);
+            denotation.insert(i);
+            EXPECT_EQ(cache.insert(std::move(denotation)), handles[i]);
+            cache.insert_mapping<ConceptDenotation>(DenotationsCacheKey{ i, 0, i }, handles[i]);
+        }
+        EXPECT_EQ(cache.size<ConceptDenotation>(), 1000u);
+        // references remain valid when the arena grows
+        EXPECT_EQ(&first, &cache.get_object<ConceptDenotation>(handles[0]));
+        EXPECT_TRUE(first.contains(0));
+        for (int i = 0; i < 1000; ++i) {
+            EXPECT_EQ(cache.get_handle<ConceptDenotation>(DenotationsCacheKey{ i, 0, i }), handles[i]);
+            EXPECT_TRUE(cache.get<ConceptDenotation>(DenotationsCacheKey{ i, 0, i })->contains(i));
+        }
+        EXPECT_EQ(cache.get_handle<ConceptDenotation>(DenotationsCacheKey{ 0, 1, 0 }), UNDEFINED_HANDLE);
+        EXPECT_EQ(cache.get<ConceptDenotation>(DenotationsCacheKey{ 0, 1, 0 }), nullptr);
+    }
+
+    TEST(DLPTests, CachingThreadSafe)
+    {
+        auto vocabulary = std::make_shared<VocabularyInfo>();
+        vocabulary->add_predicate("conn", 2);
+        vocabulary->add_predicate("at", 1);
+        auto instance = std::make_shared<InstanceInfo>(0, vocabulary);
+        std::vector<Atom> conn_atoms;
+        for (int i = 0; i + 1 < 20; ++i) {
+            conn_atoms.push_back(instance->add_atom("conn", {std::to_string(i), std::to_string(i + 1)}));
+        }
+        States states;
+        for (int i = 0; i < 20; ++i) {
+            std::vector<Atom> atoms = conn_atoms;
+            atoms.push_back(instance->add_atom("at", {std::to_string(i)}));
+            states.emplace_back(i, instance, atoms);
+        }
+        SyntacticElementFactory factory(vocabulary);
+        std::vector<std::shared_ptr<const Concept>> concepts = {
+            factory.parse_concept("c_primitive(at,0)"),
+            factory.parse_concept("c_some(r_primitive(conn,0,1),c_primitive(at,0))"),
+            factory.parse_concept("c_some(r_transitive_closure(r_primitive(conn,0,1)),c_primitive(at,0))"),
+            factory.parse_concept("c_not(c_primitive(at,0))"),
+        };
+
+        DenotationsCaches caches(true);
+        const int num_threads = 4;
+        std::vector<std::vector<std::shared_ptr<const ConceptDenotation>>> results(num_threads);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&, t]() {
+                for (const auto& state : states) {
+                    for (const auto& element : concepts) {
+                        results[t].push_back(element->evaluate(state, caches));
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (int t = 0; t < num_threads; ++t) {
+            // all threads obtain the same cached denotations
+            EXPECT_EQ(results[t], results[0]);
+        }
+        int i = 0;
+        for (const auto& state : states) {
+            for (const auto& element : concepts) {
+                EXPECT_EQ(*results[0][i++], element->evaluate(state));
+            }
+        }
+    }
+
+    TEST(DLPTests, CachingMemoryBudget)
+    {
+        auto vocabulary = std::make_shared<VocabularyInfo>();
+        vocabulary->add_predicate("conn", 2, true);
+        vocabulary->add_predicate("at", 1);
+        auto instance = std::make_shared<InstanceInfo>(0, vocabulary);
+        for (int i = 0; i + 1 < 20; ++i) {
+            instance->add_static_atom("conn", {std::to_string(i), std::to_string(i + 1)});
+        }
+        States states;
+        for (int i = 0; i < 400; ++i) {
+            states.emplace_back(i, instance, std::vector<Atom>{
+                instance->add_atom("at", {std::to_string(i % 20)}),
+                instance->add_atom("at", {std::to_string((i / 20) % 20)})});
+        }
+        SyntacticElementFactory factory(vocabulary);
+        auto static_concept = factory.parse_concept("c_some(r_primitive(conn,0,1),c_top)");
+        auto numerical = factory.parse_numerical("n_concept_distance(c_primitive(at,0),r_primitive(conn,0,1),c_some(r_primitive(conn,0,1),c_primitive(at,0)))");
+
+        DenotationsCaches caches;
+        caches.set_memory_budget(16 * 1024);
+        auto static_denotation = static_concept->evaluate(states[0], caches);
+        std::size_t max_num_bytes = 0;
+        for (const auto& state : states) {
+            EXPECT_EQ(numerical->evaluate(state, caches), numerical->evaluate(state));
+            max_num_bytes = std::max(max_num_bytes, caches.get_num_bytes());
+        }
+        // eviction happens before an evaluation, which adds few bytes
+        EXPECT_LE(max_num_bytes, 16 * 1024u + 1024);
+        EXPECT_GT(caches.get_num_evictions(), 0u);
+        EXPECT_GT(caches.get_num_evicted_entries(), 0u);
+        EXPECT_GT(caches.get_num_bytes(), 0u);
+        // static denotations are pinned and shared pointers outlive eviction
+        EXPECT_NE(caches.data.get<ConceptDenotation>(DenotationsCacheKey{ static_concept->get_index(), instance->get_index(), -1 }), nullptr);
+        EXPECT_EQ(*static_denotation, static_concept->evaluate(states[0]));
+        EXPECT_EQ(*static_concept->evaluate(states[1], caches), *static_denotation);
+
+        // Denotations on all states are pinned and exceed the budget, hence
+        // only the denotations of single states are bounded by the budget.
+        DenotationsCaches pinned_caches;
+        pinned_caches.set_memory_budget(4 * 1024);
+        numerical->evaluate(states, pinned_caches);
+        std::size_t num_pinned_bytes = pinned_caches.get_num_bytes();
+        EXPECT_GT(num_pinned_bytes, 4 * 1024u);
+        max_num_bytes = 0;
+        for (const auto& state : states) {
+            EXPECT_EQ(numerical->evaluate(state, pinned_caches), numerical->evaluate(state));
+            max_num_bytes = std::max(max_num_bytes, pinned_caches.get_num_bytes());
+        }
+        EXPECT_LE(max_num_bytes, num_pinned_bytes + 4 * 1024 + 1024);
+        EXPECT_GT(pinned_caches.get_num_evictions(), 1u);
+
+        // Denotations on all states can be evicted as well, which are then
+        // recomputed from those of the children.
+        DenotationsCaches collection_caches;
+        collection_caches.set_memory_budget(1024, true);
+        auto concept_ = factory.parse_concept("c_and(c_primitive(at,0),c_some(r_primitive(conn,0,1),c_primitive(at,0)))");
+        auto denotations = concept_->evaluate(states, collection_caches);
+        numerical->evaluate(states, collection_caches);
+        EXPECT_GT(collection_caches.get_num_evictions(), 0u);
+        EXPECT_EQ(collection_caches.data.get<ConceptDenotations>(DenotationsCacheKey{ concept_->get_index(), -1, -1 }), nullptr);
+        EXPECT_EQ(*concept_->evaluate(states, collection_caches), *denotations);
+
+        DenotationsCaches thread_safe_caches(true);
+        EXPECT_THROW(thread_safe_caches.set_memory_budget(1024), std::runtime_error);
+    }
+
+    TEST(DLPTests, CachingElementStatistics)
+    {
+        auto vocabulary = std::make_shared<VocabularyInfo>();
+        auto predicate_0 = vocabulary->add_predicate("role", 2);
+        auto instance = std::make_shared<InstanceInfo>(0, vocabulary);
+        auto atom_0 = instance->add_atom("role", {"A", "B"});
+
+        State state_0(0, instance, std::vector<Atom>{});
+        State state_1(1, instance, {atom_0});
+
+        SyntacticElementFactory factory(vocabulary);
+        DenotationsCaches caches;
+        auto role_0 = factory.parse_role("r_primitive(role, 0, 1)");
+        auto numerical_0 = factory.parse_numerical("n_count(r_primitive(role, 0, 1))");
+        numerical_0->evaluate(state_0, caches);
+        numerical_0->evaluate(state_1, caches);
+        numerical_0->evaluate(state_1, caches);
+        role_0->evaluate(state_1, caches);
+
+        auto statistics = caches.get_element_statistics();
+        if (!DenotationsCaches::is_instrumentation_enabled()) {
+            EXPECT_TRUE(statistics.empty());
+            return;
+        }
+        ASSERT_EQ(statistics.size(), 2u);
+        const auto& numerical_statistics = statistics.at(numerical_0->get_index());
+        EXPECT_EQ(numerical_statistics.num_misses, 2u);
+        EXPECT_EQ(numerical_statistics.num_hits, 1u);
+        EXPECT_EQ(numerical_statistics.num_bytes, 2 * sizeof(int));
+        const auto& role_statistics = statistics.at(role_0->get_index());
+        EXPECT_EQ(role_statistics.num_misses, 2u);
+        EXPECT_EQ(role_statistics.num_hits, 1u);
+        EXPECT_GE(role_statistics.num_bytes, 2 * sizeof(RoleDenotation));
+        // The time of the numerical includes the evaluation of the role.
+        EXPECT_GE(numerical_statistics.evaluate_time, role_statistics.evaluate_time);
+
+        caches.clear_element_statistics();
+        EXPECT_TRUE(caches.get_element_statistics().empty());
+    }
 }
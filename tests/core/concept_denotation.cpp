@@ -15,4 +15,21 @@ TEST(DLPTests, ConceptDenotationComputeRepr) {
     EXPECT_EQ(denotation.str(), "ConceptDenotation(num_objects=4, object_indices=[0, 2])");
 }
 
+TEST(DLPTests, ConceptDenotationIterate) {
+    // spans multiple 64-bit blocks
+    int num_objects = 130;
+    ConceptDenotation denotation(num_objects);
+    EXPECT_EQ(denotation.begin(), denotation.end());
+    denotation.insert(129);
+    denotation.insert(0);
+    denotation.insert(64);
+    denotation.insert(63);
+    ObjectIndices result;
+    for (ObjectIndex object : denotation) {
+        result.push_back(object);
+    }
+    EXPECT_EQ(result, ObjectIndices({0, 63, 64, 129}));
+    EXPECT_EQ(denotation.to_sorted_vector(), result);
+}
+
 }
@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include "../../include/dlplan/core.h"
+
+#include <string>
+
+using namespace dlplan::core;
+
+
+namespace dlplan::tests::core {
+
+/// @brief Returns states of two instances whose denotations span one and
+///        respectively two blocks per row.
+static States create_states(std::shared_ptr<VocabularyInfo> vocabulary) {
+    States states;
+    for (int num_objects : {5, 70}) {
+        auto instance = std::make_shared<InstanceInfo>(num_objects, vocabulary);
+        for (int i = 0; i + 1 < num_objects; ++i) {
+            instance->add_static_atom("conn", {std::to_string(i), std::to_string(i + 1)});
+        }
+        for (int k = 0; k < 3; ++k) {
+            std::vector<Atom> atoms = {
+                instance->add_atom("at", {std::to_string(k), std::to_string((k + 2) % num_objects)}),
+                instance->add_atom("at", {std::to_string(num_objects - 1 - k), std::to_string(k)}),
+                instance->add_atom("goal", {std::to_string((3 * k + 1) % num_objects)})};
+            states.emplace_back(states.size(), instance, std::move(atoms));
+        }
+    }
+    return states;
+}
+
+TEST(DLPTests, DenotationMatrixBatchEvaluation) {
+    auto vocabulary = std::make_shared<VocabularyInfo>();
+    vocabulary->add_predicate("conn", 2);
+    vocabulary->add_predicate("at", 2);
+    vocabulary->add_predicate("goal", 1);
+    auto states = create_states(vocabulary);
+    SyntacticElementFactory factory(vocabulary);
+
+    std::vector<std::string> concept_reprs = {
+        "c_primitive(goal,0)", "c_top", "c_bot",
+        "c_and(c_primitive(at,0),c_primitive(goal,0))",
+        "c_or(c_primitive(at,1),c_primitive(goal,0))",
+        "c_diff(c_primitive(at,0),c_primitive(goal,0))",
+        "c_not(c_primitive(goal,0))",
+        "c_some(r_primitive(conn,0,1),c_primitive(goal,0))",
+        "c_all(r_primitive(at,0,1),c_primitive(goal,0))",
+        "c_equal(r_primitive(at,0,1),r_primitive(conn,0,1))",
+        "c_subset(r_primitive(at,0,1),r_primitive(conn,0,1))",
+        "c_projection(r_primitive(at,0,1),1)",
+    };
+    std::vector<std::string> role_reprs = {
+        "r_primitive(at,0,1)", "r_top",
+        "r_and(r_primitive(at,0,1),r_primitive(conn,0,1))",
+        "r_or(r_primitive(at,0,1),r_primitive(conn,0,1))",
+        "r_diff(r_primitive(conn,0,1),r_primitive(at,0,1))",
+        "r_not(r_primitive(at,0,1))",
+        "r_compose(r_primitive(at,0,1),r_primitive(conn,0,1))",
+        "r_inverse(r_primitive(at,0,1))",
+        "r_restrict(r_primitive(conn,0,1),c_primitive(goal,0))",
+        "r_identity(c_primitive(goal,0))",
+        "r_transitive_closure(r_primitive(at,0,1))",
+        "r_transitive_reflexive_closure(r_primitive(at,0,1))",
+        "r_til_c(r_primitive(conn,0,1),c_primitive(goal,0))",
+    };
+    std::vector<std::string> numerical_reprs = {
+        "n_count(c_primitive(at,0))",
+        "n_count(r_primitive(at,0,1))",
+        "n_concept_distance(c_primitive(at,0),r_primitive(conn,0,1),c_primitive(goal,0))",
+        "n_role_distance(r_primitive(at,0,1),r_primitive(conn,0,1),r_primitive(at,0,1))",
+        "n_sum_concept_distance(c_primitive(at,0),r_primitive(conn,0,1),c_primitive(goal,0))",
+        "n_sum_role_distance(r_primitive(at,0,1),r_primitive(conn,0,1),r_primitive(at,0,1))",
+    };
+    std::vector<std::string> boolean_reprs = {
+        "b_empty(c_primitive(goal,0))",
+        "b_empty(r_and(r_primitive(at,0,1),r_primitive(conn,0,1)))",
+        "b_inclusion(c_primitive(goal,0),c_primitive(at,0))",
+        "b_inclusion(r_primitive(at,0,1),r_primitive(conn,0,1))",
+    };
+
+    DenotationsCaches caches;
+    for (const auto& repr : concept_reprs) {
+        auto element = factory.parse_concept(repr);
+        auto denotations = element->evaluate(states, caches);
+        ASSERT_EQ(denotations->size(), states.size());
+        for (size_t i = 0; i < states.size(); ++i) {
+            EXPECT_EQ(denotations->get_denotation(i), element->evaluate(states[i])) << repr;
+            EXPECT_EQ(denotations->count(i), element->evaluate(states[i]).size()) << repr;
+        }
+    }
+    for (const auto& repr : role_reprs) {
+        auto element = factory.parse_role(repr);
+        auto denotations = element->evaluate(states, caches);
+        ASSERT_EQ(denotations->size(), states.size());
+        for (size_t i = 0; i < states.size(); ++i) {
+            EXPECT_EQ(denotations->get_denotation(i), element->evaluate(states[i])) << repr;
+        }
+    }
+    for (const auto& repr : numerical_reprs) {
+        auto element = factory.parse_numerical(repr);
+        auto denotations = element->evaluate(states, caches);
+        for (size_t i = 0; i < states.size(); ++i) {
+            EXPECT_EQ((*denotations)[i], element->evaluate(states[i])) << repr;
+        }
+    }
+    for (const auto& repr : boolean_reprs) {
+        auto element = factory.parse_boolean(repr);
+        auto denotations = element->evaluate(states, caches);
+        for (size_t i = 0; i < states.size(); ++i) {
+            EXPECT_EQ((*denotations)[i], element->evaluate(states[i])) << repr;
+        }
+    }
+}
+
+TEST(DLPTests, DenotationMatrixParallelEvaluation) {
+    auto vocabulary = std::make_shared<VocabularyInfo>();
+    vocabulary->add_predicate("conn", 2);
+    vocabulary->add_predicate("at", 2);
+    vocabulary->add_predicate("goal", 1);
+    auto states = create_states(vocabulary);
+    SyntacticElementFactory factory(vocabulary);
+
+    DenotationsCaches sequential_caches;
+    EXPECT_THROW(sequential_caches.set_num_threads(4), std::runtime_error);
+    DenotationsCaches parallel_caches(true);
+    parallel_caches.set_num_threads(4);
+    EXPECT_THROW(parallel_caches.set_num_threads(0), std::runtime_error);
+
+    for (const auto& repr : {
+        "c_primitive(goal,0)",
+        "c_some(r_primitive(conn,0,1),c_primitive(goal,0))",
+        "c_all(r_primitive(at,0,1),c_primitive(goal,0))",
+        "c_equal(r_primitive(at,0,1),r_primitive(conn,0,1))",
+        "c_projection(r_primitive(at,0,1),1)"}) {
+        auto element = factory.parse_concept(repr);
+        EXPECT_EQ(*element->evaluate(states, parallel_caches), *element->evaluate(states, sequential_caches)) << repr;
+    }
+    for (const auto& repr : {
+        "r_compose(r_primitive(at,0,1),r_primitive(conn,0,1))",
+        "r_restrict(r_primitive(conn,0,1),c_primitive(goal,0))",
+        "r_transitive_reflexive_closure(r_primitive(at,0,1))",
+        "r_til_c(r_primitive(conn,0,1),c_primitive(goal,0))"}) {
+        auto element = factory.parse_role(repr);
+        EXPECT_EQ(*element->evaluate(states, parallel_caches), *element->evaluate(states, sequential_caches)) << repr;
+    }
+    for (const auto& repr : {
+        "n_concept_distance(c_primitive(at,0),r_primitive(conn,0,1),c_primitive(goal,0))",
+        "n_role_distance(r_primitive(at,0,1),r_primitive(conn,0,1),r_primitive(at,0,1))",
+        "n_sum_role_distance(r_primitive(at,0,1),r_primitive(conn,0,1),r_primitive(at,0,1))"}) {
+        auto element = factory.parse_numerical(repr);
+        EXPECT_EQ(*element->evaluate(states, parallel_caches), *element->evaluate(states, sequential_caches)) << repr;
+    }
+}
+
+TEST(DLPTests, DenotationMatrixDeduplication) {
+    auto vocabulary = std::make_shared<VocabularyInfo>();
+    vocabulary->add_predicate("conn", 2);
+    vocabulary->add_predicate("at", 2);
+    vocabulary->add_predicate("goal", 1);
+    auto states = create_states(vocabulary);
+    SyntacticElementFactory factory(vocabulary);
+
+    DenotationsCaches caches;
+    // Syntactically different but semantically equivalent concepts share the same matrix.
+    auto concept_1 = factory.parse_concept("c_and(c_primitive(goal,0),c_top)");
+    auto concept_2 = factory.parse_concept("c_or(c_primitive(goal,0),c_bot)");
+    auto concept_3 = factory.parse_concept("c_not(c_primitive(goal,0))");
+    EXPECT_EQ(concept_1->evaluate(states, caches), concept_2->evaluate(states, caches));
+    EXPECT_NE(*concept_1->evaluate(states, caches), *concept_3->evaluate(states, caches));
+
+    ConceptDenotations denotations(states);
+    ConceptDenotation denotation(0);
+    for (size_t i = 0; i < states.size(); ++i) {
+        EXPECT_TRUE(denotations.empty(i));
+        denotations.reset_denotation(i, denotation);
+        EXPECT_EQ(denotation.get_num_objects(), static_cast<int>(states[i].get_instance_info()->get_objects().size()));
+        denotation.insert(i % denotation.get_num_objects());
+        denotations.store_row(i, denotation);
+    }
+    ConceptDenotations copy(denotations);
+    EXPECT_EQ(copy, denotations);
+    EXPECT_EQ(copy.hash(), denotations.hash());
+    EXPECT_EQ(copy.compute_fingerprint(), denotations.compute_fingerprint());
+    copy -= denotations;
+    EXPECT_NE(copy, denotations);
+    EXPECT_NE(copy.compute_fingerprint(), denotations.compute_fingerprint());
+    for (size_t i = 0; i < states.size(); ++i) {
+        EXPECT_EQ(denotations.count(i), 1);
+        EXPECT_TRUE(copy.empty(i));
+        EXPECT_TRUE(copy.is_subset_of(i, denotations));
+        EXPECT_FALSE(denotations.is_subset_of(i, copy));
+    }
+}
+
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include "../../include/dlplan/utils/bitset_kernels.h"
+#include "../../include/dlplan/utils/dynamic_bitset.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace dlplan;
+using namespace dlplan::kernels;
+
+
+namespace dlplan::tests::core {
+
+static std::vector<Block> make_random_blocks(std::size_t num_blocks, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<Block> result(num_blocks);
+    for (auto& block : result) block = rng();
+    return result;
+}
+
+TEST(DLPTests, BitsetKernelsAgreeWithScalar) {
+    const BitsetKernels* scalar = get_kernels(KernelVariant::SCALAR);
+    ASSERT_NE(scalar, nullptr);
+    // sizes cover the vector bodies and the remainders of all variants
+    for (std::size_t num_blocks : {1, 3, 4, 7, 8, 9, 17, 100}) {
+        auto left = make_random_blocks(num_blocks, 1);
+        auto right = make_random_blocks(num_blocks, 2);
+        for (auto variant : get_supported_variants()) {
+            const BitsetKernels* kernels = get_kernels(variant);
+            auto expected = left;
+            auto result = left;
+            scalar->bitwise_and(expected.data(), right.data(), num_blocks);
+            kernels->bitwise_and(result.data(), right.data(), num_blocks);
+            EXPECT_EQ(result, expected);
+            expected = left;
+            result = left;
+            scalar->bitwise_or(expected.data(), right.data(), num_blocks);
+            kernels->bitwise_or(result.data(), right.data(), num_blocks);
+            EXPECT_EQ(result, expected);
+            expected = left;
+            result = left;
+            scalar->bitwise_and_not(expected.data(), right.data(), num_blocks);
+            kernels->bitwise_and_not(result.data(), right.data(), num_blocks);
+            EXPECT_EQ(result, expected);
+            expected = left;
+            result = left;
+            scalar->bitwise_not(expected.data(), num_blocks);
+            kernels->bitwise_not(result.data(), num_blocks);
+            EXPECT_EQ(result, expected);
+            EXPECT_EQ(kernels->count(left.data(), num_blocks), scalar->count(left.data(), num_blocks));
+            EXPECT_EQ(kernels->intersects(left.data(), right.data(), num_blocks), scalar->intersects(left.data(), right.data(), num_blocks));
+            EXPECT_TRUE(kernels->equal(left.data(), left.data(), num_blocks));
+            EXPECT_FALSE(kernels->equal(left.data(), right.data(), num_blocks));
+            auto subset = left;
+            scalar->bitwise_and(subset.data(), right.data(), num_blocks);
+            EXPECT_TRUE(kernels->is_subset_of(subset.data(), left.data(), num_blocks));
+            EXPECT_FALSE(kernels->is_subset_of(left.data(), subset.data(), num_blocks) && !kernels->equal(left.data(), subset.data(), num_blocks));
+            std::vector<Block> zeros(num_blocks, 0);
+            EXPECT_TRUE(kernels->none(zeros.data(), num_blocks));
+            zeros.back() = 1;
+            EXPECT_FALSE(kernels->none(zeros.data(), num_blocks));
+            EXPECT_FALSE(kernels->intersects(left.data(), expected.data(), num_blocks));
+        }
+    }
+}
+
+TEST(DLPTests, DynamicBitsetOperations) {
+    // 300 bits span 5 blocks such that the kernels are used.
+    for (int num_bits : {10, 300}) {
+        DynamicBitset<std::uint64_t> left(num_bits);
+        DynamicBitset<std::uint64_t> right(num_bits);
+        for (int i = 0; i < num_bits; i += 2) left.set(i);
+        for (int i = 0; i < num_bits; i += 3) right.set(i);
+        auto intersection = left;
+        intersection &= right;
+        EXPECT_EQ(intersection.count(), (num_bits + 5) / 6);
+        auto complement = left;
+        ~complement;
+        EXPECT_EQ(complement.count(), num_bits - left.count());
+        EXPECT_FALSE(complement.intersects(left));
+        auto difference = left;
+        difference -= right;
+        EXPECT_TRUE(difference.is_subset_of(left));
+        EXPECT_FALSE(difference.intersects(right));
+        auto all = left;
+        all |= complement;
+        auto full = DynamicBitset<std::uint64_t>(num_bits);
+        full.set();
+        EXPECT_EQ(all, full);
+        EXPECT_NE(all, left);
+    }
+}
+
+TEST(DLPTests, DynamicBitsetInlineStorage) {
+    // 200 bits span 4 blocks: inline with 4 inline blocks, on the heap with 1.
+    DynamicBitset<std::uint64_t, 4> inline_bitset(200);
+    DynamicBitset<std::uint64_t, 1> heap_bitset(200);
+    for (int i = 0; i < 200; i += 7) {
+        inline_bitset.set(i);
+        heap_bitset.set(i);
+    }
+    EXPECT_EQ(inline_bitset.count(), heap_bitset.count());
+    EXPECT_EQ(inline_bitset.hash(), heap_bitset.hash());
+    EXPECT_TRUE(std::equal(inline_bitset.begin(), inline_bitset.end(), heap_bitset.begin(), heap_bitset.end()));
+    auto copy = inline_bitset;
+    ~copy;
+    EXPECT_FALSE(copy.intersects(inline_bitset));
+    EXPECT_EQ(copy.count() + inline_bitset.count(), 200);
+}
+
+}
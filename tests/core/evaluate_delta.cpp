@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include "../../include/dlplan/core.h"
+
+#include <string>
+
+using namespace dlplan::core;
+
+
+namespace dlplan::tests::core {
+
+TEST(DLPTests, EvaluateDelta) {
+    auto vocabulary = std::make_shared<VocabularyInfo>();
+    vocabulary->add_predicate("conn", 2, true);
+    vocabulary->add_predicate("at", 2);
+    vocabulary->add_predicate("goal", 1);
+    auto instance = std::make_shared<InstanceInfo>(0, vocabulary);
+    instance->add_static_atom("conn", {"x", "y"});
+    instance->add_static_atom("conn", {"y", "z"});
+    auto at_a_x = instance->add_atom("at", {"a", "x"}).get_index();
+    auto at_b_y = instance->add_atom("at", {"b", "y"}).get_index();
+    auto at_a_y = instance->add_atom("at", {"a", "y"}).get_index();
+    auto goal_a = instance->add_atom("goal", {"a"}).get_index();
+    auto goal_b = instance->add_atom("goal", {"b"}).get_index();
+
+    State parent_state(0, instance, AtomIndices{at_a_x, at_b_y, goal_a});
+    // moves a from x to y
+    AtomIndices added_atoms_1{at_a_y};
+    AtomIndices deleted_atoms_1{at_a_x};
+    State state_1(1, instance, AtomIndices{at_a_y, at_b_y, goal_a});
+    // changes the goal from a to b
+    AtomIndices added_atoms_2{goal_b};
+    AtomIndices deleted_atoms_2{goal_a};
+    State state_2(2, instance, AtomIndices{at_a_x, at_b_y, goal_b});
+
+    SyntacticElementFactory factory(vocabulary);
+    std::vector<std::string> concept_reprs = {
+        "c_primitive(goal,0)",
+        "c_primitive(at,0)",
+        "c_primitive(at,1)",
+        "c_and(c_primitive(at,0),c_primitive(goal,0))",
+        "c_or(c_primitive(at,1),c_primitive(goal,0))",
+        "c_diff(c_primitive(at,0),c_primitive(goal,0))",
+        "c_not(c_primitive(goal,0))",
+        "c_some(r_primitive(conn,0,1),c_primitive(at,1))",
+    };
+    std::vector<std::string> role_reprs = {
+        "r_primitive(at,0,1)",
+        "r_primitive(at,1,1)",
+        "r_and(r_primitive(at,0,1),r_primitive(conn,0,1))",
+        "r_or(r_primitive(at,0,1),r_primitive(conn,0,1))",
+        "r_diff(r_primitive(conn,0,1),r_primitive(at,0,1))",
+        "r_not(r_primitive(at,0,1))",
+        "r_compose(r_primitive(at,0,1),r_primitive(conn,0,1))",
+    };
+
+    DenotationsCaches caches;
+    for (const auto& repr : concept_reprs) {
+        auto element = factory.parse_concept(repr);
+        auto parent_denotation = element->evaluate(parent_state, caches);
+        auto denotation_1 = element->evaluate_delta(state_1, parent_state, added_atoms_1, deleted_atoms_1, caches);
+        auto denotation_2 = element->evaluate_delta(state_2, parent_state, added_atoms_2, deleted_atoms_2, caches);
+        EXPECT_EQ(*denotation_1, element->evaluate(state_1)) << repr;
+        EXPECT_EQ(*denotation_2, element->evaluate(state_2)) << repr;
+        EXPECT_EQ(denotation_1, element->evaluate(state_1, caches)) << repr;
+    }
+    for (const auto& repr : role_reprs) {
+        auto element = factory.parse_role(repr);
+        auto parent_denotation = element->evaluate(parent_state, caches);
+        auto denotation_1 = element->evaluate_delta(state_1, parent_state, added_atoms_1, deleted_atoms_1, caches);
+        auto denotation_2 = element->evaluate_delta(state_2, parent_state, added_atoms_2, deleted_atoms_2, caches);
+        EXPECT_EQ(*denotation_1, element->evaluate(state_1)) << repr;
+        EXPECT_EQ(*denotation_2, element->evaluate(state_2)) << repr;
+    }
+    auto numerical = factory.parse_numerical("n_count(c_and(c_primitive(at,0),c_primitive(goal,0)))");
+    EXPECT_EQ(numerical->evaluate_delta(state_2, parent_state, added_atoms_2, deleted_atoms_2, caches), numerical->evaluate(state_2));
+
+    // Elements whose inputs did not change share the parent denotation.
+    auto goal = factory.parse_concept("c_not(c_primitive(goal,0))");
+    EXPECT_EQ(goal->evaluate_delta(state_1, parent_state, added_atoms_1, deleted_atoms_1, caches), goal->evaluate(parent_state, caches));
+    auto at = factory.parse_role("r_diff(r_primitive(conn,0,1),r_primitive(at,0,1))");
+    EXPECT_EQ(at->evaluate_delta(state_2, parent_state, added_atoms_2, deleted_atoms_2, caches), at->evaluate(parent_state, caches));
+
+    // Without a cached parent denotation the element is evaluated from scratch.
+    DenotationsCaches empty_caches;
+    auto element = factory.parse_concept("c_and(c_primitive(at,0),c_primitive(goal,0))");
+    EXPECT_EQ(*element->evaluate_delta(state_1, parent_state, added_atoms_1, deleted_atoms_1, empty_caches), element->evaluate(state_1));
+}
+
+}
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+
+#include "../../include/dlplan/core.h"
+
+#include <limits>
+#include <string>
+
+using namespace dlplan::core;
+
+
+namespace dlplan::tests::core {
+
+/// @brief Returns states that alternate between two instances such that
+///        the frame must reallocate its denotations and recompute the
+///        static elements.
+static States create_states(std::shared_ptr<VocabularyInfo> vocabulary) {
+    std::vector<std::shared_ptr<InstanceInfo>> instances;
+    for (int num_objects : {5, 70}) {
+        auto instance = std::make_shared<InstanceInfo>(instances.size(), vocabulary);
+        for (int i = 0; i < num_objects; ++i) {
+            instance->add_static_atom("conn", {std::to_string(i), std::to_string((i + 1) % num_objects)});
+        }
+        instances.push_back(instance);
+    }
+    States states;
+    for (int k = 0; k < 3; ++k) {
+        for (const auto& instance : instances) {
+            int num_objects = instance->get_objects().size();
+            std::vector<Atom> atoms = {
+                instance->add_atom("at", {std::to_string(k), std::to_string((k + 2) % num_objects)}),
+                instance->add_atom("at", {std::to_string(num_objects - 1 - k), std::to_string(k)}),
+                instance->add_atom("goal", {std::to_string((3 * k + 1) % num_objects)})};
+            if (k > 0) {
+                atoms.push_back(instance->add_atom("handempty", {}));
+            }
+            states.emplace_back(states.size(), instance, std::move(atoms));
+        }
+    }
+    return states;
+}
+
+TEST(DLPTests, EvaluationPlan) {
+    auto vocabulary = std::make_shared<VocabularyInfo>();
+    vocabulary->add_predicate("conn", 2, true);
+    vocabulary->add_predicate("at", 2);
+    vocabulary->add_predicate("goal", 1);
+    vocabulary->add_predicate("handempty", 0);
+    auto states = create_states(vocabulary);
+    SyntacticElementFactory factory(vocabulary);
+
+    std::vector<std::shared_ptr<const Concept>> concepts;
+    for (const auto& repr : {
+        "c_primitive(goal,0)", "c_primitive(conn,0)", "c_top", "c_bot",
+        "c_and(c_primitive(at,0),c_primitive(goal,0))",
+        "c_or(c_primitive(at,1),c_primitive(goal,0))",
+        "c_diff(c_primitive(at,0),c_primitive(goal,0))",
+        "c_not(c_primitive(goal,0))",
+        "c_some(r_primitive(conn,0,1),c_primitive(goal,0))",
+        "c_all(r_primitive(at,0,1),c_primitive(goal,0))",
+        "c_equal(r_primitive(at,0,1),r_primitive(conn,0,1))",
+        "c_subset(r_primitive(at,0,1),r_primitive(conn,0,1))",
+        "c_projection(r_primitive(at,0,1),1)"}) {
+        concepts.push_back(factory.parse_concept(repr));
+    }
+    std::vector<std::shared_ptr<const Role>> roles;
+    for (const auto& repr : {
+        "r_primitive(at,0,1)", "r_top",
+        "r_and(r_primitive(at,0,1),r_primitive(conn,0,1))",
+        "r_or(r_primitive(at,0,1),r_primitive(conn,0,1))",
+        "r_diff(r_primitive(conn,0,1),r_primitive(at,0,1))",
+        "r_not(r_primitive(at,0,1))",
+        "r_compose(r_primitive(at,0,1),r_primitive(conn,0,1))",
+        "r_inverse(r_primitive(at,0,1))",
+        "r_restrict(r_primitive(conn,0,1),c_primitive(goal,0))",
+        "r_identity(c_primitive(goal,0))",
+        "r_transitive_closure(r_primitive(conn,0,1))",
+        "r_transitive_reflexive_closure(r_primitive(at,0,1))",
+        "r_til_c(r_primitive(conn,0,1),c_primitive(goal,0))"}) {
+        roles.push_back(factory.parse_role(repr));
+    }
+    std::vector<std::shared_ptr<const Numerical>> numericals;
+    for (const auto& repr : {
+        "n_count(c_primitive(at,0))",
+        "n_count(r_primitive(at,0,1))",
+        "n_concept_distance(c_primitive(at,0),r_primitive(conn,0,1),c_primitive(goal,0))",
+        "n_role_distance(r_primitive(at,0,1),r_primitive(conn,0,1),r_primitive(at,0,1))",
+        "n_sum_concept_distance(c_primitive(at,0),r_primitive(conn,0,1),c_primitive(goal,0))",
+        "n_sum_role_distance(r_primitive(at,0,1),r_primitive(conn,0,1),r_primitive(at,0,1))"}) {
+        numericals.push_back(factory.parse_numerical(repr));
+    }
+    std::vector<std::shared_ptr<const Boolean>> booleans;
+    for (const auto& repr : {
+        "b_nullary(handempty)",
+        "b_empty(c_primitive(goal,0))",
+        "b_empty(r_and(r_primitive(at,0,1),r_primitive(conn,0,1)))",
+        "b_inclusion(c_primitive(goal,0),c_primitive(at,0))",
+        "b_inclusion(r_primitive(at,0,1),r_primitive(conn,0,1))"}) {
+        booleans.push_back(factory.parse_boolean(repr));
+    }
+
+    auto plan = std::make_shared<const EvaluationPlan>(booleans, numericals, concepts, roles);
+    EvaluationFrame frame(plan);
+    for (const auto& state : states) {
+        frame.evaluate(state);
+        for (const auto& element : concepts) {
+            EXPECT_EQ(frame.get_denotation(*element), element->evaluate(state)) << element->str();
+            EXPECT_EQ(frame.get_concept_denotation(plan->get_slot(*element)), element->evaluate(state)) << element->str();
+        }
+        for (const auto& element : roles) {
+            EXPECT_EQ(frame.get_denotation(*element), element->evaluate(state)) << element->str();
+            EXPECT_EQ(frame.get_role_denotation(plan->get_slot(*element)), element->evaluate(state)) << element->str();
+        }
+        for (const auto& element : numericals) {
+            EXPECT_EQ(frame.get_denotation(*element), element->evaluate(state)) << element->str();
+            EXPECT_EQ(frame.get_numerical_denotation(plan->get_slot(*element)), element->evaluate(state)) << element->str();
+        }
+        for (const auto& element : booleans) {
+            EXPECT_EQ(frame.get_denotation(*element), element->evaluate(state)) << element->str();
+            EXPECT_EQ(frame.get_boolean_denotation(plan->get_slot(*element)), element->evaluate(state)) << element->str();
+        }
+    }
+}
+
+TEST(DLPTests, EvaluationPlanDistances) {
+    auto vocabulary = std::make_shared<VocabularyInfo>();
+    vocabulary->add_predicate("from", 2, true);
+    vocabulary->add_predicate("to", 2, true);
+    vocabulary->add_predicate("edge", 2);
+    auto instance = std::make_shared<InstanceInfo>(0, vocabulary);
+    instance->add_static_atom("from", {"p", "a"});
+    instance->add_static_atom("to", {"p", "c"});
+    // c is at distance 2 from a in the first state and unreachable in the
+    // second, which evaluates with the distances of the first state reused.
+    States states;
+    states.emplace_back(0, instance, std::vector<Atom>{instance->add_atom("edge", {"a", "b"}), instance->add_atom("edge", {"b", "c"})});
+    states.emplace_back(1, instance, std::vector<Atom>{instance->add_atom("edge", {"a", "b"})});
+    SyntacticElementFactory factory(vocabulary);
+    std::vector<std::shared_ptr<const Numerical>> numericals = {
+        factory.parse_numerical("n_role_distance(r_primitive(from,0,1),r_primitive(edge,0,1),r_primitive(to,0,1))"),
+        factory.parse_numerical("n_sum_role_distance(r_primitive(from,0,1),r_primitive(edge,0,1),r_primitive(to,0,1))")};
+    EvaluationFrame frame(std::make_shared<const EvaluationPlan>(std::vector<std::shared_ptr<const Boolean>>{}, numericals, std::vector<std::shared_ptr<const Concept>>{}));
+    for (const auto& numerical : numericals) {
+        EXPECT_EQ(numerical->evaluate(states[0]), 2);
+        EXPECT_EQ(numerical->evaluate(states[1]), std::numeric_limits<int>::max());
+    }
+    for (const auto& state : states) {
+        frame.evaluate(state);
+        for (const auto& numerical : numericals) {
+            EXPECT_EQ(frame.get_denotation(*numerical), numerical->evaluate(state)) << numerical->str();
+        }
+    }
+}
+
+TEST(DLPTests, EvaluationPlanSharedElements) {
+    auto vocabulary = std::make_shared<VocabularyInfo>();
+    vocabulary->add_predicate("conn", 2, true);
+    vocabulary->add_predicate("at", 2);
+    vocabulary->add_predicate("goal", 1);
+    vocabulary->add_predicate("handempty", 0);
+    SyntacticElementFactory factory(vocabulary);
+
+    // c_primitive(at,0) is shared and compiled once, c_primitive(conn,0) is static.
+    auto numerical = factory.parse_numerical("n_count(c_primitive(at,0))");
+    auto boolean = factory.parse_boolean("b_empty(c_primitive(at,0))");
+    auto concept_ = factory.parse_concept("c_and(c_primitive(at,0),c_primitive(conn,0))");
+    auto plan = std::make_shared<const EvaluationPlan>(
+        std::vector<std::shared_ptr<const Boolean>>{boolean},
+        std::vector<std::shared_ptr<const Numerical>>{numerical},
+        std::vector<std::shared_ptr<const Concept>>{concept_});
+    EXPECT_EQ(plan->get_num_instructions(), 5);
+    EXPECT_EQ(plan->get_num_static_instructions(), 1);
+
+    EvaluationFrame frame(plan);
+    EXPECT_THROW(frame.get_denotation(*factory.parse_concept("c_primitive(goal,0)")), std::runtime_error);
+}
+
+}
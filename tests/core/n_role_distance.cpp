@@ -48,4 +48,32 @@ TEST(DLPTests, NumericalRoleDistance) {
     EXPECT_EQ(numerical_2->evaluate(state_0), std::numeric_limits<int>::max());
 }
 
+TEST(DLPTests, NumericalRoleDistanceSharedPairwiseDistances) {
+    auto vocabulary = std::make_shared<VocabularyInfo>();
+    auto predicate_0 = vocabulary->add_predicate("conn", 2);
+    auto predicate_1 = vocabulary->add_predicate("start", 2);
+    auto predicate_2 = vocabulary->add_predicate("end", 2);
+    auto instance = std::make_shared<InstanceInfo>(0, vocabulary);
+    auto atom_0 = instance->add_atom("conn", {"A", "B"});
+    auto atom_1 = instance->add_atom("conn", {"B", "C"});
+    auto atom_2 = instance->add_atom("conn", {"C", "A"});
+    auto atom_3 = instance->add_atom("start", {"X", "A"});
+    auto atom_4 = instance->add_atom("end", {"X", "C"});
+    auto atom_5 = instance->add_atom("start", {"X", "C"});
+    auto atom_6 = instance->add_atom("end", {"X", "B"});
+
+    State state_0(0, instance, {atom_0, atom_1, atom_2, atom_3, atom_4});
+    State state_1(1, instance, {atom_0, atom_1, atom_2, atom_5, atom_6});
+
+    SyntacticElementFactory factory(vocabulary);
+    DenotationsCaches caches;
+
+    auto numerical_0 = factory.parse_numerical("n_role_distance(r_primitive(start,0,1),r_primitive(conn,0,1),r_primitive(end,0,1))");
+    EXPECT_EQ(numerical_0->evaluate(state_0, caches), 2);
+    EXPECT_EQ(numerical_0->evaluate(state_1, caches), 2);
+    EXPECT_EQ(*numerical_0->evaluate({state_0, state_1}, caches), NumericalDenotations({2, 2}));
+    // Both states share the denotation of conn and hence its pairwise distances.
+    EXPECT_EQ(caches.pairwise_distances.size(), 1);
+}
+
 }
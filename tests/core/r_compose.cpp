@@ -3,6 +3,9 @@
 #include "../utils/denotation.h"
 
 #include "../../include/dlplan/core.h"
+#include "../../include/dlplan/core/elements/utils.h"
+
+#include <random>
 
 using namespace dlplan::core;
 
@@ -29,4 +32,33 @@ TEST(DLPTests, RoleCompose) {
     EXPECT_EQ(role1->evaluate(state_0), create_role_denotation(*instance, {{"A", "B"}, {"A", "C"}, {"B", "B"}, {"B", "C"}}));
 }
 
+TEST(DLPTests, RoleComposeBooleanMatrixProduct) {
+    // Rows span two 64-bit blocks and the last group of 8 rows is incomplete.
+    int num_objects = 70;
+    std::mt19937 rng(0);
+    std::bernoulli_distribution dist(0.1);
+    RoleDenotation left(num_objects);
+    RoleDenotation right(num_objects);
+    for (int i = 0; i < num_objects; ++i) {
+        for (int j = 0; j < num_objects; ++j) {
+            if (dist(rng)) left.insert({i, j});
+            if (dist(rng)) right.insert({i, j});
+        }
+    }
+    RoleDenotation expected(num_objects);
+    for (const auto& left_pair : left) {
+        for (const auto& right_pair : right) {
+            if (left_pair.second == right_pair.first) {
+                expected.insert({left_pair.first, right_pair.second});
+            }
+        }
+    }
+    RoleDenotation by_rows(num_objects);
+    dlplan::core::utils::compute_composition_by_rows(left, right, by_rows);
+    EXPECT_EQ(by_rows, expected);
+    RoleDenotation four_russians(num_objects);
+    dlplan::core::utils::compute_composition_four_russians(left, right, four_russians);
+    EXPECT_EQ(four_russians, expected);
+}
+
 }
@@ -30,4 +30,40 @@ TEST(DLPTests, RolePrimitive) {
     EXPECT_EQ(role_2->evaluate(state_0), create_role_denotation(*instance, {{"C", "A"}, {"F", "D"}}));
 }
 
+TEST(DLPTests, RolePrimitiveStaticAtoms) {
+    auto vocabulary = std::make_shared<VocabularyInfo>();
+    auto predicate_0 = vocabulary->add_predicate("predicate", 2);
+    auto instance = std::make_shared<InstanceInfo>(0, vocabulary);
+    auto atom_0 = instance->add_atom("predicate", {"A", "B"});
+    instance->add_static_atom("predicate", {"B", "C"});
+
+    State state_0(0, instance, std::vector<Atom>{});
+    State state_1(1, instance, {atom_0});
+
+    SyntacticElementFactory factory(vocabulary);
+    DenotationsCaches caches;
+
+    // The static atoms contribute to the denotations on all states.
+    auto role_0 = factory.parse_role("r_primitive(predicate,0,1)");
+    EXPECT_EQ(role_0->evaluate(state_0), create_role_denotation(*instance, {{"B", "C"}}));
+    EXPECT_EQ(role_0->evaluate(state_1), create_role_denotation(*instance, {{"A", "B"}, {"B", "C"}}));
+    EXPECT_EQ(*role_0->evaluate(state_0, caches), role_0->evaluate(state_0));
+    EXPECT_EQ(*role_0->evaluate(state_1, caches), role_0->evaluate(state_1));
+    auto denotations = role_0->evaluate(States{state_0, state_1}, caches);
+    EXPECT_EQ(denotations->get_denotation(0), role_0->evaluate(state_0));
+    EXPECT_EQ(denotations->get_denotation(1), role_0->evaluate(state_1));
+
+    // The contribution of the static atoms does not collide with the
+    // denotation on a state of index -1, in either order of evaluation.
+    State state_2(-1, instance, {atom_0});
+    for (bool state_first : {false, true}) {
+        DenotationsCaches caches_2;
+        if (state_first) {
+            EXPECT_EQ(*role_0->evaluate(state_2, caches_2), role_0->evaluate(state_1));
+        }
+        EXPECT_EQ(*role_0->evaluate(state_0, caches_2), role_0->evaluate(state_0));
+        EXPECT_EQ(*role_0->evaluate(state_2, caches_2), role_0->evaluate(state_1));
+    }
+}
+
 }
@@ -31,4 +31,25 @@ TEST(DLPTests, RoleTransitiveClosure) {
     EXPECT_EQ(role_1->evaluate(state_0), create_role_denotation(*instance, {{"A", "A"}, {"A", "B"}, {"A", "C"}, {"B", "A"}, {"B", "B"}, {"B", "C"}, {"C", "A"}, {"C", "B"}, {"C", "C"}, {"D", "A"}, {"D", "B"}, {"D", "C"}, {"D", "E"}, {"E", "A"}, {"E", "B"}, {"E", "C"}}));
 }
 
+TEST(DLPTests, RoleTransitiveClosureMultipleBlocks) {
+    // A chain over 70 objects, i.e., rows that span two 64-bit blocks.
+    int num_objects = 70;
+    auto vocabulary = std::make_shared<VocabularyInfo>();
+    auto predicate_0 = vocabulary->add_predicate("conn", 2);
+    auto instance = std::make_shared<InstanceInfo>(0, vocabulary);
+    AtomIndices atom_indices;
+    for (int i = 0; i + 1 < num_objects; ++i) {
+        atom_indices.push_back(instance->add_atom("conn", {std::to_string(i), std::to_string(i + 1)}).get_index());
+    }
+    State state_0(0, instance, atom_indices);
+
+    SyntacticElementFactory factory(vocabulary);
+
+    auto role_0 = factory.parse_role("r_transitive_closure(r_primitive(conn,0,1))");
+    auto denotation = role_0->evaluate(state_0);
+    EXPECT_EQ(denotation.size(), num_objects * (num_objects - 1) / 2);
+    EXPECT_TRUE(denotation.contains({0, num_objects - 1}));
+    EXPECT_FALSE(denotation.contains({num_objects - 1, 0}));
+}
+
 }
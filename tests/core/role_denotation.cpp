@@ -15,4 +15,49 @@ TEST(DLPTests, RoleDenotationComputeRepr) {
     EXPECT_EQ(denotation.str(), "RoleDenotation(num_objects=4, pairs_of_object_indices=[<0,1>, <1,2>])");
 }
 
+TEST(DLPTests, RoleDenotationIterate) {
+    int num_objects = 13;
+    RoleDenotation denotation(num_objects);
+    EXPECT_EQ(denotation.begin(), denotation.end());
+    denotation.insert({12,12});
+    denotation.insert({4,11});
+    denotation.insert({0,3});
+    denotation.insert({4,12});
+    PairsOfObjectIndices result;
+    for (const auto& pair : denotation) {
+        result.push_back(pair);
+    }
+    EXPECT_EQ(result, PairsOfObjectIndices({{0,3}, {4,11}, {4,12}, {12,12}}));
+    EXPECT_EQ(denotation.to_sorted_vector(), result);
+}
+
+TEST(DLPTests, RoleDenotationRows) {
+    // rows span two 64-bit blocks with padding
+    int num_objects = 70;
+    RoleDenotation denotation(num_objects);
+    denotation.set();
+    EXPECT_EQ(denotation.size(), num_objects * num_objects);
+    ~denotation;
+    EXPECT_TRUE(denotation.empty());
+    denotation.insert({3,69});
+    denotation.insert({3,1});
+    denotation.insert({5,3});
+    EXPECT_EQ(denotation.get_row(3).size(), 2);
+    EXPECT_TRUE(denotation.get_row(3).contains(69));
+    EXPECT_TRUE(denotation.get_row(4).empty());
+
+    ConceptDenotation concept_denotation(num_objects);
+    concept_denotation.insert(69);
+    EXPECT_TRUE(denotation.get_row(3).intersects(concept_denotation));
+    EXPECT_FALSE(denotation.get_row(5).intersects(concept_denotation));
+    denotation.intersect_row(3, concept_denotation);
+    EXPECT_TRUE(denotation.get_row(3).is_subset_of(concept_denotation));
+    denotation.unite_row(0, concept_denotation);
+    EXPECT_EQ(denotation.to_sorted_vector(), PairsOfObjectIndices({{0,69}, {3,69}, {5,3}}));
+
+    RoleDenotation transpose = denotation.transpose();
+    EXPECT_EQ(transpose.to_sorted_vector(), PairsOfObjectIndices({{3,5}, {69,0}, {69,3}}));
+    EXPECT_EQ(transpose.transpose(), denotation);
+}
+
 }
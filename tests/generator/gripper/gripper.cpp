@@ -0,0 +1,390 @@
+#include <gtest/gtest.h>
+
+#include "../../utils/domain.h"
+
+#include "../../../include/dlplan/generator.h"
+
+#include <csignal>
+#include <filesystem>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace dlplan::core;
+using namespace dlplan::generator;
+
+
+namespace dlplan::tests::generator {
+
+/// @brief Returns the gripper states with the robot and the packages at
+///        different rooms.
+static States create_states(std::shared_ptr<InstanceInfo> instance_info) {
+    // at(p,A)=0,2,4 at(p,B)=1,3,5 at_roboter(A)=6 at_roboter(B)=7 holding(p)=8,9,10
+    States states;
+    for (const auto& atom_indices : std::vector<AtomIndices>{
+        {0, 2, 4, 6}, {8, 2, 4, 6}, {8, 2, 4, 7}, {1, 2, 4, 7}, {1, 2, 4, 6}, {1, 9, 4, 6}, {1, 3, 5, 7}}) {
+        states.emplace_back(states.size(), instance_info, atom_indices);
+    }
+    return states;
+}
+
+/// @brief Returns the string representations of the generated features in
+///        the order of generation.
+static std::vector<std::string> to_strings(const GeneratedFeatures& features) {
+    const auto& [booleans, numericals, concepts, roles] = features;
+    std::vector<std::string> result;
+    for (const auto& boolean : booleans) result.push_back(boolean->str());
+    for (const auto& numerical : numericals) result.push_back(numerical->str());
+    for (const auto& concept_ : concepts) result.push_back(concept_->str());
+    for (const auto& role : roles) result.push_back(role->str());
+    return result;
+}
+
+static std::vector<std::string> generate(const States& states, std::shared_ptr<VocabularyInfo> vocabulary_info, int num_threads, bool use_fingerprints = false) {
+    SyntacticElementFactory factory(vocabulary_info);
+    FeatureGenerator feature_generator;
+    feature_generator.set_num_threads(num_threads);
+    feature_generator.set_use_fingerprints(use_fingerprints);
+    return to_strings(feature_generator.generate(factory, states, 5, 5, 5, 5, 5, 3600, 10000));
+}
+
+TEST(DLPTests, GeneratorGripperParallel) {
+    auto vocabulary_info = gripper::construct_vocabulary_info();
+    auto states = create_states(gripper::construct_instance_info(vocabulary_info));
+
+    auto sequential = generate(states, vocabulary_info, 1);
+    EXPECT_FALSE(sequential.empty());
+    EXPECT_EQ(generate(states, vocabulary_info, 4), sequential);
+    EXPECT_THROW(FeatureGenerator().set_num_threads(0), std::runtime_error);
+
+    // The representations do not depend on the order in which concurrent
+    // tasks create the elements, which reversing the order of creation
+    // simulates.
+    SyntacticElementFactory factory(vocabulary_info);
+    std::vector<std::shared_ptr<const void>> reversed;
+    for (auto it = sequential.rbegin(); it != sequential.rend(); ++it) {
+        if (it->rfind("b_", 0) == 0) reversed.push_back(factory.parse_boolean(*it));
+        else if (it->rfind("n_", 0) == 0) reversed.push_back(factory.parse_numerical(*it));
+        else if (it->rfind("c_", 0) == 0) reversed.push_back(factory.parse_concept(*it));
+        else reversed.push_back(factory.parse_role(*it));
+    }
+    FeatureGenerator feature_generator;
+    EXPECT_EQ(to_strings(feature_generator.generate(factory, states, 5, 5, 5, 5, 5, 3600, 10000)), sequential);
+}
+
+TEST(DLPTests, GeneratorGripperFingerprints) {
+    auto vocabulary_info = gripper::construct_vocabulary_info();
+    auto states = create_states(gripper::construct_instance_info(vocabulary_info));
+
+    auto expected = generate(states, vocabulary_info, 1);
+    EXPECT_EQ(generate(states, vocabulary_info, 1, true), expected);
+    EXPECT_EQ(generate(states, vocabulary_info, 4, true), expected);
+
+    // Fingerprints keep no denotations on the states beyond a task, and the
+    // memory limit bounds the caches of the tasks as well.
+    std::size_t peak_num_bytes[3];
+    for (int i = 0; i < 3; ++i) {
+        SyntacticElementFactory factory(vocabulary_info);
+        FeatureGenerator feature_generator;
+        feature_generator.set_use_fingerprints(i > 0);
+        if (i == 2) {
+            feature_generator.set_memory_limit(peak_num_bytes[0] / 10);
+        }
+        EXPECT_EQ(to_strings(feature_generator.generate(factory, states, 5, 5, 5, 5, 5, 3600, 10000)), expected);
+        peak_num_bytes[i] = feature_generator.get_peak_num_bytes();
+    }
+    EXPECT_LT(peak_num_bytes[1], peak_num_bytes[0]);
+    EXPECT_LE(10 * peak_num_bytes[2], peak_num_bytes[0]);
+}
+
+TEST(DLPTests, GeneratorGripperCheckpoint) {
+    auto vocabulary_info = gripper::construct_vocabulary_info();
+    auto states = create_states(gripper::construct_instance_info(vocabulary_info));
+    auto expected = generate(states, vocabulary_info, 1);
+
+    const std::string checkpoint_file = "gripper_checkpoint.txt";
+    std::filesystem::remove(checkpoint_file);
+    {
+        // Generation that stops during complexity 4, which leaves the
+        // checkpoint of complexity 3.
+        SyntacticElementFactory factory(vocabulary_info);
+        FeatureGenerator feature_generator;
+        feature_generator.set_checkpoint_file(checkpoint_file);
+        feature_generator.set_concept_callback([](const auto&, const auto&, int complexity) { return complexity < 4; });
+        feature_generator.generate(factory, states, 5, 5, 5, 5, 5, 3600, 10000);
+    }
+    // Resuming with other states, limits or settings is rejected.
+    States reordered_states(states);
+    std::swap(reordered_states[0], reordered_states[1]);
+    for (int i = 0; i < 5; ++i) {
+        SyntacticElementFactory factory(vocabulary_info);
+        FeatureGenerator feature_generator;
+        feature_generator.set_checkpoint_file(checkpoint_file);
+        feature_generator.set_generate_compose_role(i != 1);
+        feature_generator.set_use_fingerprints(i == 2);
+        feature_generator.set_num_probe_states(i == 3 ? 3 : 0);
+        EXPECT_THROW(feature_generator.resume(factory, (i == 4) ? reordered_states : states, 5, 5, 5, 5, i == 0 ? 4 : 5, 3600, 10000), std::runtime_error);
+    }
+    SyntacticElementFactory factory(vocabulary_info);
+    FeatureGenerator feature_generator;
+    EXPECT_THROW(feature_generator.resume(factory, states, 5, 5, 5, 5, 5, 3600, 10000), std::runtime_error);
+    feature_generator.set_checkpoint_file(checkpoint_file);
+    EXPECT_EQ(to_strings(feature_generator.resume(factory, states, 5, 5, 5, 5, 5, 3600, 10000)), expected);
+    std::filesystem::remove(checkpoint_file);
+}
+
+TEST(DLPTests, GeneratorGripperCallbacks) {
+    auto vocabulary_info = gripper::construct_vocabulary_info();
+    auto states = create_states(gripper::construct_instance_info(vocabulary_info));
+    auto expected = generate(states, vocabulary_info, 4);
+
+    SyntacticElementFactory factory(vocabulary_info);
+    FeatureGenerator feature_generator;
+    feature_generator.set_num_threads(4);
+    DenotationsCaches caches;
+    std::vector<std::string> booleans, numericals, concepts, roles;
+    feature_generator.set_boolean_callback([&](const auto& element, const auto& denotations, int) {
+        EXPECT_EQ(denotations->size(), states.size());
+        booleans.push_back(element->str());
+        return true;
+    });
+    feature_generator.set_numerical_callback([&](const auto& element, const auto&, int) {
+        numericals.push_back(element->str());
+        return true;
+    });
+    feature_generator.set_concept_callback([&](const auto& element, const auto& denotations, int) {
+        EXPECT_EQ(*denotations, *element->evaluate(states, caches));
+        concepts.push_back(element->str());
+        return true;
+    });
+    feature_generator.set_role_callback([&](const auto& element, const auto&, int) {
+        roles.push_back(element->str());
+        return true;
+    });
+    feature_generator.generate(factory, states, 5, 5, 5, 5, 5, 3600, 10000);
+    std::vector<std::string> received;
+    for (const auto* strs : {&booleans, &numericals, &concepts, &roles}) {
+        received.insert(received.end(), strs->begin(), strs->end());
+    }
+    EXPECT_EQ(received, expected);
+
+    // Stops after the tenth concept.
+    int num_concepts = 0;
+    feature_generator.set_concept_callback([&](const auto&, const auto&, int) {
+        return ++num_concepts < 10;
+    });
+    const auto [generated_booleans, generated_numericals, generated_concepts, generated_roles] = feature_generator.generate(factory, states, 5, 5, 5, 5, 5, 3600, 10000);
+    EXPECT_EQ(num_concepts, 10);
+    EXPECT_EQ(static_cast<int>(generated_concepts.size()), 10);
+}
+
+TEST(DLPTests, GeneratorGripperProbeStates) {
+    auto vocabulary_info = gripper::construct_vocabulary_info();
+    auto states = create_states(gripper::construct_instance_info(vocabulary_info));
+    auto expected = generate(states, vocabulary_info, 1);
+
+    SyntacticElementFactory factory(vocabulary_info);
+    FeatureGenerator feature_generator;
+    EXPECT_THROW(feature_generator.set_num_probe_states(-1), std::runtime_error);
+    // Probing all states is disabled.
+    feature_generator.set_num_probe_states(states.size());
+    EXPECT_EQ(to_strings(feature_generator.generate(factory, states, 5, 5, 5, 5, 5, 3600, 10000)), expected);
+
+    // The screened features do not depend on the number of threads.
+    for (int num_probe_states : {1, 2, 3}) {
+        feature_generator.set_num_probe_states(num_probe_states);
+        feature_generator.set_num_threads(1);
+        auto sequential = to_strings(feature_generator.generate(factory, states, 5, 5, 5, 5, 5, 3600, 10000));
+        feature_generator.set_num_threads(4);
+        EXPECT_EQ(to_strings(feature_generator.generate(factory, states, 5, 5, 5, 5, 5, 3600, 10000)), sequential);
+    }
+
+    const auto [booleans, numericals, concepts, roles] = feature_generator.generate(factory, states, 5, 5, 5, 5, 5, 3600, 10000);
+    EXPECT_FALSE(concepts.empty());
+    DenotationsCaches caches;
+    std::unordered_set<std::shared_ptr<const ConceptDenotations>> denotations;
+    for (const auto& concept_ : concepts) {
+        EXPECT_TRUE(denotations.insert(concept_->evaluate(states, caches)).second) << concept_->str();
+    }
+}
+
+TEST(DLPTests, GeneratorGripperIncremental) {
+    auto vocabulary_info = gripper::construct_vocabulary_info();
+    auto states = create_states(gripper::construct_instance_info(vocabulary_info));
+    const States sample(states.begin(), states.begin() + 3);
+
+    SyntacticElementFactory factory(vocabulary_info);
+    FeatureGenerator feature_generator;
+    EXPECT_THROW(feature_generator.extend(states), std::runtime_error);
+    feature_generator.set_incremental(true);
+    auto features = to_strings(feature_generator.generate(factory, sample, 5, 5, 5, 5, 5, 3600, 10000));
+    EXPECT_EQ(features, generate(sample, vocabulary_info, 1));
+
+    std::vector<std::string> streamed;
+    feature_generator.set_concept_callback([&](const auto& element, const auto&, int) {
+        streamed.push_back(element->str());
+        return true;
+    });
+
+    // Extend twice such that the second extension builds on the first one.
+    for (std::size_t end : {5, 7}) {
+        streamed.clear();
+        const auto extended = feature_generator.extend(States(states.begin() + (end - 2), states.begin() + end));
+        auto extended_features = to_strings(extended);
+        EXPECT_EQ(streamed, to_strings({{}, {}, std::get<2>(extended), {}}));
+        EXPECT_GT(extended_features.size(), features.size());
+        std::unordered_set<std::string> reprs(extended_features.begin(), extended_features.end());
+        for (const auto& repr : features) {
+            EXPECT_TRUE(reprs.count(repr)) << repr;
+        }
+        const States extended_sample(states.begin(), states.begin() + end);
+        DenotationsCaches caches;
+        std::unordered_set<std::shared_ptr<const ConceptDenotations>> denotations;
+        for (const auto& concept_ : std::get<2>(extended)) {
+            EXPECT_TRUE(denotations.insert(concept_->evaluate(extended_sample, caches)).second) << concept_->str();
+        }
+        features = std::move(extended_features);
+    }
+    feature_generator.set_incremental(false);
+    EXPECT_THROW(feature_generator.extend(states), std::runtime_error);
+
+    // Extensions replay the elements in the order of commitment across the
+    // types, hence extending by no states streams the features as generated.
+    FeatureGenerator ordered_generator;
+    ordered_generator.set_incremental(true);
+    std::vector<std::string> received;
+    auto receive = [&](const auto& element, const auto&, int) {
+        received.push_back(element->str());
+        return true;
+    };
+    ordered_generator.set_boolean_callback(receive);
+    ordered_generator.set_numerical_callback(receive);
+    ordered_generator.set_concept_callback(receive);
+    ordered_generator.set_role_callback(receive);
+    ordered_generator.generate(factory, sample, 5, 5, 5, 5, 5, 3600, 10000);
+    auto generated = std::move(received);
+    received.clear();
+    ordered_generator.extend(States());
+    EXPECT_EQ(received, generated);
+    received.clear();
+    auto extended_features = to_strings(ordered_generator.extend(States(states.begin() + 3, states.end())));
+    auto extended_received = std::move(received);
+    received.clear();
+
+    // A resumed generation extends like the generation it continues, since
+    // the checkpoint keeps the duplicates in the order of commitment.
+    const std::string checkpoint_file = "gripper_incremental_checkpoint.txt";
+    std::filesystem::remove(checkpoint_file);
+    ordered_generator.set_checkpoint_file(checkpoint_file);
+    ordered_generator.set_concept_callback([&](const auto& element, const auto&, int complexity) {
+        received.push_back(element->str());
+        return complexity < 4;
+    });
+    ordered_generator.generate(factory, sample, 5, 5, 5, 5, 5, 3600, 10000);
+    ordered_generator.set_concept_callback(receive);
+    received.clear();
+    ordered_generator.resume(factory, sample, 5, 5, 5, 5, 5, 3600, 10000);
+    EXPECT_EQ(received, generated);
+    received.clear();
+    EXPECT_EQ(to_strings(ordered_generator.extend(States(states.begin() + 3, states.end()))), extended_features);
+    EXPECT_EQ(received, extended_received);
+    ordered_generator.set_incremental(false);
+    EXPECT_THROW(ordered_generator.resume(factory, sample, 5, 5, 5, 5, 5, 3600, 10000), std::runtime_error);
+    ordered_generator.set_incremental(true);
+    ordered_generator.set_checkpoint_file("");
+    std::filesystem::remove(checkpoint_file);
+
+    // A stopped generation cannot be extended.
+    ordered_generator.set_concept_callback([](const auto&, const auto&, int) { return false; });
+    ordered_generator.generate(factory, sample, 5, 5, 5, 5, 5, 3600, 10000);
+    EXPECT_THROW(ordered_generator.extend(states), std::runtime_error);
+}
+
+TEST(DLPTests, GeneratorGripperCancellation) {
+    auto vocabulary_info = gripper::construct_vocabulary_info();
+    auto states = create_states(gripper::construct_instance_info(vocabulary_info));
+    auto expected = generate(states, vocabulary_info, 1);
+
+    SyntacticElementFactory factory(vocabulary_info);
+    FeatureGenerator feature_generator;
+    CancellationToken token;
+    feature_generator.set_cancellation_token(token);
+    token.cancel();
+    EXPECT_TRUE(to_strings(feature_generator.generate(factory, states, 5, 5, 5, 5, 5, 3600, 10000)).empty());
+
+    // Cancel from a concurrent task, which stops after its current candidate.
+    token.reset();
+    feature_generator.set_num_threads(4);
+    int num_concepts = 0;
+    feature_generator.set_concept_callback([&](const auto&, const auto&, int) {
+        if (++num_concepts == 10) token.cancel();
+        return true;
+    });
+    auto features = to_strings(feature_generator.generate(factory, states, 5, 5, 5, 5, 5, 3600, 10000));
+    EXPECT_GE(num_concepts, 10);
+    EXPECT_LT(features.size(), expected.size());
+    std::unordered_set<std::string> reprs(expected.begin(), expected.end());
+    for (const auto& repr : features) {
+        EXPECT_TRUE(reprs.count(repr)) << repr;
+    }
+
+    token.reset();
+    feature_generator.set_concept_callback(nullptr);
+    feature_generator.set_memory_limit(1);
+    features = to_strings(feature_generator.generate(factory, states, 5, 5, 5, 5, 5, 3600, 10000));
+    EXPECT_LT(features.size(), expected.size());
+    feature_generator.set_memory_limit(0);
+    EXPECT_EQ(to_strings(feature_generator.generate(factory, states, 5, 5, 5, 5, 5, 3600, 10000)), expected);
+}
+
+static void ignore_sigint(int) { }
+
+TEST(DLPTests, GeneratorGripperSigint) {
+    auto vocabulary_info = gripper::construct_vocabulary_info();
+    auto states = create_states(gripper::construct_instance_info(vocabulary_info));
+    auto expected = generate(states, vocabulary_info, 1);
+
+    SyntacticElementFactory factory(vocabulary_info);
+    FeatureGenerator feature_generator;
+    CancellationToken token;
+    feature_generator.set_cancellation_token(token);
+    auto previous_handler = std::signal(SIGINT, ignore_sigint);
+
+    // SIGINT stops the running generation only.
+    int num_concepts = 0;
+    feature_generator.set_concept_callback([&](const auto&, const auto&, int) {
+        if (++num_concepts == 10) std::raise(SIGINT);
+        return true;
+    });
+    auto features = to_strings(feature_generator.generate(factory, states, 5, 5, 5, 5, 5, 3600, 10000));
+    EXPECT_LT(features.size(), expected.size());
+    EXPECT_FALSE(token.is_cancelled());
+    feature_generator.set_concept_callback(nullptr);
+    EXPECT_EQ(to_strings(feature_generator.generate(factory, states, 5, 5, 5, 5, 5, 3600, 10000)), expected);
+
+    // SIGINT stops an extension alike, which later extensions then skip.
+    feature_generator.set_incremental(true);
+    const States sample(states.begin(), states.begin() + 3);
+    const States additional_states(states.begin() + 3, states.end());
+    feature_generator.generate(factory, sample, 5, 5, 5, 5, 5, 3600, 10000);
+    auto extended = to_strings(feature_generator.extend(additional_states));
+    num_concepts = 0;
+    feature_generator.set_concept_callback([&](const auto&, const auto&, int) {
+        if (++num_concepts == 10) std::raise(SIGINT);
+        return true;
+    });
+    EXPECT_LT(to_strings(feature_generator.extend(additional_states)).size(), extended.size());
+    EXPECT_FALSE(token.is_cancelled());
+    feature_generator.set_concept_callback(nullptr);
+    EXPECT_EQ(to_strings(feature_generator.extend(additional_states)), extended);
+    feature_generator.set_incremental(false);
+
+    // The handler is restored if the generation throws.
+    feature_generator.set_concept_callback([&](const auto&, const auto&, int) -> bool {
+        throw std::runtime_error("callback failed");
+    });
+    EXPECT_THROW(feature_generator.generate(factory, states, 5, 5, 5, 5, 5, 3600, 10000), std::runtime_error);
+    EXPECT_EQ(std::signal(SIGINT, previous_handler), &ignore_sigint);
+}
+
+}
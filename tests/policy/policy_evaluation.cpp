@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include "../utils/domain.h"
+
+#include "../../include/dlplan/policy.h"
+
+using namespace std;
+using namespace dlplan::core;
+using namespace dlplan::policy;
+
+
+namespace dlplan::tests::policy {
+
+TEST(DLPTests, PolicyEvaluationPlan) {
+    auto vocabulary_info = gripper::construct_vocabulary_info();
+    auto instance_info = gripper::construct_instance_info(vocabulary_info);
+    auto element_factory = construct_syntactic_element_factory(vocabulary_info);
+    PolicyFactory policy_factory(element_factory);
+    auto b0 = policy_factory.make_boolean("b0", element_factory->parse_boolean("b_empty(c_primitive(holding,0))"));
+    auto b1 = policy_factory.make_boolean("b1", element_factory->parse_boolean("b_inclusion(c_primitive(package,0),c_some(r_primitive(at,0,1),c_primitive(at_roboter,0)))"));
+    auto n0 = policy_factory.make_numerical("n0", element_factory->parse_numerical("n_count(r_and(r_primitive(at,0,1),r_primitive(at_g,0,1)))"));
+    auto n1 = policy_factory.make_numerical("n1", element_factory->parse_numerical("n_count(c_primitive(holding,0))"));
+    auto c0 = policy_factory.make_concept("c0", element_factory->parse_concept("c_some(r_primitive(at,0,1),c_primitive(at_roboter,0))"));
+    auto policy = policy_factory.make_policy({
+        policy_factory.make_rule(
+            {policy_factory.make_pos_condition(b0)},
+            {policy_factory.make_neg_effect(b0), policy_factory.make_inc_effect(n1), policy_factory.make_bot_effect(n0)}),
+        policy_factory.make_rule(
+            {policy_factory.make_neg_condition(b0), policy_factory.make_gt_condition(n1)},
+            {policy_factory.make_dec_effect(n1), policy_factory.make_inc_effect(n0), policy_factory.make_pos_effect(b0)}),
+        policy_factory.make_rule(
+            {policy_factory.make_eq_condition(n0), policy_factory.make_gt_condition(c0)},
+            {policy_factory.make_dec_bot_effect(n1), policy_factory.make_inc_bot_effect(n0), policy_factory.make_bot_effect(b1), policy_factory.make_gt_effect(n1)}),
+        policy_factory.make_rule(
+            {policy_factory.make_eq_condition(c0), policy_factory.make_neg_condition(b1)},
+            {policy_factory.make_inc_effect(c0), policy_factory.make_eq_effect(n1)}),
+        policy_factory.make_rule(
+            {},
+            {policy_factory.make_bot_effect(c0), policy_factory.make_dec_effect(c0), policy_factory.make_gt_effect(c0), policy_factory.make_eq_effect(c0), policy_factory.make_eq_effect(n0)})});
+
+    // at(p,A)=0,2,4 at(p,B)=1,3,5 at_roboter(A)=6 at_roboter(B)=7 holding(p)=8,9,10
+    States states;
+    for (const auto& atom_indices : std::vector<AtomIndices>{
+        {0, 2, 4, 6}, {8, 2, 4, 6}, {8, 2, 4, 7}, {1, 2, 4, 7}, {1, 2, 4, 6}, {1, 9, 4, 6}, {1, 3, 5, 7}}) {
+        states.emplace_back(states.size(), instance_info, atom_indices);
+    }
+
+    PolicyEvaluationFrames frames(policy->compile_evaluation_plan());
+    for (const auto& source_state : states) {
+        for (const auto& target_state : states) {
+            EXPECT_EQ(policy->evaluate(source_state, target_state, frames), policy->evaluate(source_state, target_state));
+            EXPECT_EQ(policy->evaluate_conditions(source_state, frames), policy->evaluate_conditions(source_state));
+            EXPECT_EQ(policy->evaluate_effects(source_state, target_state, policy->evaluate_conditions(source_state, frames), frames),
+                policy->evaluate_effects(source_state, target_state, policy->evaluate_conditions(source_state)));
+            // every rule alone, which the frames resolve to its compiled conditions and effects
+            for (const auto& rule : policy->get_rules()) {
+                EXPECT_EQ(policy->evaluate_effects(source_state, target_state, {rule}, frames) != nullptr, rule->evaluate_effects(source_state, target_state)) << rule->str();
+            }
+        }
+    }
+
+    auto other_policy = policy_factory.make_policy({policy_factory.make_rule({policy_factory.make_pos_condition(b0)}, {policy_factory.make_neg_effect(b0)})});
+    EXPECT_THROW(other_policy->evaluate(states[0], states[1], frames), std::runtime_error);
+    EXPECT_THROW(policy->evaluate_effects(states[0], states[1], {*other_policy->get_rules().begin()}, frames), std::runtime_error);
+}
+
+}